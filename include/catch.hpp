@@ -38,7 +38,9 @@
 #include "internal/catch_interfaces_exception.h"
 #include "internal/catch_approx.hpp"
 #include "internal/catch_matchers.hpp"
-namespace Catch { extern random_t random; } // prapin
+#include "internal/catch_benchmark.hpp"
+#include "internal/catch_benchmark_threads.hpp"
+namespace Catch { extern thread_local random_t random; } // prapin
 #include "internal/catch_compiler_capabilities.h"
 #include "internal/catch_interfaces_tag_alias_registry.h"
 #include "internal/catch_expecting_throws.hpp" // prapin
@@ -122,6 +124,15 @@ namespace Catch { extern random_t random; } // prapin
 
 #define CATCH_GENERATE( expr) INTERNAL_CATCH_GENERATE( expr )
 
+#define CATCH_BENCHMARK( name ) INTERNAL_CATCH_BENCHMARK( name )
+#ifdef CATCH_CONFIG_VARIADIC_MACROS
+    #define CATCH_BENCHMARK_COMPARE( ... ) INTERNAL_CATCH_BENCHMARK_COMPARE( __VA_ARGS__ )
+    #define CATCH_BENCHMARK_THREADS( name, ... ) INTERNAL_CATCH_BENCHMARK_THREADS( name, __VA_ARGS__ )
+#endif
+#define CATCH_BENCHMARK_RANGE( name, variable, sizes ) INTERNAL_CATCH_BENCHMARK_RANGE( name, variable, sizes )
+#define CATCH_REQUIRE_COMPLEXITY( order ) INTERNAL_CATCH_COMPLEXITY( order, Catch::ResultDisposition::Normal, "CATCH_REQUIRE_COMPLEXITY" )
+#define CATCH_CHECK_COMPLEXITY( order ) INTERNAL_CATCH_COMPLEXITY( order, Catch::ResultDisposition::ContinueOnFailure, "CATCH_CHECK_COMPLEXITY" )
+
 // "BDD-style" convenience wrappers
 #ifdef CATCH_CONFIG_VARIADIC_MACROS
 #define CATCH_SCENARIO( ... ) CATCH_TEST_CASE( "Scenario: " __VA_ARGS__ )
@@ -191,6 +202,15 @@ namespace Catch { extern random_t random; } // prapin
 
 #define GENERATE( expr) INTERNAL_CATCH_GENERATE( expr )
 
+#define BENCHMARK( name ) INTERNAL_CATCH_BENCHMARK( name )
+#ifdef CATCH_CONFIG_VARIADIC_MACROS
+    #define BENCHMARK_COMPARE( ... ) INTERNAL_CATCH_BENCHMARK_COMPARE( __VA_ARGS__ )
+    #define BENCHMARK_THREADS( name, ... ) INTERNAL_CATCH_BENCHMARK_THREADS( name, __VA_ARGS__ )
+#endif
+#define BENCHMARK_RANGE( name, variable, sizes ) INTERNAL_CATCH_BENCHMARK_RANGE( name, variable, sizes )
+#define REQUIRE_COMPLEXITY( order ) INTERNAL_CATCH_COMPLEXITY( order, Catch::ResultDisposition::Normal, "REQUIRE_COMPLEXITY" )
+#define CHECK_COMPLEXITY( order ) INTERNAL_CATCH_COMPLEXITY( order, Catch::ResultDisposition::ContinueOnFailure, "CHECK_COMPLEXITY" )
+
 #endif
 
 #define CATCH_TRANSLATE_EXCEPTION( signature ) INTERNAL_CATCH_TRANSLATE_EXCEPTION( signature )
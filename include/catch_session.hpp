@@ -11,6 +11,16 @@
 #include "internal/catch_commandline.hpp"
 #include "internal/catch_list.hpp"
 #include "internal/catch_run_context.hpp"
+#include "internal/catch_worker_pool.hpp"
+#include "internal/catch_test_thread_pool.hpp"
+#include "internal/catch_run_history_recorder.hpp"
+#include "internal/catch_benchmark_baseline_recorder.hpp"
+#include "internal/catch_repeat_statistics.hpp"
+#include "internal/catch_test_server.hpp"
+#include "internal/catch_test_retrier.hpp"
+#include "internal/catch_test_result_cache.hpp"
+#include "internal/catch_time_budget.hpp"
+#include "internal/catch_cpu_pinning.hpp"
 #include "internal/catch_test_spec.hpp"
 #include "internal/catch_version.h"
 #include "internal/catch_text.h"
@@ -18,6 +28,8 @@
 #include <fstream>
 #include <stdlib.h>
 #include <limits>
+#include <algorithm>
+#include <chrono>
 #include "LastGitCommit.h"
 #include "Utility/UnitTestDatabase.h"
 #include "Debug/DebugManagerCatch.h"
@@ -56,15 +68,53 @@ namespace Catch {
     }
 
 
+    // Other output mixed in with that of these reporters would spoil it
+    bool isMachineReadable( Config const& config ) {
+        std::vector<std::string> reporters = config.getReporterNames();
+        for( std::vector<std::string>::const_iterator it = reporters.begin(), itEnd = reporters.end(); it != itEnd; ++it )
+            if( *it != "console" && *it != "compact" )
+                return true;
+        return false;
+    }
+
     Totals runTests( Ptr<Config> const& config ) {
 
         Ptr<IConfig const> iconfig = config.get();
 
         Ptr<IStreamingReporter> reporter = makeReporter( config );
         reporter = addListeners( iconfig, reporter );
+        if( !config->historyFilename().empty() )
+            reporter = addReporter( reporter, new RunHistoryRecorder( config->history() ) );
+        BenchmarkBaseline benchmarkResults( GIT_LAST_COMMIT_ABBRHASH );
+        if( !config->benchmarkBaselineFilename().empty() )
+            reporter = addReporter( reporter, new BenchmarkBaselineRecorder( benchmarkResults ) );
+        bool const repeating = config->repeat() > 0 || config->untilFail();
+        Ptr<RepeatStatistics> repeatStatistics;
+        if( repeating ) {
+            repeatStatistics = new RepeatStatistics();
+            reporter = addReporter( reporter, repeatStatistics.get() );
+        }
+
+        std::unique_ptr<ImpactRecorder> impactRecorder;
+        if( config->recordImpact() )
+            impactRecorder.reset( new ImpactRecorder( config->impactMap() ) );
+
+        // Before anything is forked, so each forked process is pinned in turn
+        std::unique_ptr<CpuPinning> pinning;
+        if( config->pin() )
+            pinning.reset( new CpuPinning( config->cpus() ) );
 
         RunContext context( iconfig, reporter );
 
+        RunJournal journal;
+        if( !config->journalFilename().empty() ) {
+            if( !journal.open( config->journalFilename(), config->resumeJournal() ) )
+                throw std::domain_error( "Unable to write run journal to: " + config->journalFilename() );
+            context.useJournal( journal );
+        }
+        if( impactRecorder )
+            context.useImpactRecorder( *impactRecorder );
+
         Totals totals;
 
         context.testGroupStarting( config->name(), 1, 1 );
@@ -73,22 +123,194 @@ namespace Catch {
         if( !testSpec.hasFilters() )
             testSpec = TestSpecParser( ITagAliasRegistry::get() ).parse( "~[.]" ).testSpec(); // All not hidden tests
 
-        std::vector<TestCase> const& allTestCases = getAllTestCasesSorted( *iconfig );
+        // A copy, as a session run from one of the tests may sort them again
+        std::vector<TestCase> allTestCases = getAllTestCasesSorted( *iconfig );
+        std::vector<TestCase> matchedTestCases = filterTests( allTestCases, testSpec, *iconfig );
+
+        TestResultCache cache;
+        bool const caching = !config->cacheFilename().empty();
+        if( caching )
+            cache.open( config->cacheFilename(), config->getProcessName() );
+
+        // Those completed by the run being resumed, or whose pass is cached,
+        // are not run again (unless they are to be repeated). Nor is one that
+        // brought the run being resumed down, which is reported as crashed
+        std::vector<Option<Totals> > knownTotals( matchedTestCases.size() );
+        std::vector<bool> crashed( matchedTestCases.size(), false );
+        for( std::size_t i = 0; i < matchedTestCases.size(); ++i ) {
+            if( config->resumeJournal() ) {
+                knownTotals[i] = journal.completed( matchedTestCases[i].name );
+                if( journal.crashed( matchedTestCases[i].name ) ) {
+                    crashed[i] = true;
+                    knownTotals[i] = Totals(); // So it is not run
+                }
+            }
+            if( !knownTotals[i] && caching && !config->noCache() && !repeating )
+                knownTotals[i] = cache.cachedPass( matchedTestCases[i] );
+        }
+
+        // Within a time budget, the tests are run in the order they are worth
+        // running in, up to the budget, and the others are deferred
+        std::unique_ptr<TimeBudget> timeBudget;
+        if( config->timeBudget() > 0 ) {
+            timeBudget.reset( new TimeBudget( config->history(), config->timeBudget(), static_cast<std::size_t>( (std::max)( config->workers(), 1 ) ) ) );
+            timeBudget->plan( allTestCases, matchedTestCases, knownTotals );
+        }
+
+        std::vector<TestCase> testCasesToRun;
+        for( std::size_t i = 0; i < matchedTestCases.size(); ++i )
+            if( !knownTotals[i] && ( !timeBudget || timeBudget->isPlanned( i ) ) )
+                testCasesToRun.push_back( matchedTestCases[i] );
+
+        // Each repetition of a test case has its own seed, derived from the
+        // configured one (or from the time, once for the whole run). Failed
+        // tests are retried with the seed they failed with, so it must be known
+        std::size_t const repetitions = config->repeat() > 0 ? static_cast<std::size_t>( config->repeat() ) : repeating ? (std::numeric_limits<std::size_t>::max)() : 1;
+        std::unique_ptr<TestRetrier> retrier;
+        if( config->retryFailed() > 0 )
+            retrier.reset( new TestRetrier( iconfig, reporter->getPreferences(), static_cast<std::size_t>( config->retryFailed() ) ) );
+        bool const seeding = repeating || retrier;
+        unsigned int baseSeed = config->rngSeed();
+        if( seeding && baseSeed == 0 ) {
+            uint64_t t = static_cast<uint64_t>( std::chrono::high_resolution_clock::now().time_since_epoch().count() );
+            baseSeed = static_cast<unsigned int>( t ^ ( t >> 32 ) ) | 1;
+        }
+        std::vector<unsigned int> rngSeeds;
+        if( seeding && ( !repeating || config->repeat() > 0 ) ) {
+            std::vector<TestCase> repeatedTestCases;
+            for( std::vector<TestCase>::const_iterator it = testCasesToRun.begin(), itEnd = testCasesToRun.end(); it != itEnd; ++it ) {
+                for( std::size_t repetition = 0; repetition < repetitions; ++repetition ) {
+                    repeatedTestCases.push_back( *it );
+                    rngSeeds.push_back( RepeatStatistics::repetitionSeed( baseSeed, repetition ) );
+                }
+            }
+            testCasesToRun.swap( repeatedTestCases );
+        }
+
+        // With workers (or isolation) the tests to run are farmed out up
+        // front, then reported here one by one in the same order as a serial run
+        std::unique_ptr<WorkerPool> workerPool;
+        if( config->workers() > 0 || config->isolateBatch() > 0 )
+            workerPool.reset( new WorkerPool( iconfig,
+                                              testCasesToRun,
+                                              rngSeeds,
+                                              static_cast<std::size_t>( (std::max)( config->workers(), 1 ) ),
+                                              static_cast<std::size_t>( config->isolateBatch() ),
+                                              reporter->getPreferences() ) );
+
+        // With threads, the [parallel] test cases are all started up front,
+        // and likewise reported here in their place. Nothing else is run in
+        // this process (or forked from it) until they have all been run
+        std::unique_ptr<TestThreadPool> threadPool;
+        if( config->threads() > 0 )
+            threadPool.reset( new TestThreadPool( iconfig,
+                                                  testCasesToRun,
+                                                  rngSeeds,
+                                                  static_cast<std::size_t>( config->threads() ),
+                                                  reporter->getPreferences() ) );
+        std::size_t matchedIndex = 0;
+        std::size_t runIndex = 0;
+
         for( std::vector<TestCase>::const_iterator it = allTestCases.begin(), itEnd = allTestCases.end();
                 it != itEnd;
                 ++it ) {
-            if( !context.aborting() && matchTest( *it, testSpec, *iconfig ) )
-                totals += context.runTest( *it );
-            else
+            // filterTests() (and the time budget) keeps the order, so the matches come up in turn
+            bool matched = matchedIndex < matchedTestCases.size() && matchedTestCases[matchedIndex] == *it;
+            if( matched )
+                matchedIndex++;
+            bool const threaded = threadPool && TestThreadPool::isParallel( *it );
+            // One of testCasesToRun, whose results must be skipped over in the pools if it is not run after all
+            bool const toRun = matched && !knownTotals[matchedIndex-1] && ( !timeBudget || timeBudget->isPlanned( matchedIndex-1 ) );
+            if( matched && timeBudget && !context.aborting() && !timeBudget->admit( *it, matchedIndex-1, !workerPool && !threaded ) )
+                matched = false;
+            if( matched && !context.aborting() ) {
+                Totals testCaseTotals;
+                if( crashed[matchedIndex-1] )
+                    testCaseTotals = context.replayTest( *it, "", "Test case crashed the run being resumed" );
+                else if( Option<Totals> const& known = knownTotals[matchedIndex-1] )
+                    testCaseTotals = context.countKnownTest( *it, *known );
+                else {
+                    std::size_t firstRun = runIndex;
+                    if( workerPool || threadPool )
+                        runIndex += repetitions;
+                    if( threadPool && !threaded )
+                        threadPool->finish();
+                    for( std::size_t repetition = 0; repetition < repetitions && !context.aborting(); ++repetition ) {
+                        Totals repetitionTotals;
+                        unsigned int seed = RepeatStatistics::repetitionSeed( baseSeed, repetition );
+                        if( seeding )
+                            context.useRngSeed( seed );
+                        if( repeatStatistics )
+                            repeatStatistics->repetitionStarting( seed );
+                        if( retrier ) {
+                            TestRetrier::Attempt attempt = workerPool
+                                ? retrier->fromWorker( *it, workerPool->takeResult( firstRun + repetition ) )
+                                : threaded
+                                    ? retrier->fromWorker( *it, threadPool->takeResult( firstRun + repetition ) )
+                                    : retrier->runForked( *it, seed );
+                            if( attempt.failed && threadPool )
+                                threadPool->finish(); // Retries are forked
+                            std::size_t retries = 0;
+                            RetryOutcome::Kind outcome = attempt.failed ? retrier->retry( *it, seed, attempt, retries ) : RetryOutcome::NotRetried;
+                            repetitionTotals = context.replayTest( *it, attempt.events, attempt.interruption, outcome, retries );
+                        }
+                        else if( workerPool ) {
+                            WorkerPool::Result result = workerPool->takeResult( firstRun + repetition );
+                            repetitionTotals = context.replayTest( *it, result.events, result.interruption );
+                        }
+                        else if( threaded ) {
+                            TestThreadPool::Result result = threadPool->takeResult( firstRun + repetition );
+                            repetitionTotals = context.replayTest( *it, result.events, result.interruption );
+                        }
+                        else
+                            repetitionTotals = context.runTest( *it );
+                        testCaseTotals += repetitionTotals;
+                        if( config->untilFail() && repetitionTotals.testCases.failed > 0 ) {
+                            if( workerPool )
+                                workerPool->cancel( firstRun + repetition + 1, firstRun + repetitions );
+                            if( threadPool )
+                                threadPool->cancel( firstRun + repetition + 1, firstRun + repetitions );
+                            break;
+                        }
+                    }
+                }
+                totals += testCaseTotals;
+                if( caching )
+                    cache.recordResult( *it, testCaseTotals );
+            }
+            else {
+                if( toRun && ( workerPool || threadPool ) )
+                    runIndex += repetitions;
                 reporter->skipTest( *it );
+            }
         }
+        if( workerPool )
+            workerPool->printLockWaits( isMachineReadable( *config ) ? Catch::cerr() : config->stream() );
+        workerPool.reset();
+        threadPool.reset();
+
+        if( repeatStatistics )
+            repeatStatistics->print( isMachineReadable( *config ) ? Catch::cerr() : config->stream() );
+        if( timeBudget )
+            timeBudget->print( isMachineReadable( *config ) ? Catch::cerr() : config->stream() );
 
         context.testGroupEnded( iconfig->name(), totals, 1, 1 );
+        if( !context.aborting() )
+            journal.endOfRun();
+
+        if( !config->historyFilename().empty() && !config->history().save( config->historyFilename() ) )
+            Catch::cerr() << "Unable to write run history to: " << config->historyFilename() << std::endl;
+        if( !config->benchmarkBaselineFilename().empty() && !benchmarkResults.save( config->benchmarkBaselineFilename() ) )
+            Catch::cerr() << "Unable to write benchmark baseline to: " << config->benchmarkBaselineFilename() << std::endl;
+        if( caching && !cache.save( config->cacheFilename() ) )
+            Catch::cerr() << "Unable to write test result cache to: " << config->cacheFilename() << std::endl;
+        if( impactRecorder && !config->impactMap().save( config->impactMapFilename() ) )
+            Catch::cerr() << "Unable to write impact map to: " << config->impactMapFilename() << std::endl;
         return totals;
     }
 
-    void applyFilenamesAsTags( IConfig const& config ) {
-        std::vector<TestCase> const& tests = getAllTestCasesSorted( config );
+    void applyFilenamesAsTags( IConfig const& ) {
+        std::vector<TestCase> const& tests = getRegistryHub().getTestCaseRegistry().getAllTests();
         for(std::size_t i = 0; i < tests.size(); ++i ) {
             TestCase& test = const_cast<TestCase&>( tests[i] );
             std::set<std::string> tags = test.tags;
@@ -107,8 +329,12 @@ namespace Catch {
         }
     }
 
-    class Session : NonCopyable {
-        static bool alreadyInstantiated;
+    // Any number of sessions can be run, one after the other or from within a
+    // test case of another session, each as many times as wanted. The test
+    // case registry lives as long as the process, as static registrations
+    // cannot be redone, but the run time context goes with the last session
+    class Session : NonCopyable, ITestRequestRunner {
+        static std::size_t liveSessions;
 
     public:
 
@@ -118,18 +344,15 @@ namespace Catch {
         : m_cli( makeCommandLineParser() ),
         debug((new(AUTORELEASE)DebugManagerCatch)->setLevel(DebugSeverity::info)->setFormat("%m"_S))
         {
-            if( alreadyInstantiated ) {
-                std::string msg = "Only one instance of Catch::Session can ever be used";
-                Catch::cerr() << msg << std::endl;
-                throw std::logic_error( msg );
-            }
-            alreadyInstantiated = true;
-            BaseObject::recentObjects = new std::unordered_set<BaseObject*>;
+            if( liveSessions++ == 0 )
+                BaseObject::recentObjects = new std::unordered_set<BaseObject*>;
         }
         ~Session() {
-            Catch::cleanUp();
-            delete BaseObject::recentObjects;
-            BaseObject::recentObjects = NULL;
+            if( --liveSessions == 0 ) {
+                cleanUpContext();
+                delete BaseObject::recentObjects;
+                BaseObject::recentObjects = NULL;
+            }
         }
 
         void showHelp( std::string const& processName ) {
@@ -140,9 +363,13 @@ namespace Catch {
         }
 
         int applyCommandLine( int argc, char const* const* const argv, OnUnusedOptions::DoWhat unusedOptionBehaviour = OnUnusedOptions::Fail ) {
+            return applyCommandLine( Clara::argsToVector( argc, argv ), unusedOptionBehaviour );
+        }
+        int applyCommandLine( std::vector<std::string> const& args, OnUnusedOptions::DoWhat unusedOptionBehaviour = OnUnusedOptions::Fail ) {
+            m_args = args;
             try {
                 m_cli.setThrowOnUnrecognisedTokens( unusedOptionBehaviour == OnUnusedOptions::Fail );
-                m_unusedTokens = m_cli.parseInto( Clara::argsToVector( argc, argv ), m_configData );
+                m_unusedTokens = m_cli.parseInto( args, m_configData );
                 if( m_configData.showHelp )
                     showHelp( m_configData.processName );
                 m_config.reset();
@@ -182,22 +409,20 @@ namespace Catch {
             {
                 config(); // Force config to be constructed
 
-                static const PSTRING version = "GITGLOBALID=" GIT_LAST_COMMIT_ABBRHASH;
+                // A client leaves everything, set up included, to the server
+                if( !m_configData.connectSocket.empty() )
+                    return runOnTestServer( m_configData.connectSocket, argsForServer() );
+
                 BaseAutorelease;
-                printf("Git ID: %s\n", version+12);
+                printGitId();
                 if(!m_configData.debugLevel.empty())
                     (new(AUTORELEASE)DebugManagerStdout)->setFilter(STR(m_configData.debugLevel.c_str(), -1));
-                gUnitTestDatabase.New(m_configData.md5DatabaseName.c_str(), m_configData.processName.c_str());
-                seedRng( *m_config ); // needed or not ??
-
-                if( m_configData.filenamesAsTags )
-                    applyFilenamesAsTags( *m_config );
+                openUnitTestDatabase();
 
-                // Handle list request
-                if( Option<std::size_t> listed = list( config() ) )
-                    return static_cast<int>( *listed );
+                if( !m_configData.serveSocket.empty() )
+                    return TestServer( m_configData.serveSocket ).serve( *this );
 
-                return static_cast<int>( runTests( m_config ).assertions.failed );
+                return runConfigured();
             }
             catch( std::exception& ex ) {
                 Catch::cerr() << ex.what() << std::endl;
@@ -205,6 +430,24 @@ namespace Catch {
             }
         }
 
+        // Runs in a process forked by the test server, which has already been
+        // set up (so options such as --md5 or --debug are the server's)
+        virtual int runRequest( std::vector<std::string> const& args ) CATCH_OVERRIDE {
+            std::vector<std::string> commandLine( 1, m_configData.processName );
+            commandLine.insert( commandLine.end(), args.begin(), args.end() );
+            m_configData = ConfigData();
+            int returnCode = applyCommandLine( commandLine );
+            if( returnCode != 0 || m_configData.showHelp )
+                return returnCode;
+            m_configData.serveSocket.clear();
+            m_configData.connectSocket.clear();
+            m_config.reset();
+            config();
+
+            printGitId();
+            return runConfigured();
+        }
+
         Clara::CommandLine<ConfigData> const& cli() const {
             return m_cli;
         }
@@ -220,14 +463,56 @@ namespace Catch {
             return *m_config;
         }
     private:
+        static void printGitId() {
+            static const PSTRING version = "GITGLOBALID=" GIT_LAST_COMMIT_ABBRHASH;
+            Catch::cout() << "Git ID: " << version+12 << std::endl;
+        }
+
+        // Only reopened when a later run names another database
+        void openUnitTestDatabase() {
+            static bool opened = false;
+            static std::string openedName;
+            if( opened && openedName == m_configData.md5DatabaseName )
+                return;
+            gUnitTestDatabase.New(m_configData.md5DatabaseName.c_str(), m_configData.processName.c_str());
+            opened = true;
+            openedName = m_configData.md5DatabaseName;
+        }
+
+        int runConfigured() {
+            seedRng( *m_config ); // needed or not ??
+
+            if( m_configData.filenamesAsTags )
+                applyFilenamesAsTags( *m_config );
+
+            // Handle list request
+            if( Option<std::size_t> listed = list( config() ) )
+                return static_cast<int>( *listed );
+
+            return static_cast<int>( runTests( m_config ).assertions.failed );
+        }
+
+        // The arguments this process was given, less the program name and --connect
+        std::vector<std::string> argsForServer() const {
+            std::vector<std::string> args;
+            for( std::size_t i = 1; i < m_args.size(); ++i ) {
+                if( m_args[i] == "--connect" )
+                    ++i;
+                else if( !startsWith( m_args[i], "--connect=" ) && !startsWith( m_args[i], "--connect:" ) )
+                    args.push_back( m_args[i] );
+            }
+            return args;
+        }
+
         Clara::CommandLine<ConfigData> m_cli;
+        std::vector<std::string> m_args;
         std::vector<Clara::Parser::Token> m_unusedTokens;
         ConfigData m_configData;
         Ptr<Config> m_config;
         SP<DebugManager> debug;
     };
 
-    bool Session::alreadyInstantiated = false;
+    std::size_t Session::liveSessions = 0;
 } // end namespace Catch
 
 
@@ -237,16 +522,17 @@ void CatchAssertion(bool condition, PSTRING file, int line, PSTRING cond_text)
 {
     if(condition)
         return;
-    if(Catch::ExpectingThrows::counter == 0 && Catch::getCurrentContext().getConfig()->shouldDebugBreak())
+    Catch::Ptr<Catch::IConfig const> config = Catch::getCurrentContext().getConfig(); // None outside a run
+    if(Catch::ExpectingThrows::counter == 0 && config && config->shouldDebugBreak())
         CATCH_BREAK_INTO_DEBUGGER();
     sprintf(errorBuffer, "Assertion failed at %s:%d (%s)", file, line, cond_text);
     throw errorBuffer;
 }
 namespace Catch {
-    int ExpectingThrows::counter;
-    U32 ExpectsDebugsError::capturingMask;
-    U16 ExpectsDebugsError::counters[DebugSeveritiesCount];
-    random_t random;
+    ExpectationCount<int> ExpectingThrows::counter;
+    ExpectationCount<U32> ExpectsDebugsError::capturingMask;
+    ExpectationCount<U16> ExpectsDebugsError::counters[DebugSeveritiesCount];
+    thread_local random_t random; // Seeded for each test case, on the thread it runs on
 }
 
 #endif // TWOBLUECUBES_CATCH_RUNNER_HPP_INCLUDED
@@ -0,0 +1,323 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_BENCHMARK_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_BENCHMARK_HPP_INCLUDED
+
+#include "catch_benchmark_stats.h"
+#include "catch_benchmark_analysis.hpp"
+#include "catch_interfaces_capture.h"
+#include "catch_capture.hpp"
+#include "catch_generators.hpp"
+#include "catch_interfaces_config.h"
+#include "catch_context.h"
+#include "catch_timer.h"
+#include "catch_common.h"
+
+#include <string>
+#include <algorithm>
+#include <random>
+#include <memory>
+#include <sstream>
+
+namespace Catch {
+namespace Benchmark {
+
+    // Stops the compiler from optimising away the computation of a value
+    // the benchmark would otherwise not use
+    template<typename T>
+    inline void keepAlive( T const& value ) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile( "" : : "g"( &value ) : "memory" );
+#else
+        static volatile void const* volatile sink;
+        sink = &value;
+#endif
+    }
+
+    // What the clock can resolve and what it costs to read it, in
+    // nanoseconds. Measured once, the first time a benchmark is run
+    struct ClockEnvironment {
+        double resolution;
+        double overhead;
+
+        static ClockEnvironment const& get() {
+            static ClockEnvironment const environment = measure();
+            return environment;
+        }
+
+        // So that neither the clock's steps nor reading it weigh much in a sample
+        uint64_t minimumBatchTime() const {
+            return static_cast<uint64_t>( std::max( resolution, overhead ) * 1000 );
+        }
+
+    private:
+        static ClockEnvironment measure() {
+            static const int steps = 100;
+            static const int reads = 10000;
+            ClockEnvironment environment;
+
+            Timer timer;
+            timer.start();
+            uint64_t last = timer.getElapsedNanoseconds();
+            uint64_t first = last;
+            for( int i = 0; i < steps; ++i ) {
+                uint64_t now;
+                while( ( now = timer.getElapsedNanoseconds() ) == last ) {}
+                last = now;
+            }
+            environment.resolution = static_cast<double>( last - first ) / steps;
+
+            uint64_t sum = 0;
+            timer.start();
+            for( int i = 0; i < reads; ++i )
+                sum += timer.getElapsedNanoseconds();
+            keepAlive( sum );
+            environment.overhead = static_cast<double>( timer.getElapsedNanoseconds() ) / reads;
+            return environment;
+        }
+    };
+
+    // Drives the loop a BENCHMARK expands to. The body is run in batches,
+    // timing each batch as a whole: first while warming up, doubling the
+    // batch until it takes long enough for the clock to time it accurately
+    // and the warm-up time has passed, then once per sample with that many
+    // iterations. The samples are analysed and reported once all are taken
+    class BenchmarkLooper : NonCopyable {
+    public:
+        BenchmarkLooper( std::string const& name, SourceLineInfo const& lineInfo )
+        :   m_stats( name, lineInfo ),
+            m_config( getCurrentContext().getConfig() ),
+            m_warmingUp( true ),
+            m_iterations( 1 ),
+            m_iterationsDone( 0 )
+        {
+            ClockEnvironment const& environment = ClockEnvironment::get();
+            m_stats.clockResolution = environment.resolution;
+            m_stats.clockOverhead = environment.overhead;
+            m_minimumBatchTime = environment.minimumBatchTime();
+            m_stats.samples.reserve( static_cast<std::size_t>( m_config->benchmarkSamples() ) );
+            m_warmupTimer.start();
+            m_batchTimer.start();
+        }
+
+        bool running() {
+            if( m_iterationsDone < m_iterations )
+                return true;
+            uint64_t elapsed = m_batchTimer.getElapsedNanoseconds();
+            if( m_warmingUp ) {
+                if( elapsed < m_minimumBatchTime )
+                    m_iterations *= 2;
+                else if( m_warmupTimer.getElapsedMilliseconds() >= static_cast<unsigned int>( m_config->benchmarkWarmupTime() ) )
+                    m_warmingUp = false;
+            }
+            else {
+                double sample = ( static_cast<double>( elapsed ) - m_stats.clockOverhead ) / static_cast<double>( m_iterations );
+                m_stats.samples.push_back( std::max( sample, 0.0 ) );
+                if( m_stats.samples.size() >= static_cast<std::size_t>( m_config->benchmarkSamples() ) ) {
+                    m_stats.iterations = m_iterations;
+                    analyse( m_stats,
+                             static_cast<std::size_t>( m_config->benchmarkResamples() ),
+                             m_config->benchmarkConfidenceInterval() );
+                    getResultCapture().benchmarkEnded( m_stats );
+                    return false;
+                }
+            }
+            m_iterationsDone = 0;
+            m_batchTimer.start();
+            return true;
+        }
+
+        void increment() {
+            ++m_iterationsDone;
+        }
+
+        BenchmarkStats const& stats() const {
+            return m_stats;
+        }
+
+    private:
+        BenchmarkStats m_stats;
+        Ptr<IConfig const> m_config;
+        Timer m_warmupTimer;
+        Timer m_batchTimer;
+        uint64_t m_minimumBatchTime;
+        bool m_warmingUp;
+        std::size_t m_iterations; // Per batch
+        std::size_t m_iterationsDone;
+    };
+
+    // Drives the loops a BENCHMARK_RANGE expands to: a BENCHMARK's loop for
+    // each size of the range in turn, reported as a benchmark named after
+    // the size, then the fit of their median times to each order of growth.
+    // The inner loop only declares the size for the body
+    class RangeLooper : NonCopyable {
+    public:
+        template<typename T>
+        RangeLooper( std::string const& name, CompositeGenerator<T> const& sizes, SourceLineInfo const& lineInfo )
+        :   m_stats( name, lineInfo ),
+            m_index( 0 ),
+            m_once( false )
+        {
+            for( std::size_t i = 0; i < sizes.size(); ++i )
+                m_stats.sizes.push_back( static_cast<std::size_t>( sizes.getValue( i ) ) );
+            startSize();
+        }
+
+        bool running() {
+            if( !m_looper )
+                return false;
+            while( !m_looper->running() ) {
+                m_stats.medians.push_back( m_looper->stats().median );
+                ++m_index;
+                if( !startSize() ) {
+                    fitComplexity( m_stats );
+                    getResultCapture().benchmarkFitted( m_stats );
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void increment() {
+            m_looper->increment();
+        }
+
+        std::size_t size() const {
+            return m_stats.sizes[m_index];
+        }
+        bool once() {
+            return m_once = !m_once;
+        }
+
+    private:
+        bool startSize() {
+            if( m_index >= m_stats.sizes.size() ) {
+                m_looper.reset();
+                return false;
+            }
+            std::ostringstream oss;
+            oss << m_stats.name << "/" << size();
+            m_looper.reset( new BenchmarkLooper( oss.str(), m_stats.lineInfo ) );
+            return true;
+        }
+
+        BenchmarkComplexityStats m_stats;
+        std::unique_ptr<BenchmarkLooper> m_looper; // Of the current size
+        std::size_t m_index;
+        bool m_once;
+    };
+
+    template<typename Fun>
+    uint64_t timeBatch( Fun& fun, std::size_t iterations ) {
+        Timer timer;
+        timer.start();
+        for( std::size_t i = 0; i < iterations; ++i )
+            fun();
+        return timer.getElapsedNanoseconds();
+    }
+
+    // The number of iterations per batch, found as a BENCHMARK's loop does
+    template<typename Fun>
+    std::size_t warmUp( Fun& fun, uint64_t minimumBatchTime, unsigned int warmupTime ) {
+        Timer warmupTimer;
+        warmupTimer.start();
+        std::size_t iterations = 1;
+        for(;;) {
+            if( timeBatch( fun, iterations ) < minimumBatchTime )
+                iterations *= 2;
+            else if( warmupTimer.getElapsedMilliseconds() >= warmupTime )
+                return iterations;
+        }
+    }
+
+    template<typename Fun>
+    void takeSample( BenchmarkStats& stats, Fun& fun ) {
+        double sample = ( static_cast<double>( timeBatch( fun, stats.iterations ) ) - stats.clockOverhead ) / static_cast<double>( stats.iterations );
+        stats.samples.push_back( std::max( sample, 0.0 ) );
+    }
+
+    // What BENCHMARK_COMPARE expands to. Both variants are warmed up, then
+    // sampled in turn, which of them goes first being drawn at random for
+    // each pair of samples, so that whatever the machine is doing in the
+    // meantime weighs the same on both. Each is reported as a benchmark,
+    // then the comparison, which is returned for the test to check
+    template<typename OldFun, typename NewFun>
+    BenchmarkComparisonStats compare( SourceLineInfo const& lineInfo,
+                                      std::string const& oldName, OldFun oldFun,
+                                      std::string const& newName, NewFun newFun ) {
+        Ptr<IConfig const> config = getCurrentContext().getConfig();
+        ClockEnvironment const& environment = ClockEnvironment::get();
+        std::size_t samples = static_cast<std::size_t>( config->benchmarkSamples() );
+        std::size_t resamples = static_cast<std::size_t>( config->benchmarkResamples() );
+        unsigned int warmupTime = static_cast<unsigned int>( config->benchmarkWarmupTime() );
+
+        BenchmarkStats oldStats( oldName, lineInfo ), newStats( newName, lineInfo );
+        oldStats.clockResolution = newStats.clockResolution = environment.resolution;
+        oldStats.clockOverhead = newStats.clockOverhead = environment.overhead;
+        oldStats.iterations = warmUp( oldFun, environment.minimumBatchTime(), warmupTime );
+        newStats.iterations = warmUp( newFun, environment.minimumBatchTime(), warmupTime );
+        oldStats.samples.reserve( samples );
+        newStats.samples.reserve( samples );
+
+        std::mt19937 rng( rngSeed() );
+        std::bernoulli_distribution oldFirst;
+        for( std::size_t i = 0; i < samples; ++i ) {
+            if( oldFirst( rng ) ) {
+                takeSample( oldStats, oldFun );
+                takeSample( newStats, newFun );
+            }
+            else {
+                takeSample( newStats, newFun );
+                takeSample( oldStats, oldFun );
+            }
+        }
+
+        analyse( oldStats, resamples, config->benchmarkConfidenceInterval() );
+        analyse( newStats, resamples, config->benchmarkConfidenceInterval() );
+        getResultCapture().benchmarkEnded( oldStats );
+        getResultCapture().benchmarkEnded( newStats );
+
+        BenchmarkComparisonStats comparison( oldName, newName, lineInfo );
+        compareVariants( comparison, oldStats, newStats, resamples, config->benchmarkConfidenceInterval() );
+        getResultCapture().benchmarkCompared( comparison );
+        return comparison;
+    }
+
+} // end namespace Benchmark
+} // end namespace Catch
+
+#define INTERNAL_CATCH_BENCHMARK2( looper, name ) \
+    for( Catch::Benchmark::BenchmarkLooper looper( name, CATCH_INTERNAL_LINEINFO ); looper.running(); looper.increment() )
+#define INTERNAL_CATCH_BENCHMARK( name ) \
+    INTERNAL_CATCH_BENCHMARK2( INTERNAL_CATCH_UNIQUE_NAME( catch_internal_Benchmark ), name )
+// Variadic, as the commas within the lambdas' braces would otherwise split the arguments
+#define INTERNAL_CATCH_BENCHMARK_COMPARE( ... ) \
+    Catch::Benchmark::compare( CATCH_INTERNAL_LINEINFO, __VA_ARGS__ )
+
+#define INTERNAL_CATCH_BENCHMARK_RANGE2( looper, name, variable, sizes ) \
+    for( Catch::Benchmark::RangeLooper looper( name, sizes, CATCH_INTERNAL_LINEINFO ); looper.running(); looper.increment() ) \
+        for( std::size_t const variable = looper.size(); looper.once(); )
+#define INTERNAL_CATCH_BENCHMARK_RANGE( name, variable, sizes ) \
+    INTERNAL_CATCH_BENCHMARK_RANGE2( INTERNAL_CATCH_UNIQUE_NAME( catch_internal_Benchmark ), name, variable, sizes )
+
+// Passes if the best fit of the last BENCHMARK_RANGE grows no faster than the complexity
+#define INTERNAL_CATCH_COMPLEXITY( complexity, resultDisposition, macroName ) \
+    do { \
+        Catch::ResultBuilder __catchResult( macroName, CATCH_INTERNAL_LINEINFO, #complexity, resultDisposition ); \
+        try { \
+            Catch::BenchmarkComplexityStats const* fitted = Catch::getResultCapture().getLastComplexity(); \
+            __catchResult \
+                .setLhs( fitted ? Catch::complexityName( fitted->best.order ) : "no BENCHMARK_RANGE" ) \
+                .setRhs( Catch::complexityName( Catch::Complexity::complexity ) ) \
+                .setOp( "is at most" ) \
+                .setResultType( fitted && fitted->best.order <= Catch::Complexity::complexity ); \
+            __catchResult.captureExpression(); \
+        } catch( ... ) { \
+            __catchResult.useActiveException( resultDisposition | Catch::ResultDisposition::ContinueOnFailure ); \
+        } \
+        INTERNAL_CATCH_REACT( __catchResult ) \
+    } while( Catch::alwaysFalse() )
+
+#endif // TWOBLUECUBES_CATCH_BENCHMARK_HPP_INCLUDED
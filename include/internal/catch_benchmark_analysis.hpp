@@ -0,0 +1,305 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_BENCHMARK_ANALYSIS_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_BENCHMARK_ANALYSIS_HPP_INCLUDED
+
+#include "catch_benchmark_stats.h"
+
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <utility>
+
+namespace Catch {
+namespace Benchmark {
+
+    inline double mean( std::vector<double> const& values ) {
+        if( values.empty() )
+            return 0;
+        double sum = 0;
+        for( std::vector<double>::const_iterator it = values.begin(), itEnd = values.end(); it != itEnd; ++it )
+            sum += *it;
+        return sum / static_cast<double>( values.size() );
+    }
+
+    // Interpolated between the two nearest of the sorted values
+    inline double quantileOfSorted( std::vector<double> const& sorted, double q ) {
+        if( sorted.empty() )
+            return 0;
+        double position = q * static_cast<double>( sorted.size() - 1 );
+        std::size_t below = static_cast<std::size_t>( position );
+        if( below + 1 >= sorted.size() )
+            return sorted.back();
+        double fraction = position - static_cast<double>( below );
+        return sorted[below] + fraction * ( sorted[below+1] - sorted[below] );
+    }
+
+    inline double median( std::vector<double> values ) {
+        std::sort( values.begin(), values.end() );
+        return quantileOfSorted( values, 0.5 );
+    }
+
+    // Of a sample (so with Bessel's correction)
+    inline double standardDeviation( std::vector<double> const& values ) {
+        if( values.size() < 2 )
+            return 0;
+        double m = mean( values );
+        double sum = 0;
+        for( std::vector<double>::const_iterator it = values.begin(), itEnd = values.end(); it != itEnd; ++it )
+            sum += ( *it - m ) * ( *it - m );
+        return std::sqrt( sum / static_cast<double>( values.size() - 1 ) );
+    }
+
+    typedef double (*Estimator)( std::vector<double> const& );
+
+    // The estimator applied to the samples, bounded by the percentiles of
+    // its values over as many resamplings (with replacement) of them
+    inline BenchmarkEstimate bootstrap( std::vector<double> const& samples, Estimator estimator, std::size_t resamples, double confidenceInterval, std::mt19937& rng ) {
+        BenchmarkEstimate estimate;
+        estimate.point = estimator( samples );
+        estimate.lowerBound = estimate.upperBound = estimate.point;
+        estimate.confidenceInterval = confidenceInterval;
+        if( samples.size() < 2 || resamples == 0 )
+            return estimate;
+
+        std::uniform_int_distribution<std::size_t> pick( 0, samples.size() - 1 );
+        std::vector<double> resample( samples.size() );
+        std::vector<double> estimates;
+        estimates.reserve( resamples );
+        for( std::size_t i = 0; i < resamples; ++i ) {
+            for( std::size_t j = 0; j < resample.size(); ++j )
+                resample[j] = samples[pick( rng )];
+            estimates.push_back( estimator( resample ) );
+        }
+        std::sort( estimates.begin(), estimates.end() );
+        estimate.lowerBound = quantileOfSorted( estimates, ( 1 - confidenceInterval ) / 2 );
+        estimate.upperBound = quantileOfSorted( estimates, ( 1 + confidenceInterval ) / 2 );
+        return estimate;
+    }
+
+    inline BenchmarkOutliers classifyOutliers( std::vector<double> samples ) {
+        BenchmarkOutliers outliers;
+        outliers.samplesSeen = samples.size();
+        std::sort( samples.begin(), samples.end() );
+        double q1 = quantileOfSorted( samples, 0.25 );
+        double q3 = quantileOfSorted( samples, 0.75 );
+        double iqr = q3 - q1;
+        for( std::vector<double>::const_iterator it = samples.begin(), itEnd = samples.end(); it != itEnd; ++it ) {
+            if( *it < q1 - 3 * iqr )
+                ++outliers.lowSevere;
+            else if( *it < q1 - 1.5 * iqr )
+                ++outliers.lowMild;
+            else if( *it > q3 + 3 * iqr )
+                ++outliers.highSevere;
+            else if( *it > q3 + 1.5 * iqr )
+                ++outliers.highMild;
+        }
+        return outliers;
+    }
+
+    // The Mann-Whitney U (Wilcoxon rank-sum) test of whether the later samples
+    // tend to be greater than the earlier ones - that is, slower. Timings are
+    // rarely normal, so only their ranks are compared. Uses the normal
+    // approximation, corrected for ties, which holds from a dozen samples each
+    struct RankSumTest {
+        RankSumTest() : u( 0 ), z( 0 ), pGreater( 1 ) {}
+        double u; // Of the later samples
+        double z;
+        double pGreater; // One-sided: of seeing a U this large were neither slower
+    };
+
+    inline RankSumTest mannWhitney( std::vector<double> const& earlier, std::vector<double> const& later ) {
+        RankSumTest test;
+        double n1 = static_cast<double>( earlier.size() );
+        double n2 = static_cast<double>( later.size() );
+        if( earlier.empty() || later.empty() )
+            return test;
+
+        std::vector<std::pair<double, bool> > all; // Whether each is one of the later samples
+        all.reserve( earlier.size() + later.size() );
+        for( std::vector<double>::const_iterator it = earlier.begin(), itEnd = earlier.end(); it != itEnd; ++it )
+            all.push_back( std::make_pair( *it, false ) );
+        for( std::vector<double>::const_iterator it = later.begin(), itEnd = later.end(); it != itEnd; ++it )
+            all.push_back( std::make_pair( *it, true ) );
+        std::sort( all.begin(), all.end() );
+
+        double laterRanks = 0, tieTerm = 0;
+        for( std::size_t i = 0; i < all.size(); ) {
+            std::size_t j = i;
+            while( j < all.size() && all[j].first == all[i].first )
+                ++j;
+            double ties = static_cast<double>( j - i );
+            double rank = ( static_cast<double>( i + 1 ) + static_cast<double>( j ) ) / 2; // Ties share their mean rank
+            for( std::size_t k = i; k < j; ++k )
+                if( all[k].second )
+                    laterRanks += rank;
+            tieTerm += ties * ties * ties - ties;
+            i = j;
+        }
+
+        double n = n1 + n2;
+        test.u = laterRanks - n2 * ( n2 + 1 ) / 2;
+        double variance = n1 * n2 / 12 * ( ( n + 1 ) - tieTerm / ( n * ( n - 1 ) ) );
+        if( variance <= 0 )
+            return test; // All the samples are the same
+        double difference = test.u - n1 * n2 / 2;
+        difference -= difference > 0 ? 0.5 : difference < 0 ? -0.5 : 0; // Continuity correction
+        test.z = difference / std::sqrt( variance );
+        test.pGreater = 0.5 * std::erfc( test.z / std::sqrt( 2.0 ) );
+        return test;
+    }
+
+    // Fills in the statistics of the samples already in the stats. The
+    // resampling is seeded the same each time, so the same samples always
+    // give the same confidence intervals
+    inline void analyse( BenchmarkStats& stats, std::size_t resamples, double confidenceInterval ) {
+        std::mt19937 rng;
+        stats.resamples = resamples;
+        stats.mean = bootstrap( stats.samples, &mean, resamples, confidenceInterval, rng );
+        stats.median = median( stats.samples );
+        stats.standardDeviation = bootstrap( stats.samples, &standardDeviation, resamples, confidenceInterval, rng );
+        stats.outliers = classifyOutliers( stats.samples );
+    }
+
+    // The ratio of the means of the new variant's samples to the old one's,
+    // bounded by its percentiles over as many resamplings of both, and the
+    // Mann-Whitney U test of each being slower than the other
+    inline void compareVariants( BenchmarkComparisonStats& comparison, BenchmarkStats const& oldStats, BenchmarkStats const& newStats, std::size_t resamples, double confidenceInterval ) {
+        std::vector<double> const& oldSamples = oldStats.samples;
+        std::vector<double> const& newSamples = newStats.samples;
+        comparison.samples = std::min( oldSamples.size(), newSamples.size() );
+
+        double oldMean = mean( oldSamples );
+        comparison.ratio.point = oldMean > 0 ? mean( newSamples ) / oldMean : 0;
+        comparison.ratio.lowerBound = comparison.ratio.upperBound = comparison.ratio.point;
+        comparison.ratio.confidenceInterval = confidenceInterval;
+        if( oldSamples.size() >= 2 && newSamples.size() >= 2 && resamples > 0 ) {
+            std::mt19937 rng;
+            std::uniform_int_distribution<std::size_t> pickOld( 0, oldSamples.size() - 1 );
+            std::uniform_int_distribution<std::size_t> pickNew( 0, newSamples.size() - 1 );
+            std::vector<double> ratios;
+            ratios.reserve( resamples );
+            for( std::size_t i = 0; i < resamples; ++i ) {
+                double oldSum = 0, newSum = 0;
+                for( std::size_t j = 0; j < oldSamples.size(); ++j )
+                    oldSum += oldSamples[pickOld( rng )];
+                for( std::size_t j = 0; j < newSamples.size(); ++j )
+                    newSum += newSamples[pickNew( rng )];
+                if( oldSum > 0 )
+                    ratios.push_back( ( newSum / static_cast<double>( newSamples.size() ) ) / ( oldSum / static_cast<double>( oldSamples.size() ) ) );
+            }
+            if( !ratios.empty() ) {
+                std::sort( ratios.begin(), ratios.end() );
+                comparison.ratio.lowerBound = quantileOfSorted( ratios, ( 1 - confidenceInterval ) / 2 );
+                comparison.ratio.upperBound = quantileOfSorted( ratios, ( 1 + confidenceInterval ) / 2 );
+            }
+        }
+
+        RankSumTest slower = mannWhitney( oldSamples, newSamples );
+        comparison.z = slower.z;
+        comparison.pNewSlower = slower.pGreater;
+        comparison.pNewFaster = mannWhitney( newSamples, oldSamples ).pGreater;
+    }
+
+    inline double complexityFunction( Complexity::Order order, double n ) {
+        switch( order ) {
+            case Complexity::O_1: return 1;
+            case Complexity::O_LOG_N: return std::log2( n );
+            case Complexity::O_N: return n;
+            case Complexity::O_N_LOG_N: return n * std::log2( n );
+            case Complexity::O_N_SQUARED: return n * n;
+        }
+        return 1;
+    }
+
+    // How much less error a higher order must leave than the best lower one,
+    // relatively, to be the better fit. Noisy times of a linear block are as
+    // often a little closer to n log n than to n, but should not be taken for it
+    static const double complexityMargin = 0.25;
+
+    // Fits the median time of each size (which stray samples sway less than
+    // the mean) to each order in turn, as a multiple of its function of n.
+    // There is no constant term, so that the order alone has to account for
+    // how the times grow. A higher order is only the best fit if it fits
+    // clearly better than the lower ones, by complexityMargin
+    inline void fitComplexity( BenchmarkComplexityStats& stats ) {
+        double meanTime = mean( stats.medians );
+        std::size_t count = std::min( stats.sizes.size(), stats.medians.size() );
+        stats.fits.clear();
+        for( int order = Complexity::O_1; order <= Complexity::O_N_SQUARED; ++order ) {
+            ComplexityFit fit( static_cast<Complexity::Order>( order ) );
+            double timesF = 0, squaresOfF = 0;
+            for( std::size_t i = 0; i < count; ++i ) {
+                double f = complexityFunction( fit.order, static_cast<double>( stats.sizes[i] ) );
+                timesF += stats.medians[i] * f;
+                squaresOfF += f * f;
+            }
+            fit.coefficient = squaresOfF > 0 ? timesF / squaresOfF : 0;
+            double squaresOfResiduals = 0;
+            for( std::size_t i = 0; i < count; ++i ) {
+                double residual = stats.medians[i] - fit.coefficient * complexityFunction( fit.order, static_cast<double>( stats.sizes[i] ) );
+                squaresOfResiduals += residual * residual;
+            }
+            fit.rms = count > 0 && meanTime > 0 ? std::sqrt( squaresOfResiduals / static_cast<double>( count ) ) / meanTime : 0;
+            stats.fits.push_back( fit );
+            if( fit.order == Complexity::O_1 || fit.rms < stats.best.rms * ( 1 - complexityMargin ) )
+                stats.best = fit;
+        }
+    }
+
+    // Fills in the throughputs from the median times of the rounds. The
+    // efficiency is relative to the fewest threads, as the range need not
+    // start with a single one
+    inline void analyseScaling( BenchmarkScalingStats& stats ) {
+        double basePerThread = 0;
+        std::size_t fewestThreads = 0;
+        for( std::vector<BenchmarkThreadScaling>::iterator it = stats.threadCounts.begin(), itEnd = stats.threadCounts.end(); it != itEnd; ++it ) {
+            double operations = static_cast<double>( it->threads * stats.iterations );
+            it->opsPerSecond = it->medianTime > 0 ? operations * 1e9 / it->medianTime : 0;
+            it->opsPerSecondPerThread = it->threads > 0 ? it->opsPerSecond / static_cast<double>( it->threads ) : 0;
+            if( fewestThreads == 0 || it->threads < fewestThreads ) {
+                fewestThreads = it->threads;
+                basePerThread = it->opsPerSecondPerThread;
+            }
+        }
+        for( std::vector<BenchmarkThreadScaling>::iterator it = stats.threadCounts.begin(), itEnd = stats.threadCounts.end(); it != itEnd; ++it )
+            it->efficiency = basePerThread > 0 ? it->opsPerSecondPerThread / basePerThread : 0;
+    }
+
+} // end namespace Benchmark
+
+    // A benchmark time, given in nanoseconds, in whichever unit reads best
+    inline std::string formatBenchmarkDuration( double nanoseconds ) {
+        static char const* const units[] = { "ns", "us", "ms", "s" };
+        std::size_t unit = 0;
+        while( unit < 3 && std::abs( nanoseconds ) >= 1000 ) {
+            nanoseconds /= 1000;
+            ++unit;
+        }
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision( 2 ) << nanoseconds << " " << units[unit];
+        return oss.str();
+    }
+
+    // A throughput, in operations per second, as k, M or G of them if need be
+    inline std::string formatBenchmarkRate( double perSecond ) {
+        static char const* const prefixes[] = { "", "k", "M", "G" };
+        std::size_t prefix = 0;
+        while( prefix < 3 && std::abs( perSecond ) >= 1000 ) {
+            perSecond /= 1000;
+            ++prefix;
+        }
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision( 2 ) << perSecond << " " << prefixes[prefix] << "ops/s";
+        return oss.str();
+    }
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_BENCHMARK_ANALYSIS_HPP_INCLUDED
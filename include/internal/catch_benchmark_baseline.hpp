@@ -0,0 +1,105 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_BENCHMARK_BASELINE_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_BENCHMARK_BASELINE_HPP_INCLUDED
+
+#include "catch_run_history.hpp"
+#include "catch_common.h"
+
+#include <map>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <limits>
+#include <cstdio>
+
+namespace Catch {
+
+    // The samples of each benchmark of a run, kept in a text file so later
+    // runs can be compared with them. The file starts with the commit the
+    // run was built from, as commit=<hash>, then has one line per benchmark:
+    // the (escaped) name of its test case, that of the benchmark, then its
+    // samples in nanoseconds, as samples=<comma separated list>
+    class BenchmarkBaseline {
+    public:
+        typedef std::pair<std::string, std::string> Key; // Test case and benchmark names
+
+        explicit BenchmarkBaseline( std::string const& commit = "" ) : m_commit( commit ) {}
+
+        bool load( std::string const& filename ) {
+            std::ifstream f( filename.c_str() );
+            if( !f )
+                return false;
+            read( f );
+            return true;
+        }
+        void read( std::istream& is ) {
+            std::string line;
+            while( std::getline( is, line ) ) {
+                if( line.empty() || line[0] == '#' )
+                    continue;
+                std::string::size_type tab = line.find( '\t' );
+                if( tab == std::string::npos ) {
+                    if( line.compare( 0, 7, "commit=" ) == 0 )
+                        m_commit = line.substr( 7 );
+                    continue;
+                }
+                std::string::size_type secondTab = line.find( '\t', tab+1 );
+                if( secondTab == std::string::npos || line.compare( secondTab+1, 8, "samples=" ) != 0 )
+                    continue;
+                Key key( RunHistory::unescape( line.substr( 0, tab ) ),
+                         RunHistory::unescape( line.substr( tab+1, secondTab-tab-1 ) ) );
+                std::vector<double>& samples = m_samples[key];
+                samples.clear();
+                std::istringstream iss( line.substr( secondTab+9 ) );
+                double sample;
+                while( iss >> sample ) {
+                    samples.push_back( sample );
+                    iss.ignore( 1 ); // The comma
+                }
+            }
+        }
+
+        // Replaced whole, as the run history is
+        bool save( std::string const& filename ) const {
+            std::ostringstream oss;
+            write( oss );
+            return replaceFile( filename, oss.str() );
+        }
+        void write( std::ostream& os ) const {
+            os << "# Catch benchmark baseline\n"
+               << "commit=" << m_commit << "\n";
+            std::streamsize precision = os.precision( std::numeric_limits<double>::digits10 );
+            for( std::map<Key, std::vector<double> >::const_iterator it = m_samples.begin(), itEnd = m_samples.end(); it != itEnd; ++it ) {
+                os << RunHistory::escape( it->first.first ) << '\t' << RunHistory::escape( it->first.second ) << "\tsamples=";
+                for( std::size_t i = 0; i < it->second.size(); ++i )
+                    os << ( i > 0 ? "," : "" ) << it->second[i];
+                os << '\n';
+            }
+            os.precision( precision );
+        }
+
+        void record( std::string const& testName, std::string const& benchmarkName, std::vector<double> const& samples ) {
+            m_samples[Key( testName, benchmarkName )] = samples;
+        }
+
+        // CATCH_NULL if the benchmark is not in the baseline
+        std::vector<double> const* find( std::string const& testName, std::string const& benchmarkName ) const {
+            std::map<Key, std::vector<double> >::const_iterator it = m_samples.find( Key( testName, benchmarkName ) );
+            return it != m_samples.end() && !it->second.empty() ? &it->second : CATCH_NULL;
+        }
+
+        std::string const& commit() const { return m_commit; }
+        bool empty() const { return m_samples.empty(); }
+
+    private:
+        std::string m_commit;
+        std::map<Key, std::vector<double> > m_samples;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_BENCHMARK_BASELINE_HPP_INCLUDED
@@ -0,0 +1,51 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_BENCHMARK_BASELINE_RECORDER_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_BENCHMARK_BASELINE_RECORDER_HPP_INCLUDED
+
+#include "catch_interfaces_reporter.h"
+#include "catch_benchmark_baseline.hpp"
+
+namespace Catch {
+
+    // Listens to the reporter events to keep the samples of each benchmark
+    // in a baseline, under the name of the test case it was run in
+    class BenchmarkBaselineRecorder : public SharedImpl<IStreamingReporter> {
+    public:
+        BenchmarkBaselineRecorder( BenchmarkBaseline& baseline )
+        :   m_baseline( baseline )
+        {}
+
+        virtual ReporterPreferences getPreferences() const CATCH_OVERRIDE {
+            return ReporterPreferences();
+        }
+
+        virtual void noMatchingTestCases( std::string const& ) CATCH_OVERRIDE {}
+        virtual void testRunStarting( TestRunInfo const& ) CATCH_OVERRIDE {}
+        virtual void testGroupStarting( GroupInfo const& ) CATCH_OVERRIDE {}
+        virtual void testGroupEnded( TestGroupStats const& ) CATCH_OVERRIDE {}
+        virtual void testRunEnded( TestRunStats const& ) CATCH_OVERRIDE {}
+        virtual void skipTest( TestCaseInfo const& ) CATCH_OVERRIDE {}
+        virtual void sectionStarting( SectionInfo const& ) CATCH_OVERRIDE {}
+        virtual void sectionEnded( SectionStats const& ) CATCH_OVERRIDE {}
+        virtual void assertionStarting( AssertionInfo const& ) CATCH_OVERRIDE {}
+        virtual bool assertionEnded( AssertionStats const& ) CATCH_OVERRIDE { return false; }
+        virtual void testCaseEnded( TestCaseStats const& ) CATCH_OVERRIDE {}
+
+        virtual void testCaseStarting( TestCaseInfo const& testInfo ) CATCH_OVERRIDE {
+            m_testName = testInfo.name;
+        }
+        virtual void benchmarkEnded( BenchmarkStats const& benchmarkStats ) CATCH_OVERRIDE {
+            m_baseline.record( m_testName, benchmarkStats.name, benchmarkStats.samples );
+        }
+
+    private:
+        BenchmarkBaseline& m_baseline;
+        std::string m_testName;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_BENCHMARK_BASELINE_RECORDER_HPP_INCLUDED
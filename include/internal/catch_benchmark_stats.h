@@ -0,0 +1,200 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_BENCHMARK_STATS_H_INCLUDED
+#define TWOBLUECUBES_CATCH_BENCHMARK_STATS_H_INCLUDED
+
+#include "catch_common.h"
+
+#include <string>
+#include <vector>
+
+namespace Catch {
+
+    // A statistic of the samples, with the bounds of its confidence interval
+    struct BenchmarkEstimate {
+        BenchmarkEstimate() : point( 0 ), lowerBound( 0 ), upperBound( 0 ), confidenceInterval( 0 ) {}
+        double point;
+        double lowerBound;
+        double upperBound;
+        double confidenceInterval; // 0.95 for 95%
+    };
+
+    // Samples beyond the inner (mild) or outer (severe) fences: 1.5 and 3
+    // interquartile ranges beyond the quartiles
+    struct BenchmarkOutliers {
+        BenchmarkOutliers() : samplesSeen( 0 ), lowSevere( 0 ), lowMild( 0 ), highMild( 0 ), highSevere( 0 ) {}
+        std::size_t total() const { return lowSevere + lowMild + highMild + highSevere; }
+        std::size_t samplesSeen;
+        std::size_t lowSevere;
+        std::size_t lowMild;
+        std::size_t highMild;
+        std::size_t highSevere;
+    };
+
+    // Times are in nanoseconds, per iteration of the benchmark's body
+    struct BenchmarkStats {
+        BenchmarkStats( std::string const& _name, SourceLineInfo const& _lineInfo )
+        :   name( _name ),
+            lineInfo( _lineInfo ),
+            iterations( 0 ),
+            resamples( 0 ),
+            clockResolution( 0 ),
+            clockOverhead( 0 ),
+            median( 0 )
+        {}
+        virtual ~BenchmarkStats();
+
+#  ifdef CATCH_CONFIG_CPP11_GENERATED_METHODS
+        BenchmarkStats( BenchmarkStats const& )              = default;
+        BenchmarkStats( BenchmarkStats && )                  = default;
+        BenchmarkStats& operator = ( BenchmarkStats const& ) = default;
+        BenchmarkStats& operator = ( BenchmarkStats && )     = default;
+#  endif
+
+        std::string name;
+        SourceLineInfo lineInfo;
+        std::size_t iterations; // Per sample
+        std::size_t resamples; // Bootstrapped for the confidence intervals
+        double clockResolution;
+        double clockOverhead;
+        std::vector<double> samples;
+        BenchmarkEstimate mean;
+        double median;
+        BenchmarkEstimate standardDeviation;
+        BenchmarkOutliers outliers;
+    };
+
+    // Of two variants of the same code, sampled in turn in a random order.
+    // Each variant is also reported as a benchmark of its own
+    struct BenchmarkComparisonStats {
+        BenchmarkComparisonStats( std::string const& _oldName, std::string const& _newName, SourceLineInfo const& _lineInfo )
+        :   oldName( _oldName ),
+            newName( _newName ),
+            lineInfo( _lineInfo ),
+            samples( 0 ),
+            z( 0 ),
+            pNewSlower( 1 ),
+            pNewFaster( 1 )
+        {}
+        virtual ~BenchmarkComparisonStats();
+
+#  ifdef CATCH_CONFIG_CPP11_GENERATED_METHODS
+        BenchmarkComparisonStats( BenchmarkComparisonStats const& )              = default;
+        BenchmarkComparisonStats( BenchmarkComparisonStats && )                  = default;
+        BenchmarkComparisonStats& operator = ( BenchmarkComparisonStats const& ) = default;
+        BenchmarkComparisonStats& operator = ( BenchmarkComparisonStats && )     = default;
+#  endif
+
+        // Unless the Mann-Whitney U test finds the new variant slower at this confidence
+        bool newIsNotSlower( double confidence ) const { return !( pNewSlower < 1 - confidence ); }
+        bool newIsSlower() const { return !newIsNotSlower( ratio.confidenceInterval ); }
+        bool newIsFaster() const { return pNewFaster < 1 - ratio.confidenceInterval; }
+
+        std::string oldName;
+        std::string newName;
+        SourceLineInfo lineInfo;
+        std::size_t samples; // Of each variant
+        BenchmarkEstimate ratio; // Of the mean time of the new variant to that of the old one
+        double z; // Of the Mann-Whitney U of the new variant's samples
+        double pNewSlower; // One-sided
+        double pNewFaster;
+    };
+
+    // The orders of growth a BENCHMARK_RANGE's times are fitted to, slowest last
+    struct Complexity { enum Order {
+        O_1,
+        O_LOG_N,
+        O_N,
+        O_N_LOG_N,
+        O_N_SQUARED
+    }; };
+
+    inline char const* complexityName( Complexity::Order order ) {
+        switch( order ) {
+            case Complexity::O_1: return "O(1)";
+            case Complexity::O_LOG_N: return "O(log n)";
+            case Complexity::O_N: return "O(n)";
+            case Complexity::O_N_LOG_N: return "O(n log n)";
+            case Complexity::O_N_SQUARED: return "O(n^2)";
+        }
+        return "O(?)";
+    }
+
+    // The times, as the coefficient times the order's function of n,
+    // fitted by least squares
+    struct ComplexityFit {
+        ComplexityFit( Complexity::Order _order = Complexity::O_1 ) : order( _order ), coefficient( 0 ), rms( 0 ) {}
+        Complexity::Order order;
+        double coefficient; // In nanoseconds
+        double rms; // Of the residuals, relative to the mean of the times
+    };
+
+    // Of a benchmark run at each size of a range. Each size is also reported
+    // as a benchmark of its own
+    struct BenchmarkComplexityStats {
+        BenchmarkComplexityStats( std::string const& _name, SourceLineInfo const& _lineInfo )
+        :   name( _name ),
+            lineInfo( _lineInfo )
+        {}
+        virtual ~BenchmarkComplexityStats();
+
+#  ifdef CATCH_CONFIG_CPP11_GENERATED_METHODS
+        BenchmarkComplexityStats( BenchmarkComplexityStats const& )              = default;
+        BenchmarkComplexityStats( BenchmarkComplexityStats && )                  = default;
+        BenchmarkComplexityStats& operator = ( BenchmarkComplexityStats const& ) = default;
+        BenchmarkComplexityStats& operator = ( BenchmarkComplexityStats && )     = default;
+#  endif
+
+        std::string name;
+        SourceLineInfo lineInfo;
+        std::vector<std::size_t> sizes;
+        std::vector<double> medians; // Of each size, in nanoseconds
+        std::vector<ComplexityFit> fits; // One per order, from O(1) up
+        ComplexityFit best; // The one with the least RMS
+    };
+
+    // Of a BENCHMARK_THREADS at one of its thread counts
+    struct BenchmarkThreadScaling {
+        BenchmarkThreadScaling( std::size_t _threads = 0 )
+        :   threads( _threads ),
+            medianTime( 0 ),
+            opsPerSecond( 0 ),
+            opsPerSecondPerThread( 0 ),
+            efficiency( 0 )
+        {}
+        std::size_t threads;
+        double medianTime; // Of a round, in nanoseconds: from the threads' release to the last one's end
+        double opsPerSecond; // Of all the threads together
+        double opsPerSecondPerThread;
+        double efficiency; // The throughput per thread, relative to that with the fewest threads
+    };
+
+    // Of a benchmark run concurrently on each of a range of thread counts
+    struct BenchmarkScalingStats {
+        BenchmarkScalingStats( std::string const& _name, SourceLineInfo const& _lineInfo )
+        :   name( _name ),
+            lineInfo( _lineInfo ),
+            iterations( 0 ),
+            samples( 0 )
+        {}
+        virtual ~BenchmarkScalingStats();
+
+#  ifdef CATCH_CONFIG_CPP11_GENERATED_METHODS
+        BenchmarkScalingStats( BenchmarkScalingStats const& )              = default;
+        BenchmarkScalingStats( BenchmarkScalingStats && )                  = default;
+        BenchmarkScalingStats& operator = ( BenchmarkScalingStats const& ) = default;
+        BenchmarkScalingStats& operator = ( BenchmarkScalingStats && )     = default;
+#  endif
+
+        std::string name;
+        SourceLineInfo lineInfo;
+        std::size_t iterations; // Per thread and round
+        std::size_t samples; // Rounds, at each thread count
+        std::vector<BenchmarkThreadScaling> threadCounts;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_BENCHMARK_STATS_H_INCLUDED
@@ -0,0 +1,185 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_BENCHMARK_THREADS_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_BENCHMARK_THREADS_HPP_INCLUDED
+
+#include "catch_benchmark.hpp"
+#include "catch_generators.hpp"
+#include "catch_cpu_pinning.hpp"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+
+namespace Catch {
+namespace Benchmark {
+
+    // Lets threads wait for each other by spinning, so that they are all
+    // released within a few nanoseconds rather than woken one by one. It
+    // yields while spinning, in case there are more threads than CPUs
+    class SpinBarrier : NonCopyable {
+    public:
+        explicit SpinBarrier( std::size_t parties )
+        :   m_parties( parties ),
+            m_waiting( 0 ),
+            m_generation( 0 )
+        {}
+
+        void wait() {
+            std::size_t generation = m_generation.load( std::memory_order_acquire );
+            if( m_waiting.fetch_add( 1, std::memory_order_acq_rel ) + 1 == m_parties ) {
+                m_waiting.store( 0, std::memory_order_relaxed );
+                m_generation.fetch_add( 1, std::memory_order_release );
+            }
+            else {
+                while( m_generation.load( std::memory_order_acquire ) == generation )
+                    std::this_thread::yield();
+            }
+        }
+
+    private:
+        std::size_t const m_parties;
+        std::atomic<std::size_t> m_waiting;
+        std::atomic<std::size_t> m_generation; // Of the rounds of waiting
+    };
+
+    // Runs the function on a number of threads at once, the calling one
+    // included, in rounds that each start and end at the barrier. The other
+    // threads are all started before the first round, so starting them is
+    // never timed, and each is pinned to a CPU of its own under --pin. The
+    // first round is only there to warm up. The first exception any thread
+    // throws is rethrown once they are all joined; the rounds go on without
+    // calling the function again, to keep the barrier
+    template<typename Fun>
+    class ThreadRounds : NonCopyable {
+    public:
+        ThreadRounds( Fun& fun, std::size_t threads, std::size_t iterations, std::size_t rounds )
+        :   m_fun( fun ),
+            m_barrier( threads ),
+            m_iterations( iterations ),
+            m_rounds( rounds ),
+            m_failed( false )
+        {
+            m_roundTimes.reserve( rounds );
+            for( std::size_t i = 1; i < threads; ++i ) {
+                CpuPlacement placement;
+                if( CpuPinning* pinning = CpuPinning::active() )
+                    placement = pinning->nextForChild();
+                m_threads.push_back( std::thread( &ThreadRounds::threadMain, this, placement ) );
+            }
+        }
+
+        // The time of each round but the first, in nanoseconds
+        std::vector<double> run() {
+            m_barrier.wait();
+            runRound();
+            m_barrier.wait();
+            for( std::size_t i = 0; i < m_rounds; ++i ) {
+                m_barrier.wait();
+                Timer timer;
+                timer.start();
+                runRound();
+                m_barrier.wait();
+                m_roundTimes.push_back( static_cast<double>( timer.getElapsedNanoseconds() ) );
+            }
+            join();
+            if( m_error )
+                std::rethrow_exception( m_error );
+            return m_roundTimes;
+        }
+
+        ~ThreadRounds() {
+            join();
+        }
+
+    private:
+        void threadMain( CpuPlacement placement ) {
+            if( placement.cpu >= 0 )
+                CpuPinning::pin( placement ); // Only this thread, on Linux
+            for( std::size_t i = 0; i <= m_rounds; ++i ) {
+                m_barrier.wait();
+                runRound();
+                m_barrier.wait();
+            }
+        }
+
+        void runRound() {
+            if( m_failed.load( std::memory_order_relaxed ) )
+                return;
+            try {
+                for( std::size_t i = 0; i < m_iterations; ++i )
+                    m_fun();
+            }
+            catch( ... ) {
+                std::lock_guard<std::mutex> lock( m_errorMutex );
+                if( !m_error )
+                    m_error = std::current_exception();
+                m_failed = true;
+            }
+        }
+
+        void join() {
+            for( std::vector<std::thread>::iterator it = m_threads.begin(), itEnd = m_threads.end(); it != itEnd; ++it )
+                if( it->joinable() )
+                    it->join();
+        }
+
+        Fun& m_fun;
+        SpinBarrier m_barrier;
+        std::size_t m_iterations; // Per thread and round
+        std::size_t m_rounds; // Timed ones
+        std::vector<double> m_roundTimes;
+        std::vector<std::thread> m_threads;
+        std::atomic<bool> m_failed;
+        std::mutex m_errorMutex;
+        std::exception_ptr m_error;
+    };
+
+    // So that releasing the threads together weighs little in a round
+    static const uint64_t minimumRoundTime = 1000000;
+
+    // What BENCHMARK_THREADS expands to. The function is warmed up on this
+    // thread, as a BENCHMARK would be, to find how many times each thread
+    // calls it per round, then run in rounds on each thread count in turn.
+    // The throughputs come from the median time of the rounds. They are
+    // reported, then returned for the test to check
+    template<typename T, typename Fun>
+    BenchmarkScalingStats scaleThreads( SourceLineInfo const& lineInfo,
+                                        std::string const& name,
+                                        CompositeGenerator<T> const& threadCounts,
+                                        Fun fun ) {
+        Ptr<IConfig const> config = getCurrentContext().getConfig();
+        ClockEnvironment const& environment = ClockEnvironment::get();
+        BenchmarkScalingStats stats( name, lineInfo );
+        stats.samples = static_cast<std::size_t>( config->benchmarkSamples() );
+        stats.iterations = warmUp( fun,
+                                   std::max( environment.minimumBatchTime(), minimumRoundTime ),
+                                   static_cast<unsigned int>( config->benchmarkWarmupTime() ) );
+
+        for( std::size_t i = 0; i < threadCounts.size(); ++i ) {
+            std::size_t threads = static_cast<std::size_t>( threadCounts.getValue( i ) );
+            if( threads == 0 )
+                continue;
+            ThreadRounds<Fun> rounds( fun, threads, stats.iterations, stats.samples );
+            BenchmarkThreadScaling scaling( threads );
+            scaling.medianTime = median( rounds.run() );
+            stats.threadCounts.push_back( scaling );
+        }
+
+        analyseScaling( stats );
+        getResultCapture().benchmarkScaled( stats );
+        return stats;
+    }
+
+} // end namespace Benchmark
+} // end namespace Catch
+
+// Variadic, as the commas within the function's braces would otherwise split the arguments
+#define INTERNAL_CATCH_BENCHMARK_THREADS( name, ... ) \
+    Catch::Benchmark::scaleThreads( CATCH_INTERNAL_LINEINFO, name, __VA_ARGS__ )
+
+#endif // TWOBLUECUBES_CATCH_BENCHMARK_THREADS_HPP_INCLUDED
@@ -11,6 +11,7 @@
 #include "catch_config.hpp"
 #include "catch_common.h"
 #include "catch_clara.h"
+#include "catch_cpu_pinning.hpp"
 
 #include <fstream>
 
@@ -22,7 +23,96 @@ namespace Catch {
             throw std::runtime_error( "Value after -x or --abortAfter must be greater than zero" );
         config.abortAfter = x;
     }
+    inline void setTestTimeout( ConfigData& config, int timeout ) {
+        if( timeout < 1 )
+            throw std::runtime_error( "Value after --test-timeout must be greater than zero" );
+        config.testTimeout = timeout;
+    }
+    inline void setWorkers( ConfigData& config, int workers ) {
+        if( workers < 1 )
+            throw std::runtime_error( "Value after --workers must be greater than zero" );
+        config.workers = workers;
+    }
+    inline void setThreads( ConfigData& config, int threads ) {
+        if( threads < 1 )
+            throw std::runtime_error( "Value after --threads must be greater than zero" );
+        config.threads = threads;
+    }
+    inline void setRepeat( ConfigData& config, int repeat ) {
+        if( repeat < 1 )
+            throw std::runtime_error( "Value after --repeat must be greater than zero" );
+        config.repeat = repeat;
+    }
+    inline void setRetryFailed( ConfigData& config, int retries ) {
+        if( retries < 1 )
+            throw std::runtime_error( "Value after --retry-failed must be greater than zero" );
+        config.retryFailed = retries;
+    }
+    inline void setCheckpointWorkers( ConfigData& config, int workers ) {
+        if( workers < 1 )
+            throw std::runtime_error( "Value after --checkpoint-workers must be greater than zero" );
+        config.checkpointWorkers = workers;
+    }
+    inline void setTimeBudget( ConfigData& config, double seconds ) {
+        if( !( seconds > 0 ) )
+            throw std::runtime_error( "Value after --time-budget must be greater than zero" );
+        config.timeBudget = seconds;
+    }
+    inline void setMemoryBudget( ConfigData& config, int megabytes ) {
+        if( megabytes < 1 )
+            throw std::runtime_error( "Value after --memory-budget must be greater than zero" );
+        config.memoryBudget = megabytes;
+    }
+    inline void setBenchmarkSamples( ConfigData& config, int samples ) {
+        if( samples < 1 )
+            throw std::runtime_error( "Value after --benchmark-samples must be greater than zero" );
+        config.benchmarkSamples = samples;
+    }
+    inline void setBenchmarkResamples( ConfigData& config, int resamples ) {
+        if( resamples < 0 )
+            throw std::runtime_error( "Value after --benchmark-resamples must not be negative" );
+        config.benchmarkResamples = resamples;
+    }
+    inline void setBenchmarkConfidenceInterval( ConfigData& config, double confidenceInterval ) {
+        if( !( confidenceInterval > 0 && confidenceInterval < 1 ) )
+            throw std::runtime_error( "Value after --benchmark-confidence-interval must be between 0 and 1" );
+        config.benchmarkConfidenceInterval = confidenceInterval;
+    }
+    inline void setBenchmarkWarmupTime( ConfigData& config, int milliseconds ) {
+        if( milliseconds < 0 )
+            throw std::runtime_error( "Value after --benchmark-warmup-time must not be negative" );
+        config.benchmarkWarmupTime = milliseconds;
+    }
+    inline void setBenchmarkThreshold( ConfigData& config, double percent ) {
+        if( percent < 0 )
+            throw std::runtime_error( "Value after --benchmark-threshold must not be negative" );
+        config.benchmarkThreshold = percent;
+    }
+    inline void setCpus( ConfigData& config, std::string const& list ) {
+        config.cpus = parseCpuList( list );
+        config.pin = true;
+    }
+    inline void isolateTests( ConfigData& config ) {
+        if( config.isolateBatch == 0 )
+            config.isolateBatch = 1;
+    }
+    inline void setIsolateBatch( ConfigData& config, int batch ) {
+        if( batch < 1 )
+            throw std::runtime_error( "Value after --isolate-batch must be greater than zero" );
+        config.isolateBatch = batch;
+    }
+    inline void setShardCount( ConfigData& config, int count ) {
+        if( count < 1 )
+            throw std::runtime_error( "Value after --shard-count must be greater than zero" );
+        config.shardCount = count;
+    }
+    inline void setShardIndex( ConfigData& config, int index ) {
+        if( index < 0 )
+            throw std::runtime_error( "Value after --shard-index must not be negative" );
+        config.shardIndex = index;
+    }
     inline void addTestOrTags( ConfigData& config, std::string const& _testSpec ) { config.testsOrTags.push_back( _testSpec ); }
+    inline void addSectionToRun( ConfigData& config, std::string const& sectionName ) { config.sectionsToRun.push_back( sectionName ); }
     inline void addReporterName( ConfigData& config, std::string const& _reporterName ) { config.reporterNames.push_back( _reporterName ); }
 
     inline void addWarning( ConfigData& config, std::string const& _warning ) {
@@ -38,9 +128,17 @@ namespace Catch {
             config.runOrder = RunTests::InLexicographicalOrder;
         else if( startsWith( "random", order ) )
             config.runOrder = RunTests::InRandomOrder;
+        else if( startsWith( "duration", order ) )
+            config.runOrder = RunTests::InDurationOrder;
+        else if( startsWith( "failures-first", order ) )
+            config.runOrder = RunTests::InFailuresFirstOrder;
         else
             throw std::runtime_error( "Unrecognised ordering: '" + order + "'" );
     }
+    inline void resumeFromJournal( ConfigData& config, std::string const& journalFilename ) {
+        config.journalFilename = journalFilename;
+        config.resumeJournal = true;
+    }
     inline void setRngSeed( ConfigData& config, std::string const& seed ) {
         if( seed == "time" ) {
             config.rngSeed = 0;
@@ -164,6 +262,10 @@ namespace Catch {
             .describe( "which test or tests to use" )
             .bind( &addTestOrTags, "test name, pattern or tags" );
 
+        cli["-c"]["--section"]
+            .describe( "only run this section (repeat for the sections within it)" )
+            .bind( &addSectionToRun, "section name" );
+
         cli["-D"]["--durations"]
             .describe( "show test durations" )
             .bind( &setShowDurations, "yes|no" );
@@ -187,12 +289,148 @@ namespace Catch {
 
         cli["--order"]
             .describe( "test case order (defaults to decl)" )
-            .bind( &setOrder, "decl|lex|rand" );
+            .bind( &setOrder, "decl|lex|rand|duration|failures-first" );
 
         cli["-R"]["--rng-seed"]
             .describe( "set a specific seed for random numbers" )
             .bind( &setRngSeed, "'time'|number" );
 
+        cli["--test-timeout"]
+            .describe( "fail and end the run if a test takes longer than this" )
+            .bind( &setTestTimeout, "milliseconds" );
+
+        cli["--workers"]
+            .describe( "run tests in this many forked processes" )
+            .bind( &setWorkers, "count" );
+
+        cli["--threads"]
+            .describe( "run tests tagged [parallel] on this many threads" )
+            .bind( &setThreads, "count" );
+
+        cli["--pin"]
+            .describe( "pin the test process, and each process forked from it, to a CPU" )
+            .bind( &ConfigData::pin );
+
+        cli["--cpus"]
+            .describe( "pin to these CPUs only (e.g. 0-3,8)" )
+            .bind( &setCpus, "list" );
+
+        cli["--memory-budget"]
+            .describe( "only run tests in workers at the same time while their memory fits in this" )
+            .bind( &setMemoryBudget, "megabytes" );
+
+        cli["--isolate"]
+            .describe( "run each test in its own forked process" )
+            .bind( &isolateTests );
+
+        cli["--isolate-batch"]
+            .describe( "run tests in forked processes, this many per process" )
+            .bind( &setIsolateBatch, "count" );
+
+        cli["--repeat"]
+            .describe( "run each test this many times, each with a different seed" )
+            .bind( &setRepeat, "count" );
+
+        cli["--until-fail"]
+            .describe( "repeat each test until it fails (at most --repeat times)" )
+            .bind( &ConfigData::untilFail );
+
+        cli["--retry-failed"]
+            .describe( "run failed tests again in fresh processes, up to this many times" )
+            .bind( &setRetryFailed, "count" );
+
+        cli["--checkpoint-workers"]
+            .describe( "run this many passes through [checkpoint] tests at once" )
+            .bind( &setCheckpointWorkers, "count" );
+
+        cli["--shard-count"]
+            .describe( "split the tests into this many shards" )
+            .bind( &setShardCount, "count" );
+
+        cli["--shard-index"]
+            .describe( "only run or list the shard with this index" )
+            .bind( &setShardIndex, "index" );
+
+        cli["--shard-balance"]
+            .describe( "balance the shards by their durations in the history" )
+            .bind( &ConfigData::balanceShards );
+
+        cli["--benchmark-samples"]
+            .describe( "number of samples to take of each benchmark (default: 100)" )
+            .bind( &setBenchmarkSamples, "count" );
+
+        cli["--benchmark-resamples"]
+            .describe( "number of resamples for the benchmark confidence intervals (default: 100000)" )
+            .bind( &setBenchmarkResamples, "count" );
+
+        cli["--benchmark-confidence-interval"]
+            .describe( "confidence interval of the benchmark estimates (default: 0.95)" )
+            .bind( &setBenchmarkConfidenceInterval, "fraction" );
+
+        cli["--benchmark-warmup-time"]
+            .describe( "time to run each benchmark for before sampling it (default: 100)" )
+            .bind( &setBenchmarkWarmupTime, "milliseconds" );
+
+        cli["--benchmark-baseline"]
+            .describe( "file to save the benchmark samples to, with the commit they were taken at" )
+            .bind( &ConfigData::benchmarkBaselineFilename, "filename" );
+
+        cli["--benchmark-compare"]
+            .describe( "baseline file to compare the benchmarks with, failing those that regressed" )
+            .bind( &ConfigData::benchmarkCompareFilename, "filename" );
+
+        cli["--benchmark-threshold"]
+            .describe( "how much slower a benchmark may get before it fails (default: 10)" )
+            .bind( &setBenchmarkThreshold, "percent" );
+
+        cli["--history"]
+            .describe( "file recording the durations of previous runs" )
+            .bind( &ConfigData::historyFilename, "filename" );
+
+        cli["--rerun-failed"]
+            .describe( "only run the tests that failed in the last run" )
+            .bind( &ConfigData::rerunFailed );
+
+        cli["--time-budget"]
+            .describe( "run the tests most likely to fail that fit in this time" )
+            .bind( &setTimeBudget, "seconds" );
+
+        cli["--journal"]
+            .describe( "file recording each test as it completes" )
+            .bind( &ConfigData::journalFilename, "filename" );
+
+        cli["--resume"]
+            .describe( "skip the tests completed in this journal, then carry on with it" )
+            .bind( &resumeFromJournal, "filename" );
+
+        cli["--cache"]
+            .describe( "file recording the tests that passed, to skip them while unchanged" )
+            .bind( &ConfigData::cacheFilename, "filename" );
+
+        cli["--no-cache"]
+            .describe( "run all the tests, still updating the cache" )
+            .bind( &ConfigData::noCache );
+
+        cli["--impact-map"]
+            .describe( "file recording the source files each test executes" )
+            .bind( &ConfigData::impactMapFilename, "filename" );
+
+        cli["--record-impact"]
+            .describe( "record the source files the tests execute in the impact map" )
+            .bind( &ConfigData::recordImpact );
+
+        cli["--impacted-by"]
+            .describe( "only run the tests that execute one of the files listed in this file" )
+            .bind( &ConfigData::impactedByFilename, "filename" );
+
+        cli["--serve"]
+            .describe( "run tests on request from clients of this socket" )
+            .bind( &ConfigData::serveSocket, "socket" );
+
+        cli["--connect"]
+            .describe( "have the test server on this socket run the tests" )
+            .bind( &ConfigData::connectSocket, "socket" );
+
         cli["--force-colour"]
         .describe( "force colourised output (deprecated)" )
         .bind( &forceColour );
@@ -12,11 +12,15 @@
 #include "catch_context.h"
 #include "catch_interfaces_config.h"
 #include "catch_stream.h"
+#include "catch_run_history.hpp"
+#include "catch_benchmark_baseline.hpp"
+#include "catch_test_impact.hpp"
 
 #include <memory>
 #include <vector>
 #include <string>
 #include <iostream>
+#include <fstream>
 #include <ctime>
 
 #ifndef CATCH_CONFIG_CONSOLE_WIDTH
@@ -38,8 +42,31 @@ namespace Catch {
             showHelp( false ),
             showInvisibles( false ),
             filenamesAsTags( false ),
+            rerunFailed( false ),
+            resumeJournal( false ),
+            noCache( false ),
+            recordImpact( false ),
+            untilFail( false ),
+            pin( false ),
+            balanceShards( false ),
             abortAfter( -1 ),
+            testTimeout( 0 ),
+            workers( 0 ),
+            threads( 0 ),
+            isolateBatch( 0 ),
+            repeat( 0 ),
+            retryFailed( 0 ),
+            checkpointWorkers( 1 ),
+            memoryBudget( 0 ),
+            shardCount( 1 ),
+            shardIndex( 0 ),
             rngSeed( 1 ),
+            timeBudget( 0 ),
+            benchmarkSamples( 100 ),
+            benchmarkResamples( 100000 ),
+            benchmarkConfidenceInterval( 0.95 ),
+            benchmarkWarmupTime( 100 ),
+            benchmarkThreshold( 10 ),
             verbosity( Verbosity::Normal ),
             warnings( WarnAbout::Nothing ),
             showDurations( ShowDurations::DefaultForReporter ),
@@ -58,9 +85,32 @@ namespace Catch {
         bool showHelp;
         bool showInvisibles;
         bool filenamesAsTags;
+        bool rerunFailed;
+        bool resumeJournal;
+        bool noCache;
+        bool recordImpact;
+        bool untilFail;
+        bool pin;
+        bool balanceShards;
 
         int abortAfter;
+        int testTimeout;
+        int workers;
+        int threads;
+        int isolateBatch;
+        int repeat;
+        int retryFailed;
+        int checkpointWorkers;
+        int memoryBudget;
+        int shardCount;
+        int shardIndex;
         unsigned int rngSeed;
+        double timeBudget;
+        int benchmarkSamples;
+        int benchmarkResamples;
+        double benchmarkConfidenceInterval;
+        int benchmarkWarmupTime; // Milliseconds
+        double benchmarkThreshold; // Percent
 
         Verbosity::Level verbosity;
         WarnAbout::What warnings;
@@ -73,9 +123,20 @@ namespace Catch {
         std::string processName;
         std::string debugLevel;
         std::string md5DatabaseName;
+        std::string historyFilename;
+        std::string journalFilename;
+        std::string cacheFilename;
+        std::string impactMapFilename;
+        std::string impactedByFilename;
+        std::string serveSocket;
+        std::string connectSocket;
+        std::string benchmarkBaselineFilename;
+        std::string benchmarkCompareFilename;
 
         std::vector<std::string> reporterNames;
         std::vector<std::string> testsOrTags;
+        std::vector<std::string> sectionsToRun;
+        std::vector<int> cpus;
     };
 
 
@@ -99,6 +160,38 @@ namespace Catch {
                     parser.parse( data.testsOrTags[i] );
                 m_testSpec = parser.testSpec();
             }
+            if( data.shardIndex >= data.shardCount )
+                throw std::domain_error( "Value after --shard-index must be less than the shard count" );
+            if( data.runOrder == RunTests::InDurationOrder && data.historyFilename.empty() )
+                throw std::domain_error( "--order duration needs a --history file to know how long the tests take" );
+            if( data.balanceShards && data.historyFilename.empty() )
+                throw std::domain_error( "--shard-balance needs a --history file to know how long the tests take" );
+            if( ( data.rerunFailed || data.runOrder == RunTests::InFailuresFirstOrder ) && data.historyFilename.empty() )
+                throw std::domain_error( "--rerun-failed and --order failures-first need a --history file to know what failed" );
+            if( data.memoryBudget > 0 && data.workers == 0 && data.isolateBatch == 0 )
+                throw std::domain_error( "--memory-budget only applies to tests run in worker processes (--workers or --isolate)" );
+            if( data.memoryBudget > 0 && data.historyFilename.empty() )
+                throw std::domain_error( "--memory-budget needs a --history file to know how much memory the tests take" );
+            if( data.timeBudget > 0 && data.historyFilename.empty() )
+                throw std::domain_error( "--time-budget needs a --history file to know what the tests cost" );
+            if( data.timeBudget > 0 && ( data.repeat > 0 || data.untilFail ) )
+                throw std::domain_error( "--time-budget cannot be used with --repeat or --until-fail" );
+            if( !data.historyFilename.empty() )
+                m_history.load( data.historyFilename );
+            if( ( data.recordImpact || !data.impactedByFilename.empty() ) && data.impactMapFilename.empty() )
+                throw std::domain_error( "--record-impact and --impacted-by need an --impact-map file" );
+            if( data.recordImpact && ( data.workers > 0 || data.threads > 0 || data.isolateBatch > 0 || data.retryFailed > 0 ) )
+                throw std::domain_error( "--record-impact only records the tests run in this process, so cannot be used with workers, threads, isolation or retries" );
+            if( data.untilFail && data.repeat == 0 && ( data.workers > 0 || data.threads > 0 || data.isolateBatch > 0 ) )
+                throw std::domain_error( "--until-fail needs a --repeat count to hand the repetitions out to workers" );
+            if( data.threads > 0 && ( data.workers > 0 || data.isolateBatch > 0 ) )
+                throw std::domain_error( "--threads runs [parallel] tests in this process, so cannot be used with --workers or --isolate" );
+            if( !data.impactMapFilename.empty() )
+                m_impactMap.load( data.impactMapFilename );
+            if( !data.impactedByFilename.empty() )
+                m_impactMap.selectImpactedBy( readChangedFiles( data.impactedByFilename ) );
+            if( !data.benchmarkCompareFilename.empty() && !m_benchmarkBaseline.load( data.benchmarkCompareFilename ) )
+                throw std::domain_error( "Unable to read the benchmark baseline from: " + data.benchmarkCompareFilename );
         }
 
         virtual ~Config() {
@@ -120,9 +213,46 @@ namespace Catch {
         std::vector<std::string> getReporterNames() const { return m_data.reporterNames; }
 
         int abortAfter() const override { return m_data.abortAfter; }
+        int testTimeout() const override { return m_data.testTimeout; }
+        int workers() const { return m_data.workers; }
+        int threads() const { return m_data.threads; }
+        int isolateBatch() const { return m_data.isolateBatch; }
+        int repeat() const { return m_data.repeat; }
+        bool untilFail() const { return m_data.untilFail; }
+        int retryFailed() const { return m_data.retryFailed; }
+        int checkpointWorkers() const override { return m_data.checkpointWorkers; }
+        int memoryBudget() const override { return m_data.memoryBudget; }
+        bool pin() const { return m_data.pin; }
+        std::vector<int> const& cpus() const { return m_data.cpus; }
+        int shardCount() const override { return m_data.shardCount; }
+        int shardIndex() const override { return m_data.shardIndex; }
+        bool balanceShards() const override { return m_data.balanceShards; }
+        bool rerunFailed() const override { return m_data.rerunFailed; }
+        double timeBudget() const { return m_data.timeBudget; }
+        int benchmarkSamples() const override { return m_data.benchmarkSamples; }
+        int benchmarkResamples() const override { return m_data.benchmarkResamples; }
+        double benchmarkConfidenceInterval() const override { return m_data.benchmarkConfidenceInterval; }
+        int benchmarkWarmupTime() const override { return m_data.benchmarkWarmupTime; }
+        double benchmarkThreshold() const override { return m_data.benchmarkThreshold; }
+        std::string const& journalFilename() const { return m_data.journalFilename; }
+        bool resumeJournal() const { return m_data.resumeJournal; }
+        std::string const& cacheFilename() const { return m_data.cacheFilename; }
+        bool noCache() const { return m_data.noCache; }
+        std::string const& impactMapFilename() const { return m_data.impactMapFilename; }
+        bool recordImpact() const { return m_data.recordImpact; }
 
         TestSpec const& testSpec() const override { return m_testSpec; }
 
+        std::string const& historyFilename() const { return m_data.historyFilename; }
+        RunHistory const& history() const override { return m_history; }
+        RunHistory& history() { return m_history; }
+        bool recordsHistory() const override { return !m_data.historyFilename.empty(); }
+        TestImpactMap const& impactMap() const override { return m_impactMap; }
+        TestImpactMap& impactMap() { return m_impactMap; }
+        std::string const& benchmarkBaselineFilename() const { return m_data.benchmarkBaselineFilename; }
+        BenchmarkBaseline const& benchmarkBaseline() const override { return m_benchmarkBaseline; }
+        std::vector<std::string> const& sectionsToRun() const override { return m_data.sectionsToRun; }
+
         bool showHelp() const { return m_data.showHelp; }
         bool showInvisibles() const override { return m_data.showInvisibles; }
 
@@ -151,10 +281,27 @@ namespace Catch {
             else
                 return new FileStream( m_data.outputFilename );
         }
+        // One path per line
+        static std::vector<std::string> readChangedFiles( std::string const& filename ) {
+            std::ifstream f( filename.c_str() );
+            if( !f )
+                throw std::domain_error( "Unable to read the changed files from: " + filename );
+            std::vector<std::string> files;
+            std::string line;
+            while( std::getline( f, line ) ) {
+                line = trim( line );
+                if( !line.empty() )
+                    files.push_back( line );
+            }
+            return files;
+        }
         ConfigData m_data;
 
         std::unique_ptr<IStream const> m_stream;
         TestSpec m_testSpec;
+        RunHistory m_history;
+        TestImpactMap m_impactMap;
+        BenchmarkBaseline m_benchmarkBaseline; // To compare with
     };
 
 } // end namespace Catch
@@ -46,6 +46,8 @@ namespace Catch {
     IContext& getCurrentContext();
     IMutableContext& getCurrentMutableContext();
     void cleanUpContext();
+    // The calling thread stops sharing the process's context, until cleanUpContext()
+    void createThreadContext();
     Stream createStream( std::string const& streamName );
 
 }
@@ -55,6 +55,7 @@ namespace Catch {
         }
 
         friend IMutableContext& getCurrentMutableContext();
+        friend void createThreadContext();
 
     private:
         IGeneratorsForTest* findGeneratorsForCurrentTest() {
@@ -86,10 +87,16 @@ namespace Catch {
 		std::vector<IGeneratorsForTest*> createdGenerators;
     };
 
+    // One for the whole process, so that any thread - one a test case
+    // started, say - reports to the run it belongs to. Threads running
+    // [parallel] test cases have one of their own instead
     namespace {
         Context* currentContext = CATCH_NULL;
+        thread_local Context* threadContext = CATCH_NULL;
     }
     IMutableContext& getCurrentMutableContext() {
+        if( threadContext )
+            return *threadContext;
         if( !currentContext )
             currentContext = new Context();
         return *currentContext;
@@ -98,9 +105,21 @@ namespace Catch {
         return getCurrentMutableContext();
     }
 
+    void createThreadContext() {
+        if( !threadContext )
+            threadContext = new Context();
+    }
+
+    // That of the calling thread, if it has one of its own
     void cleanUpContext() {
-        delete currentContext;
-        currentContext = CATCH_NULL;
+        if( threadContext ) {
+            delete threadContext;
+            threadContext = CATCH_NULL;
+        }
+        else {
+            delete currentContext;
+            currentContext = CATCH_NULL;
+        }
     }
 }
 
@@ -0,0 +1,195 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_CPU_PINNING_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_CPU_PINNING_HPP_INCLUDED
+
+#include "catch_interfaces_reporter.h"
+#include "catch_common.h"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__linux__)
+#define CATCH_INTERNAL_CPU_PINNING
+#include <sched.h>
+#endif
+
+namespace Catch {
+
+    // A list of CPU numbers and ranges, as in "0-3,8,10-11"
+    inline std::vector<int> parseCpuList( std::string const& list ) {
+        std::vector<int> cpus;
+        std::istringstream iss( list );
+        std::string part;
+        while( std::getline( iss, part, ',' ) ) {
+            part = trim( part );
+            if( part.empty() )
+                continue;
+            std::istringstream range( part );
+            int first, last;
+            char dash = 0;
+            if( !( range >> first ) || first < 0 )
+                throw std::runtime_error( "Unrecognised CPU list: '" + list + "'" );
+            last = first;
+            if( range >> dash && ( dash != '-' || !( range >> last ) || last < first ) )
+                throw std::runtime_error( "Unrecognised CPU list: '" + list + "'" );
+            for( int cpu = first; cpu <= last; ++cpu )
+                cpus.push_back( cpu );
+        }
+        if( cpus.empty() )
+            throw std::runtime_error( "Unrecognised CPU list: '" + list + "'" );
+        return cpus;
+    }
+
+    // Pins the test process to a CPU (--pin and --cpus) for as long as it
+    // lives, and hands out CPUs round-robin to each process forked from it,
+    // starting with the CPU after its own. The CPUs are those given, or else
+    // all those the process may run on, taken one NUMA node after the other so
+    // that neighbouring processes share a node. Each pinned process keeps to
+    // its own CPU, and so - as memory is allocated from the node of the CPU
+    // that first touches it - to its own node's memory.
+    // The affinity the process had before is restored at the end
+    class CpuPinning : NonCopyable {
+    public:
+        CpuPinning( std::vector<int> const& cpus ) : m_next( 0 ), m_previous( active() ) {
+#ifdef CATCH_INTERNAL_CPU_PINNING
+            if( sched_getaffinity( 0, sizeof( m_originalMask ), &m_originalMask ) != 0 )
+                throw std::domain_error( "Unable to tell which CPUs this process may run on" );
+            std::vector<int> allowed;
+            for( int cpu = 0; cpu < CPU_SETSIZE; ++cpu )
+                if( CPU_ISSET( cpu, &m_originalMask ) )
+                    allowed.push_back( cpu );
+            std::vector<int> chosen = cpus.empty() ? allowed : cpus;
+            for( std::vector<int>::const_iterator it = chosen.begin(), itEnd = chosen.end(); it != itEnd; ++it ) {
+                if( std::find( allowed.begin(), allowed.end(), *it ) == allowed.end() ) {
+                    std::ostringstream oss;
+                    oss << "CPU " << *it << " is not one this process may run on";
+                    throw std::domain_error( oss.str() );
+                }
+            }
+            std::map<int, int> nodes = numaNodes();
+            std::set<int> seen;
+            for( std::vector<int>::const_iterator it = chosen.begin(), itEnd = chosen.end(); it != itEnd; ++it ) {
+                if( !seen.insert( *it ).second )
+                    continue;
+                std::map<int, int>::const_iterator node = nodes.find( *it );
+                CpuPlacement placement;
+                placement.cpu = *it;
+                placement.numaNode = node != nodes.end() ? node->second : -1;
+                m_placements.push_back( placement );
+            }
+            std::stable_sort( m_placements.begin(), m_placements.end(), OnEarlierNode() );
+            if( !pin( m_placements[0] ) ) {
+                std::ostringstream oss;
+                oss << "Unable to pin the test process to CPU " << m_placements[0].cpu;
+                throw std::domain_error( oss.str() );
+            }
+            m_next = 1 % m_placements.size();
+            activeInstance() = this;
+#else
+            (void)cpus;
+            throw std::domain_error( "Pinning tests to CPUs is not supported on this platform" );
+#endif
+        }
+        ~CpuPinning() {
+#ifdef CATCH_INTERNAL_CPU_PINNING
+            sched_setaffinity( 0, sizeof( m_originalMask ), &m_originalMask );
+#endif
+            activeInstance() = m_previous;
+        }
+
+        // The innermost pinning still alive, if any - also in forked processes
+        static CpuPinning* active() {
+            return activeInstance();
+        }
+
+        // To be called before forking, for the forked process to pin itself to
+        CpuPlacement nextForChild() {
+            CpuPlacement placement = m_placements[m_next];
+            m_next = ( m_next + 1 ) % m_placements.size();
+            return placement;
+        }
+
+        // A forked process that cannot be pinned carries on where it is
+        static bool pin( CpuPlacement const& placement ) {
+#ifdef CATCH_INTERNAL_CPU_PINNING
+            cpu_set_t mask;
+            CPU_ZERO( &mask );
+            CPU_SET( placement.cpu, &mask );
+            return sched_setaffinity( 0, sizeof( mask ), &mask ) == 0;
+#else
+            (void)placement;
+            return false;
+#endif
+        }
+
+        // Where this process is running at the moment
+        static CpuPlacement current() {
+            CpuPlacement placement;
+#ifdef CATCH_INTERNAL_CPU_PINNING
+            placement.cpu = sched_getcpu();
+            if( placement.cpu >= 0 ) {
+                std::map<int, int> nodes = numaNodes();
+                std::map<int, int>::const_iterator node = nodes.find( placement.cpu );
+                if( node != nodes.end() )
+                    placement.numaNode = node->second;
+            }
+#endif
+            return placement;
+        }
+
+    private:
+        struct OnEarlierNode {
+            bool operator() ( CpuPlacement const& a, CpuPlacement const& b ) const { return a.numaNode < b.numaNode; }
+        };
+
+        static CpuPinning*& activeInstance() {
+            static CpuPinning* instance = CATCH_NULL;
+            return instance;
+        }
+
+        // The node of each CPU, from sysfs. Empty where there is no NUMA information
+        static std::map<int, int> numaNodes() {
+            std::map<int, int> nodes;
+            try {
+                std::vector<int> online = parseCpuList( readLine( "/sys/devices/system/node/online" ) ); // Same format
+                for( std::vector<int>::const_iterator node = online.begin(), nodeEnd = online.end(); node != nodeEnd; ++node ) {
+                    std::ostringstream path;
+                    path << "/sys/devices/system/node/node" << *node << "/cpulist";
+                    std::string list = readLine( path.str() );
+                    if( trim( list ).empty() )
+                        continue; // A node with memory but no CPUs
+                    std::vector<int> cpus = parseCpuList( list );
+                    for( std::vector<int>::const_iterator it = cpus.begin(), itEnd = cpus.end(); it != itEnd; ++it )
+                        nodes[*it] = *node;
+                }
+            }
+            catch( std::runtime_error& ) {} // What could be read is still right
+            return nodes;
+        }
+        static std::string readLine( std::string const& filename ) {
+            std::ifstream f( filename.c_str() );
+            std::string line;
+            std::getline( f, line );
+            return line;
+        }
+
+        std::vector<CpuPlacement> m_placements;
+        std::size_t m_next;
+        CpuPinning* m_previous;
+#ifdef CATCH_INTERNAL_CPU_PINNING
+        cpu_set_t m_originalMask;
+#endif
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_CPU_PINNING_HPP_INCLUDED
@@ -1,14 +1,49 @@
 #pragma once
 
+#include <atomic>
+#include <map>
+
 // Addition to CATCH: ExpectingThrows is a class to inhibit Debugs() warnings / errors in unit tests
 
 namespace Catch {
+    // Whether the calling thread counts apart from the rest of the process, as those running [parallel] test cases do
+    inline bool& countsExpectationsPerThread() {
+        static thread_local bool perThread = false;
+        return perThread;
+    }
+
+    // A count shared by all the threads of the process, so that what the code under test does on
+    // threads of its own is seen by the test case, except on threads counting apart
+    template<typename T>
+    class ExpectationCount
+    {
+    public:
+        ExpectationCount() : processCount(0) {}
+        operator T() const { return count(); }
+        ExpectationCount& operator=(T value) { count() = value; return *this; }
+        T operator++() { return ++count(); }
+        T operator++(int) { return count()++; }
+        T operator--() { return --count(); }
+        T operator--(int) { return count()--; }
+        ExpectationCount& operator+=(T value) { count() += value; return *this; }
+        ExpectationCount& operator|=(T value) { count() |= value; return *this; }
+        ExpectationCount& operator&=(T value) { count() &= value; return *this; }
+    private:
+        std::atomic<T>& count() const {
+            if(!countsExpectationsPerThread())
+                return processCount;
+            static thread_local std::map<ExpectationCount const*, std::atomic<T> > threadCounts;
+            return threadCounts[this];
+        }
+        mutable std::atomic<T> processCount;
+    };
+
     class ExpectingThrows
     {
     public:
         ExpectingThrows() { counter++; }
         ~ExpectingThrows() { counter--; }
-        static int counter;
+        static ExpectationCount<int> counter;
     };
     class ExpectsDebugsError
     {
@@ -29,8 +64,8 @@ namespace Catch {
             INTERNAL_CATCH_TEST(errorCnt <= maxErrorCnt, Catch::ResultDisposition::ContinueOnFailure, "CHECK");
             capturingMask &= ~(1 << (int)severity);
         }
-        static U32 capturingMask;
-        static U16 counters[DebugSeveritiesCount];
+        static ExpectationCount<U32> capturingMask;
+        static ExpectationCount<U16> counters[DebugSeveritiesCount];
     private:
         DebugSeverity severity;
         U32 minErrorCnt;
@@ -43,6 +43,37 @@ private:
     T m_to;
 };
 
+// From one value up to another, multiplying by the factor at each step
+template<typename T>
+class GeometricGenerator : public IGenerator<T> {
+public:
+    GeometricGenerator( T from, T to, T factor ) : m_from( from ), m_factor( factor ), m_size( 0 ) {
+        // Stops before a multiplication would go past to, so as never to overflow T
+        for( T value = from; value <= to; value *= factor ) {
+            ++m_size;
+            if( !( value > 0 ) || !( factor > 1 ) || value > to / factor )
+                break;
+        }
+    }
+
+    virtual T getValue( std::size_t index ) const {
+        T value = m_from;
+        for( std::size_t i = 0; i < index; ++i )
+            value *= m_factor;
+        return value;
+    }
+
+    virtual std::size_t size() const {
+        return m_size;
+    }
+
+private:
+
+    T m_from;
+    T m_factor;
+    std::size_t m_size;
+};
+
 template<typename T>
 class ValuesGenerator : public IGenerator<T> {
 public:
@@ -87,8 +118,11 @@ public:
     }
 
     operator T () const {
-        size_t overallIndex = getCurrentContext().getGeneratorIndex( m_fileInfo, m_totalSize );
+        return getValue( getCurrentContext().getGeneratorIndex( m_fileInfo, m_totalSize ) );
+    }
 
+    // All the values can also be gone through at once, as BENCHMARK_RANGE does
+    T getValue( size_t overallIndex ) const {
         typename std::vector<const IGenerator<T>*>::const_iterator it = m_composed.begin();
         typename std::vector<const IGenerator<T>*>::const_iterator itEnd = m_composed.end();
         for( size_t index = 0; it != itEnd; ++it )
@@ -104,6 +138,10 @@ public:
         return T(); // Suppress spurious "not all control paths return a value" warning in Visual Studio - if you know how to fix this please do so
     }
 
+    size_t size() const {
+        return m_totalSize;
+    }
+
     void add( const IGenerator<T>* generator ) {
         m_totalSize += generator->size();
         m_composed.push_back( generator );
@@ -143,6 +181,13 @@ namespace Generators
         return generators;
     }
 
+    template<typename T>
+    CompositeGenerator<T> geometric( T from, T to, T factor = 2 ) {
+        CompositeGenerator<T> generators;
+        generators.add( new GeometricGenerator<T>( from, to, factor ) );
+        return generators;
+    }
+
     template<typename T>
     CompositeGenerator<T> values( T val1, T val2 ) {
         CompositeGenerator<T> generators;
@@ -70,6 +70,10 @@ namespace Catch {
     TestCaseStats::~TestCaseStats() {}
     TestGroupStats::~TestGroupStats() {}
     TestRunStats::~TestRunStats() {}
+    BenchmarkStats::~BenchmarkStats() {}
+    BenchmarkComparisonStats::~BenchmarkComparisonStats() {}
+    BenchmarkComplexityStats::~BenchmarkComplexityStats() {}
+    BenchmarkScalingStats::~BenchmarkScalingStats() {}
     CumulativeReporterBase::SectionNode::~SectionNode() {}
     CumulativeReporterBase::~CumulativeReporterBase() {}
 
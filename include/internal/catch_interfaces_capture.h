@@ -22,6 +22,10 @@ namespace Catch {
     struct MessageInfo;
     class ScopedMessageBuilder;
     struct Counts;
+    struct BenchmarkStats;
+    struct BenchmarkComparisonStats;
+    struct BenchmarkComplexityStats;
+    struct BenchmarkScalingStats;
 
     struct IResultCapture {
 
@@ -32,11 +36,17 @@ namespace Catch {
                                         Counts& assertions ) = 0;
         virtual void sectionEnded( SectionEndInfo const& endInfo ) = 0;
         virtual void sectionEndedEarly( SectionEndInfo const& endInfo ) = 0;
+        virtual void benchmarkEnded( BenchmarkStats const& stats ) = 0;
+        virtual void benchmarkCompared( BenchmarkComparisonStats const& stats ) = 0;
+        virtual void benchmarkFitted( BenchmarkComplexityStats const& stats ) = 0;
+        virtual void benchmarkScaled( BenchmarkScalingStats const& stats ) = 0;
         virtual void pushScopedMessage( MessageInfo const& message ) = 0;
         virtual void popScopedMessage( MessageInfo const& message ) = 0;
 
         virtual std::string getCurrentTestName() const = 0;
         virtual const AssertionResult* getLastResult() const = 0;
+        // Of the active test case's last BENCHMARK_RANGE, if any
+        virtual const BenchmarkComplexityStats* getLastComplexity() const = 0;
 
         virtual void handleFatalErrorCondition( std::string const& message ) = 0;
     };
@@ -35,7 +35,9 @@ namespace Catch {
     struct RunTests { enum InWhatOrder {
         InDeclarationOrder,
         InLexicographicalOrder,
-        InRandomOrder
+        InRandomOrder,
+        InDurationOrder,
+        InFailuresFirstOrder
     }; };
     struct UseColour { enum YesOrNo {
         Auto,
@@ -44,6 +46,9 @@ namespace Catch {
     }; };    
 
     class TestSpec;
+    class RunHistory;
+    class TestImpactMap;
+    class BenchmarkBaseline;
 
     struct IConfig : IShared {
 
@@ -56,9 +61,26 @@ namespace Catch {
         virtual bool shouldDebugBreak() const = 0;
         virtual bool warnAboutMissingAssertions() const = 0;
         virtual int abortAfter() const = 0;
+        virtual int testTimeout() const = 0;
+        virtual int checkpointWorkers() const = 0;
+        virtual int memoryBudget() const = 0;
+        virtual int shardCount() const = 0;
+        virtual int shardIndex() const = 0;
+        virtual bool balanceShards() const = 0;
+        virtual int benchmarkSamples() const = 0;
+        virtual int benchmarkResamples() const = 0;
+        virtual double benchmarkConfidenceInterval() const = 0;
+        virtual int benchmarkWarmupTime() const = 0;
+        virtual double benchmarkThreshold() const = 0;
+        virtual bool rerunFailed() const = 0;
         virtual bool showInvisibles() const = 0;
         virtual ShowDurations::OrNot showDurations() const = 0;
         virtual TestSpec const& testSpec() const = 0;
+        virtual RunHistory const& history() const = 0;
+        virtual bool recordsHistory() const = 0; // To a --history file
+        virtual TestImpactMap const& impactMap() const = 0;
+        virtual BenchmarkBaseline const& benchmarkBaseline() const = 0;
+        virtual std::vector<std::string> const& sectionsToRun() const = 0;
         virtual RunTests::InWhatOrder runOrder() const = 0;
         virtual unsigned int rngSeed() const = 0;
         virtual UseColour::YesOrNo useColour() const = 0;
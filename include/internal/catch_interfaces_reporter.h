@@ -17,6 +17,7 @@
 #include "catch_assertionresult.h"
 #include "catch_message.h"
 #include "catch_option.hpp"
+#include "catch_benchmark_stats.h"
 
 #include <string>
 #include <ostream>
@@ -137,6 +138,30 @@ namespace Catch
         bool missingAssertions;
     };
 
+    // What came of running a failed test case again (--retry-failed)
+    struct RetryOutcome { enum Kind {
+        NotRetried,
+        DeterministicFailure,   // It failed every time
+        Flaky,                  // It passed with the seed it failed with
+        PassedOnRetry           // It only passed with another seed
+    }; };
+
+    inline std::string retryOutcomeName( RetryOutcome::Kind outcome ) {
+        switch( outcome ) {
+            case RetryOutcome::DeterministicFailure: return "deterministic failure";
+            case RetryOutcome::Flaky: return "flaky";
+            case RetryOutcome::PassedOnRetry: return "passed on retry";
+            default: return "";
+        }
+    }
+
+    // Where a pinned test case ran (--pin)
+    struct CpuPlacement {
+        CpuPlacement() : cpu( -1 ), numaNode( -1 ) {}
+        int cpu;
+        int numaNode; // -1 if not known
+    };
+
     struct TestCaseStats {
         TestCaseStats(  TestCaseInfo const& _testInfo,
                         Totals const& _totals,
@@ -147,7 +172,10 @@ namespace Catch
             totals( _totals ),
             stdOut( _stdOut ),
             stdErr( _stdErr ),
-            aborting( _aborting )
+            aborting( _aborting ),
+            retryOutcome( RetryOutcome::NotRetried ),
+            retries( 0 ),
+            peakMemoryKb( 0 )
         {}
         virtual ~TestCaseStats();
 
@@ -163,6 +191,10 @@ namespace Catch
         std::string stdOut;
         std::string stdErr;
         bool aborting;
+        RetryOutcome::Kind retryOutcome;
+        std::size_t retries;
+        std::size_t peakMemoryKb; // Resident, while the test case ran. 0 if not known
+        CpuPlacement placement; // Only known when pinned
     };
 
     struct TestGroupStats {
@@ -242,6 +274,16 @@ namespace Catch
         // The return value indicates if the messages buffer should be cleared:
         virtual bool assertionEnded( AssertionStats const& assertionStats ) = 0;
 
+        // Benchmarks are ignored by a reporter that does not override these.
+        // Each BENCHMARK, once it has been run and its samples analysed
+        virtual void benchmarkEnded( BenchmarkStats const& ) {}
+        // Each BENCHMARK_COMPARE, after both its variants have ended
+        virtual void benchmarkCompared( BenchmarkComparisonStats const& ) {}
+        // Each BENCHMARK_RANGE, after the benchmarks of all its sizes have ended
+        virtual void benchmarkFitted( BenchmarkComplexityStats const& ) {}
+        // Each BENCHMARK_THREADS, once run on all its thread counts
+        virtual void benchmarkScaled( BenchmarkScalingStats const& ) {}
+
         virtual void sectionEnded( SectionStats const& sectionStats ) = 0;
         virtual void testCaseEnded( TestCaseStats const& testCaseStats ) = 0;
         virtual void testGroupEnded( TestGroupStats const& testGroupStats ) = 0;
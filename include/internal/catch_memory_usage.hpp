@@ -0,0 +1,91 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_MEMORY_USAGE_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_MEMORY_USAGE_HPP_INCLUDED
+
+#include "catch_platform.h"
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstddef>
+
+#ifndef CATCH_PLATFORM_WINDOWS
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+namespace Catch {
+
+    namespace Detail {
+        // A field of /proc/self/status, such as "VmHWM:", in kilobytes. 0 where there is none
+        inline std::size_t procStatusKb( std::string const& field ) {
+            std::ifstream status( "/proc/self/status" );
+            std::string line;
+            while( std::getline( status, line ) ) {
+                if( line.compare( 0, field.size(), field ) == 0 ) {
+                    std::istringstream iss( line.substr( field.size() ) );
+                    std::size_t kb;
+                    if( iss >> kb )
+                        return kb;
+                }
+            }
+            return 0;
+        }
+    }
+
+    // The peak resident memory of this process, in kilobytes, as measured
+    // since the last resetPeakMemory() where the system allows it to be reset
+    // (Linux), or else since the process started. 0 if not known
+    inline std::size_t peakMemoryKb() {
+#ifdef CATCH_PLATFORM_WINDOWS
+        return 0;
+#else
+        if( std::size_t kb = Detail::procStatusKb( "VmHWM:" ) )
+            return kb;
+        struct rusage usage;
+        if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+            return 0;
+#  ifdef CATCH_PLATFORM_MAC
+        return static_cast<std::size_t>( usage.ru_maxrss ) / 1024; // In bytes there
+#  else
+        return static_cast<std::size_t>( usage.ru_maxrss );
+#  endif
+#endif
+    }
+
+    // Brings the peak back down to what is resident now, so the next peak
+    // measured is that of whatever runs from here on
+    inline void resetPeakMemory() {
+#ifndef CATCH_PLATFORM_WINDOWS
+        std::ofstream clearRefs( "/proc/self/clear_refs" );
+        if( clearRefs )
+            clearRefs << "5";
+#endif
+    }
+
+    // Allows this process this much more address space than it has mapped
+    // now (where that is known). Past that, allocations fail - with
+    // std::bad_alloc, which fails the test case - rather than have the system
+    // run out of memory
+    inline bool limitAddressSpaceGrowth( std::size_t kb ) {
+#ifdef CATCH_PLATFORM_WINDOWS
+        (void)kb;
+        return false;
+#else
+        struct rlimit limit;
+        if( getrlimit( RLIMIT_AS, &limit ) != 0 )
+            return false;
+        rlim_t wanted = static_cast<rlim_t>( Detail::procStatusKb( "VmSize:" ) + kb ) * 1024;
+        if( limit.rlim_max != RLIM_INFINITY && wanted > limit.rlim_max )
+            wanted = limit.rlim_max;
+        limit.rlim_cur = wanted;
+        return setrlimit( RLIMIT_AS, &limit ) == 0;
+#endif
+    }
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_MEMORY_USAGE_HPP_INCLUDED
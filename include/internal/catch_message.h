@@ -9,6 +9,7 @@
 #define TWOBLUECUBES_CATCH_MESSAGE_H_INCLUDED
 
 #include <string>
+#include <atomic>
 #include "catch_result_type.h"
 #include "catch_common.h"
 
@@ -32,7 +33,7 @@ namespace Catch {
             return sequence < other.sequence;
         }
     private:
-        static unsigned int globalCount;
+        static std::atomic<unsigned int> globalCount;
     };
 
     struct MessageBuilder {
@@ -21,8 +21,8 @@ namespace Catch {
         sequence( ++globalCount )
     {}
 
-    // This may need protecting if threading support is added
-    unsigned int MessageInfo::globalCount = 0;
+    // Atomic, as messages are also built on the threads running [parallel] test cases
+    std::atomic<unsigned int> MessageInfo::globalCount( 0 );
 
 
     ////////////////////////////////////////////////////////////////////////////
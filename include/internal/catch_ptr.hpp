@@ -10,6 +10,8 @@
 
 #include "catch_common.h"
 
+#include <atomic>
+
 #ifdef __clang__
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wpadded"
@@ -68,10 +70,19 @@ namespace Catch {
         virtual void release() const = 0;
     };
 
+    // How many shared objects of any type are alive, so that a leak can be seen
+    inline std::atomic<long>& liveSharedObjects() {
+        static std::atomic<long> count( 0 );
+        return count;
+    }
+
+    // The count is atomic, as objects such as the config are shared between
+    // the threads running [parallel] test cases
     template<typename T = IShared>
     struct SharedImpl : T {
 
-        SharedImpl() : m_rc( 0 ){}
+        SharedImpl() : m_rc( 0 ){ ++liveSharedObjects(); }
+        virtual ~SharedImpl() { --liveSharedObjects(); }
 
         virtual void addRef() const {
             ++m_rc;
@@ -81,7 +92,7 @@ namespace Catch {
                 delete this;
         }
 
-        mutable unsigned int m_rc;
+        mutable std::atomic<unsigned int> m_rc;
     };
 
 } // end namespace Catch
@@ -0,0 +1,145 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_REPEAT_STATISTICS_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_REPEAT_STATISTICS_HPP_INCLUDED
+
+#include "catch_interfaces_reporter.h"
+
+#include <map>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <stdint.h>
+
+namespace Catch {
+
+    // Listens to the reporter events of repeated test cases (--repeat and
+    // --until-fail) to tell, for each of them, how often it passed, with which
+    // seeds it failed and how long it took. The seed of each repetition is set
+    // before it is run (or replayed from a worker)
+    class RepeatStatistics : public SharedImpl<IStreamingReporter> {
+    public:
+        enum { FailingSeedsShown = 10 };
+
+        struct Entry {
+            Entry() : runs( 0 ), passes( 0 ) {}
+
+            std::size_t runs;
+            std::size_t passes;
+            std::vector<unsigned int> failingSeeds;
+            std::vector<double> durations;
+        };
+
+        RepeatStatistics() : m_seed( 0 ), m_sectionDepth( 0 ), m_testCaseDuration( 0 ) {}
+
+        // The first repetition uses the configured seed, so it is the same as
+        // an ordinary run. The others are derived from it, so a whole run can be
+        // repeated, and each failing repetition can be run again on its own
+        // with --rng-seed
+        static unsigned int repetitionSeed( unsigned int baseSeed, std::size_t repetition ) {
+            if( repetition == 0 )
+                return baseSeed;
+            uint64_t mixed = baseSeed + repetition * 0x9E3779B97F4A7C15ULL;
+            mixed = ( mixed ^ ( mixed >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+            mixed = ( mixed ^ ( mixed >> 27 ) ) * 0x94D049BB133111EBULL;
+            unsigned int seed = static_cast<unsigned int>( mixed ^ ( mixed >> 31 ) );
+            return seed != 0 ? seed : 1; // 0 asks for a seed from the time
+        }
+
+        void repetitionStarting( unsigned int seed ) {
+            m_seed = seed;
+        }
+
+        Entry const* find( std::string const& testName ) const {
+            std::map<std::string, Entry>::const_iterator it = m_entries.find( testName );
+            return it != m_entries.end() ? &it->second : CATCH_NULL;
+        }
+
+        void print( std::ostream& os ) const {
+            if( m_entries.empty() )
+                return;
+            std::ios_base::fmtflags flags = os.flags();
+            std::streamsize precision = os.precision();
+            os << "\nRepeated test cases:\n";
+            for( std::map<std::string, Entry>::const_iterator it = m_entries.begin(), itEnd = m_entries.end(); it != itEnd; ++it ) {
+                Entry const& entry = it->second;
+                os << "  " << it->first << "\n"
+                   << "    passed " << entry.passes << " of " << entry.runs << " ("
+                   << std::fixed << std::setprecision( 2 ) << 100.0 * static_cast<double>( entry.passes ) / static_cast<double>( entry.runs ) << "%)\n";
+                if( !entry.failingSeeds.empty() ) {
+                    os << "    failed with seeds:";
+                    for( std::size_t i = 0; i < entry.failingSeeds.size() && i < FailingSeedsShown; ++i )
+                        os << ' ' << entry.failingSeeds[i];
+                    if( entry.failingSeeds.size() > FailingSeedsShown )
+                        os << " and " << entry.failingSeeds.size() - FailingSeedsShown << " more";
+                    os << "\n";
+                }
+                std::vector<double> durations = entry.durations;
+                std::sort( durations.begin(), durations.end() );
+                os << std::setprecision( 6 )
+                   << "    seconds: min " << durations.front()
+                   << ", median " << percentile( durations, 50 )
+                   << ", 90% " << percentile( durations, 90 )
+                   << ", 99% " << percentile( durations, 99 )
+                   << ", max " << durations.back() << "\n";
+                os.unsetf( std::ios_base::floatfield );
+            }
+            os.flags( flags );
+            os.precision( precision );
+            os.flush();
+        }
+
+        virtual ReporterPreferences getPreferences() const CATCH_OVERRIDE {
+            return ReporterPreferences();
+        }
+
+        virtual void noMatchingTestCases( std::string const& ) CATCH_OVERRIDE {}
+        virtual void testRunStarting( TestRunInfo const& ) CATCH_OVERRIDE {}
+        virtual void testGroupStarting( GroupInfo const& ) CATCH_OVERRIDE {}
+        virtual void testGroupEnded( TestGroupStats const& ) CATCH_OVERRIDE {}
+        virtual void testRunEnded( TestRunStats const& ) CATCH_OVERRIDE {}
+        virtual void skipTest( TestCaseInfo const& ) CATCH_OVERRIDE {}
+        virtual void assertionStarting( AssertionInfo const& ) CATCH_OVERRIDE {}
+        virtual bool assertionEnded( AssertionStats const& ) CATCH_OVERRIDE { return false; }
+
+        virtual void testCaseStarting( TestCaseInfo const& ) CATCH_OVERRIDE {
+            m_sectionDepth = 0;
+            m_testCaseDuration = 0;
+        }
+        virtual void sectionStarting( SectionInfo const& ) CATCH_OVERRIDE {
+            ++m_sectionDepth;
+        }
+        virtual void sectionEnded( SectionStats const& sectionStats ) CATCH_OVERRIDE {
+            if( m_sectionDepth > 0 && --m_sectionDepth == 0 )
+                m_testCaseDuration += sectionStats.durationInSeconds;
+        }
+        virtual void testCaseEnded( TestCaseStats const& testCaseStats ) CATCH_OVERRIDE {
+            Entry& entry = m_entries[testCaseStats.testInfo.name];
+            entry.runs++;
+            if( testCaseStats.totals.testCases.failed == 0 )
+                entry.passes++;
+            else
+                entry.failingSeeds.push_back( m_seed );
+            entry.durations.push_back( m_testCaseDuration );
+        }
+
+    private:
+        // Nearest rank, of sorted values
+        static double percentile( std::vector<double> const& sorted, std::size_t percent ) {
+            std::size_t rank = ( sorted.size() * percent + 99 ) / 100;
+            return sorted[rank > 0 ? rank - 1 : 0];
+        }
+
+        std::map<std::string, Entry> m_entries;
+        unsigned int m_seed;
+        std::size_t m_sectionDepth;
+        double m_testCaseDuration;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_REPEAT_STATISTICS_HPP_INCLUDED
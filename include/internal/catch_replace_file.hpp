@@ -0,0 +1,56 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_REPLACE_FILE_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_REPLACE_FILE_HPP_INCLUDED
+
+#include "catch_platform.h"
+
+#include <string>
+#include <cstdio>
+
+#ifdef CATCH_PLATFORM_WINDOWS
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Catch {
+
+    // Hands what was written to the system, then waits for it to be on the disk
+    inline bool syncFile( std::FILE* f ) {
+        if( std::fflush( f ) != 0 )
+            return false;
+#ifdef CATCH_PLATFORM_WINDOWS
+        return _commit( _fileno( f ) ) == 0;
+#else
+        return fsync( fileno( f ) ) == 0;
+#endif
+    }
+
+    // Writes the content to a temporary file, then renames it over the file,
+    // so a run that dies part way leaves either the old file or the new one whole
+    inline bool replaceFile( std::string const& filename, std::string const& content ) {
+        std::string tempFilename = filename + ".tmp";
+        std::FILE* f = std::fopen( tempFilename.c_str(), "wb" );
+        if( !f )
+            return false;
+        bool written = std::fwrite( content.data(), 1, content.size(), f ) == content.size() && syncFile( f );
+        if( std::fclose( f ) != 0 || !written ) {
+            std::remove( tempFilename.c_str() );
+            return false;
+        }
+        if( std::rename( tempFilename.c_str(), filename.c_str() ) == 0 )
+            return true;
+        // Some platforms (Windows) cannot rename over an existing file
+        std::remove( filename.c_str() );
+        if( std::rename( tempFilename.c_str(), filename.c_str() ) == 0 )
+            return true;
+        std::remove( tempFilename.c_str() );
+        return false;
+    }
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_REPLACE_FILE_HPP_INCLUDED
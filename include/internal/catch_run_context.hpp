@@ -21,10 +21,23 @@
 #include "catch_timer.h"
 #include "catch_result_builder.h"
 #include "catch_fatal_condition.hpp"
+#include "catch_test_event_stream.hpp"
+#include "catch_test_watchdog.hpp"
+#include "catch_run_journal.hpp"
+#include "catch_test_impact_recorder.hpp"
+#include "catch_section_checkpoint.hpp"
+#include "catch_memory_usage.hpp"
+#include "catch_cpu_pinning.hpp"
+#include "catch_benchmark_baseline.hpp"
+#include "catch_benchmark_analysis.hpp"
 
 #include <set>
+#include <sstream>
+#include <iomanip>
 #include <string>
+#include <memory>
 #include <chrono>
+#include <mutex>
 #include "Utility/BaseThreadManager.h"
 #include "Debug/DebugManagerStdout.h"
 #include "Utility/BaseRaiiCleaner.h"
@@ -56,6 +69,20 @@ namespace Catch {
         std::string& m_targetString;
     };
 
+    // Lets go of a lock the calling thread holds, for as long as it is in scope
+    class ScopedUnlock : NonCopyable {
+    public:
+        explicit ScopedUnlock( std::recursive_mutex& mutex ) : m_mutex( mutex ) {
+            m_mutex.unlock();
+        }
+        ~ScopedUnlock() {
+            m_mutex.lock();
+        }
+
+    private:
+        std::recursive_mutex& m_mutex;
+    };
+
     ///////////////////////////////////////////////////////////////////////////
 
     class RunContext : public IResultCapture, public IRunner {
@@ -68,9 +95,18 @@ namespace Catch {
         explicit RunContext( Ptr<IConfig const> const& _config, Ptr<IStreamingReporter> const& reporter )
         :   m_runInfo( _config->name() ),
             m_context( getCurrentMutableContext() ),
+            m_previousConfig( m_context.getConfig() ),
+            m_previousRunner( m_context.getRunner() ),
+            m_previousResultCapture( m_context.getResultCapture() ),
             m_activeTestCase( CATCH_NULL ),
             m_config( _config ),
-            m_reporter( reporter )
+            m_journal( CATCH_NULL ),
+            m_impactRecorder( CATCH_NULL ),
+            m_rngSeed( 0 ),
+            m_sharesProcess( false ),
+            m_checkpointPending( false ),
+            m_reporter( reporter ),
+            m_watchdog( *this, *_config, m_reportMutex )
         {
             m_context.setRunner( this );
             m_context.setConfig( m_config );
@@ -80,6 +116,11 @@ namespace Catch {
 
         virtual ~RunContext() {
             m_reporter->testRunEnded( TestRunStats( m_runInfo, m_totals, aborting() ) );
+
+            // Hands back to the run this one was started from, if any
+            m_context.setRunner( m_previousRunner );
+            m_context.setConfig( m_previousConfig );
+            m_context.setResultCapture( m_previousResultCapture );
         }
 
         void testGroupStarting( std::string const& testSpec, std::size_t groupIndex, std::size_t groupsCount ) {
@@ -89,7 +130,33 @@ namespace Catch {
             m_reporter->testGroupEnded( TestGroupStats( GroupInfo( testSpec, groupIndex, groupsCount ), totals, aborting() ) );
         }
 
+        // Each test case run from now on is recorded in the journal
+        void useJournal( RunJournal& journal ) {
+            m_journal = &journal;
+        }
+
+        // Test cases run from now on are seeded with this, rather than the configured seed
+        void useRngSeed( unsigned int seed ) {
+            m_rngSeed = seed;
+        }
+
+        // Test cases run from now on share the process with others, run at the
+        // same time on other threads. What belongs to the whole process - the
+        // Alf singletons, threads and leak counts, the standard streams, signal
+        // handlers, the C library's rng and the peak memory - is left alone,
+        // and sections are not checkpointed, as that would fork
+        void shareProcess() {
+            m_sharesProcess = true;
+        }
+
+        // The source files each test case run from now on executes are recorded
+        void useImpactRecorder( ImpactRecorder& impactRecorder ) {
+            m_impactRecorder = &impactRecorder;
+        }
+
         Totals runTest( TestCase const& testCase ) {
+            // Only let go of while the test case's own code runs
+            std::unique_lock<std::recursive_mutex> reporting( m_reportMutex );
             Totals prevTotals = m_totals;
 
             std::string redirectedCout;
@@ -97,23 +164,43 @@ namespace Catch {
 
             TestCaseInfo testInfo = testCase.getTestCaseInfo();
 
+            if( m_journal )
+                m_journal->attempt( testInfo.name );
             m_reporter->testCaseStarting( testInfo );
 
             m_activeTestCase = &testCase;
+            m_lastComplexity.reset();
 
+            int timeout = testTimeout( testInfo );
+            if( timeout > 0 )
+                m_watchdog.arm( timeout );
+            if( m_impactRecorder )
+                m_impactRecorder->testStarting();
+            if( tracksPeakMemory() )
+                resetPeakMemory();
+            m_checkpointPending = !m_sharesProcess && CheckpointPasses::isSupported() && testInfo.lcaseTags.count( "checkpoint" ) > 0;
 
             do {
                 m_trackerContext.startRun();
                 do {
                     m_trackerContext.startCycle();
-                    m_testCaseTracker = &SectionTracker::acquire( m_trackerContext, testInfo.name );
+                    SectionTracker& testCaseTracker = SectionTracker::acquire( m_trackerContext, testInfo.name );
+                    testCaseTracker.selectPath( m_config->sectionsToRun() );
+                    m_testCaseTracker = &testCaseTracker;
                     runCurrentTest( redirectedCout, redirectedCerr );
+                    if( m_checkpointPasses ) // This process was forked to run the pass
+                        m_checkpointPasses->endPass( m_passSectionEntered, m_testCaseTracker->state() );
                 }
                 while( !m_testCaseTracker->isSuccessfullyCompleted() && !aborting() );
             }
             // !TBD: deprecated - this will be replaced by indexed trackers
             while( getCurrentContext().advanceGeneratorsForCurrentTest() && !aborting() );
 
+            if( m_impactRecorder )
+                m_impactRecorder->testEnded( testInfo.name );
+            if( timeout > 0 )
+                m_watchdog.disarm();
+
             Totals deltaTotals = m_totals.delta( prevTotals );
             if( testInfo.expectedToFail() && deltaTotals.testCases.passed > 0 ) {
                 deltaTotals.assertions.failed++;
@@ -121,20 +208,70 @@ namespace Catch {
                 deltaTotals.testCases.failed++;
             }
             m_totals.testCases += deltaTotals.testCases;
-            gUnitTestDatabase->addResultToDatabase(testInfo.name.c_str(), deltaTotals.testCases.allPassed());
-
-            m_reporter->testCaseEnded( TestCaseStats(   testInfo,
-                                                        deltaTotals,
-                                                        redirectedCout,
-                                                        redirectedCerr,
-                                                        aborting() ) );
+            if( !m_sharesProcess ) // Recorded as it is replayed
+                gUnitTestDatabase->addResultToDatabase(testInfo.name.c_str(), deltaTotals.testCases.allPassed());
+
+            TestCaseStats testCaseStats( testInfo,
+                                         deltaTotals,
+                                         redirectedCout,
+                                         redirectedCerr,
+                                         aborting() );
+            if( tracksPeakMemory() )
+                testCaseStats.peakMemoryKb = peakMemoryKb();
+            if( CpuPinning::active() )
+                testCaseStats.placement = CpuPinning::current();
+            m_reporter->testCaseEnded( testCaseStats );
 
             m_activeTestCase = CATCH_NULL;
             m_testCaseTracker = CATCH_NULL;
 
+            if( m_journal )
+                m_journal->record( testInfo.name, deltaTotals );
+            return deltaTotals;
+        }
+
+        // Reports a test case that was run elsewhere (e.g. in a worker process)
+        // from its recorded events, as if it had been run here
+        Totals replayTest( TestCase const& testCase,
+                           std::string const& events,
+                           std::string const& interruption,
+                           RetryOutcome::Kind retryOutcome = RetryOutcome::NotRetried,
+                           std::size_t retries = 0 ) {
+            TestCaseInfo testInfo = testCase.getTestCaseInfo();
+
+            m_reporter->testCaseStarting( testInfo );
+
+            TestEventReplayer replayer( *m_reporter, testInfo, m_totals );
+            replayer.setRetryOutcome( retryOutcome, retries );
+            replayer.replay( events );
+            bool interrupted = !replayer.testCaseEnded();
+            if( interrupted )
+                replayer.interrupt( interruption.empty() ? "Test case ended without reporting its results" : interruption );
+
+            Totals deltaTotals = replayer.testCaseTotals();
+            m_totals += deltaTotals;
+            // runTest() charges a passing, expected to fail, test with a failed
+            // assertion in its own totals but not in the run totals
+            if( !interrupted && testInfo.expectedToFail() && deltaTotals.testCases.failed > 0 )
+                m_totals.assertions.failed--;
+            gUnitTestDatabase->addResultToDatabase(testInfo.name.c_str(), deltaTotals.testCases.allPassed());
+            if( m_journal )
+                m_journal->record( testInfo.name, deltaTotals );
             return deltaTotals;
         }
 
+        // Counts a test case whose results are already known, without running
+        // it: one completed by an interrupted run being resumed, or one whose
+        // pass is cached. Reporters see it as skipped
+        Totals countKnownTest( TestCase const& testCase, Totals const& knownTotals ) {
+            TestCaseInfo testInfo = testCase.getTestCaseInfo();
+            m_reporter->skipTest( testInfo );
+            m_totals += knownTotals;
+            if( testInfo.expectedToFail() && knownTotals.testCases.failed > 0 )
+                m_totals.assertions.failed--;
+            return knownTotals;
+        }
+
         Ptr<IConfig const> config() const {
             return m_config;
         }
@@ -143,6 +280,7 @@ namespace Catch {
 
 
         virtual void assertionEnded( AssertionResult const& result ) override {
+            std::lock_guard<std::recursive_mutex> reporting( m_reportMutex );
             if( result.getResultType() == ResultWas::Ok ) {
                 m_totals.assertions.passed++;
             }
@@ -163,13 +301,22 @@ namespace Catch {
             Counts& assertions
         ) override
         {
+            if( m_checkpointPending && &m_trackerContext.currentTracker() == m_testCaseTracker ) {
+                m_checkpointPending = false;
+                runPassesFromCheckpoint();
+            }
+            std::lock_guard<std::recursive_mutex> reporting( m_reportMutex );
+
             std::ostringstream oss;
             oss << sectionInfo.name << "@" << sectionInfo.lineInfo;
 
             ITracker& sectionTracker = SectionTracker::acquire( m_trackerContext, oss.str() );
             if( !sectionTracker.isOpen() )
                 return false;
+            if( m_checkpointPasses && &sectionTracker.parent() == m_testCaseTracker )
+                m_passSectionEntered = sectionTracker.name();
             m_activeSections.push_back( &sectionTracker );
+            m_activeSectionInfos.push_back( sectionInfo );
 
             m_lastAssertionInfo.lineInfo = sectionInfo.lineInfo;
 
@@ -192,12 +339,14 @@ namespace Catch {
         }
 
         virtual void sectionEnded( SectionEndInfo const& endInfo ) {
+            std::lock_guard<std::recursive_mutex> reporting( m_reportMutex );
             Counts assertions = m_totals.assertions - endInfo.prevAssertions;
             bool missingAssertions = testForMissingAssertions( assertions );
 
             if( !m_activeSections.empty() ) {
                 m_activeSections.back()->close();
                 m_activeSections.pop_back();
+                m_activeSectionInfos.pop_back();
             }
 
             m_reporter->sectionEnded( SectionStats( endInfo.sectionInfo, assertions, endInfo.durationInSeconds, missingAssertions ) );
@@ -205,20 +354,45 @@ namespace Catch {
         }
 
         virtual void sectionEndedEarly( SectionEndInfo const& endInfo ) {
+            std::lock_guard<std::recursive_mutex> reporting( m_reportMutex );
             if( m_unfinishedSections.empty() )
                 m_activeSections.back()->fail();
             else
                 m_activeSections.back()->close();
             m_activeSections.pop_back();
+            m_activeSectionInfos.pop_back();
 
             m_unfinishedSections.push_back( endInfo );
         }
 
+        virtual void benchmarkCompared( BenchmarkComparisonStats const& stats ) {
+            std::lock_guard<std::recursive_mutex> reporting( m_reportMutex );
+            m_reporter->benchmarkCompared( stats );
+        }
+        virtual void benchmarkFitted( BenchmarkComplexityStats const& stats ) {
+            std::lock_guard<std::recursive_mutex> reporting( m_reportMutex );
+            m_reporter->benchmarkFitted( stats );
+            m_lastComplexity.reset( new BenchmarkComplexityStats( stats ) );
+        }
+        virtual void benchmarkScaled( BenchmarkScalingStats const& stats ) {
+            std::lock_guard<std::recursive_mutex> reporting( m_reportMutex );
+            m_reporter->benchmarkScaled( stats );
+        }
+        virtual void benchmarkEnded( BenchmarkStats const& stats ) {
+            std::lock_guard<std::recursive_mutex> reporting( m_reportMutex );
+            m_reporter->benchmarkEnded( stats );
+            if( m_activeTestCase )
+                if( std::vector<double> const* baseline = m_config->benchmarkBaseline().find( m_activeTestCase->getTestCaseInfo().name, stats.name ) )
+                    compareWithBaseline( stats, *baseline );
+        }
+
         virtual void pushScopedMessage( MessageInfo const& message ) {
+            std::lock_guard<std::recursive_mutex> reporting( m_reportMutex );
             m_messages.push_back( message );
         }
 
         virtual void popScopedMessage( MessageInfo const& message ) override {
+            std::lock_guard<std::recursive_mutex> reporting( m_reportMutex );
             m_messages.erase( std::remove( m_messages.begin(), m_messages.end(), message ), m_messages.end() );
         }
 
@@ -231,27 +405,44 @@ namespace Catch {
         virtual const AssertionResult* getLastResult() const override {
             return &m_lastResult;
         }
+        virtual const BenchmarkComplexityStats* getLastComplexity() const override {
+            return m_lastComplexity.get();
+        }
 
+        // Also called from the watchdog's thread, which has nothing of its
+        // own to report to: the run is only reached through this
         virtual void handleFatalErrorCondition( std::string const& message ) override {
-            ResultBuilder resultBuilder = makeUnexpectedResultBuilder();
-            resultBuilder.setResultType( ResultWas::FatalErrorCondition );
-            resultBuilder << message;
-            resultBuilder.captureExpression();
+            std::lock_guard<std::recursive_mutex> reporting( m_reportMutex );
+            AssertionResultData data;
+            data.resultType = ResultWas::FatalErrorCondition;
+            data.message = message;
+            assertionEnded( AssertionResult( m_lastAssertionInfo, data ) );
 
             handleUnfinishedSections();
 
+            Counts assertions;
+            assertions.failed = 1;
+
+            // The sections we were in will never end by themselves, but
+            // reporters expect every section they were told of to end
+            while( !m_activeSectionInfos.empty() ) {
+                SectionInfo sectionInfo = m_activeSectionInfos.back();
+                m_activeSections.pop_back();
+                m_activeSectionInfos.pop_back();
+                m_reporter->sectionEnded( SectionStats( sectionInfo, assertions, 0, false ) );
+            }
+
             // Recreate section for test case (as we will lose the one that was in scope)
             TestCaseInfo const& testCaseInfo = m_activeTestCase->getTestCaseInfo();
             SectionInfo testCaseSection( testCaseInfo.lineInfo, testCaseInfo.name, testCaseInfo.description );
 
-            Counts assertions;
-            assertions.failed = 1;
             SectionStats testCaseSectionStats( testCaseSection, assertions, 0, false );
             m_reporter->sectionEnded( testCaseSectionStats );
 
             TestCaseInfo testInfo = m_activeTestCase->getTestCaseInfo();
 
             Totals deltaTotals;
+            deltaTotals.assertions.failed = 1;
             deltaTotals.testCases.failed = 1;
             m_reporter->testCaseEnded( TestCaseStats(   testInfo,
                                                         deltaTotals,
@@ -271,40 +462,66 @@ namespace Catch {
 
     private:
 
+        // In milliseconds, from a [timeout:<ms>] tag or else from the config. 0 for none
+        int testTimeout( TestCaseInfo const& testInfo ) const {
+            for( std::set<std::string>::const_iterator it = testInfo.lcaseTags.begin(), itEnd = testInfo.lcaseTags.end(); it != itEnd; ++it ) {
+                if( startsWith( *it, "timeout:" ) ) {
+                    std::istringstream iss( it->substr( 8 ) );
+                    int timeout;
+                    if( iss >> timeout && timeout > 0 )
+                        return timeout;
+                }
+            }
+            return m_config->testTimeout();
+        }
+
+        // Only measured for the run history, which is what --memory-budget goes by.
+        // The peak belongs to the whole process, so not for a test case sharing it
+        bool tracksPeakMemory() const {
+            return !m_sharesProcess && ( m_config->recordsHistory() || m_config->memoryBudget() > 0 );
+        }
+
         void runCurrentTest( std::string& redirectedCout, std::string& redirectedCerr ) {
             TestCaseInfo const& testCaseInfo = m_activeTestCase->getTestCaseInfo();
             SectionInfo testCaseSection( testCaseInfo.lineInfo, testCaseInfo.name, testCaseInfo.description );
             m_reporter->sectionStarting( testCaseSection );
             Counts prevAssertions = m_totals.assertions;
             double duration = 0;
+            bool passesRun = false;
+            m_lastAssertionInfo = AssertionInfo( "TEST_CASE", testCaseInfo.lineInfo, "", ResultDisposition::Normal );
             try {
+                ScopedUnlock testCaseRunning( m_reportMutex );
                 // Function modified to better match Alf memory model. PRapin
-                baseThreadManager->stopAll();
-                baseSingletonsManager.releaseAll();
-                BaseObject::recentObjects->clear();
+                bool const ownsProcess = !m_sharesProcess;
+                if( ownsProcess ) {
+                    baseThreadManager->stopAll();
+                    baseSingletonsManager.releaseAll();
+                    BaseObject::recentObjects->clear();
+                    StoragePaths::setCurrentUnitTestFileName(testCaseInfo.lineInfo.file);
+                }
                 S32 old_counts[2] = {BaseObject::constructorCount, BaseObject::destructorCount} ;
-                StoragePaths::setCurrentUnitTestFileName(testCaseInfo.lineInfo.file);
                
-                m_lastAssertionInfo = AssertionInfo( "TEST_CASE", testCaseInfo.lineInfo, "", ResultDisposition::Normal );
                 {
-                    BaseRaiiCleaner cleanSingleton([]{ baseSingletonsManager.releaseAll(); });
-                    BaseRaiiCleaner cleanThread([]{ baseThreadManager->stopAll(); });
+                    BaseRaiiCleaner cleanSingleton([ownsProcess]{ if( ownsProcess ) baseSingletonsManager.releaseAll(); });
+                    BaseRaiiCleaner cleanThread([ownsProcess]{ if( ownsProcess ) baseThreadManager->stopAll(); });
                     BaseAutorelease;
-                    U32 seed = m_config->rngSeed();
+                    U32 seed = m_rngSeed != 0 ? m_rngSeed : m_config->rngSeed();
                     if(seed == 0)
                     {
                         S64 t = std::chrono::high_resolution_clock::now().time_since_epoch().count();
                         seed = (U32)(t ^ (t >> 32));
                     }
                     random.seed(seed);
-                    srand(seed);
+                    if( ownsProcess )
+                        srand(seed);
                     INTERNAL_CATCH_INFO( "Random generator seeded with value " << seed, "INFO" );
 
-                    seedRng( *m_config );
+                    if( m_rngSeed == 0 && ownsProcess )
+                        seedRng( *m_config );
                    
                     Timer timer;
                     timer.start();
-                    if( m_reporter->getPreferences().shouldRedirectStdOut ) {
+                    if( m_reporter->getPreferences().shouldRedirectStdOut && ownsProcess ) {
                         StreamRedirect coutRedir( Catch::cout(), redirectedCout );
                         StreamRedirect cerrRedir( Catch::cerr(), redirectedCerr );
                         invokeActiveTestCase();
@@ -315,7 +532,9 @@ namespace Catch {
                     duration = timer.getElapsedSeconds();
                 }
                 
-                std::unordered_set<BaseObject*> leakingObjects = *BaseObject::recentObjects;
+                std::unordered_set<BaseObject*> leakingObjects;
+                if( ownsProcess ) // The objects of the other threads would be counted in
+                    leakingObjects = *BaseObject::recentObjects;
                 for(BaseObject* obj : leakingObjects)
                 {
                     INTERNAL_CATCH_MSG( Catch::ResultWas::Warning, Catch::ResultDisposition::ContinueOnFailure,
@@ -332,7 +551,7 @@ namespace Catch {
                 S32 new_counts[2] = {BaseObject::constructorCount, BaseObject::destructorCount} ;
                 ptrdiff_t diff = new_counts[0] - new_counts[1] - old_counts[0] + old_counts[1];
                 
-                if(diff)
+                if(diff && ownsProcess)
                 {
                     INTERNAL_CATCH_MSG( Catch::ResultWas::ExplicitFailure, Catch::ResultDisposition::Normal, "FAIL",
                                        "Memory leaks detected: " << diff << " objects\nSet BaseObject::stampIDToBreak to find the leaking object");
@@ -343,6 +562,10 @@ namespace Catch {
             catch( TestFailureException& ) {
                 // This just means the test was aborted due to failure
             }
+            catch( CheckpointPassesRun& ) {
+                // The passes have ended the test case's section themselves
+                passesRun = true;
+            }
             catch(...) {
                 makeUnexpectedResultBuilder().useActiveException();
             }
@@ -351,7 +574,7 @@ namespace Catch {
             m_messages.clear();
 
             Counts assertions = m_totals.assertions - prevAssertions;
-            bool missingAssertions = testForMissingAssertions( assertions );
+            bool missingAssertions = !passesRun && testForMissingAssertions( assertions );
 
             if( testCaseInfo.okToFail() ) {
                 std::swap( assertions.failedButOk, assertions.failed );
@@ -359,11 +582,146 @@ namespace Catch {
                 m_totals.assertions.failedButOk += assertions.failedButOk;
             }
 
-            SectionStats testCaseSectionStats( testCaseSection, assertions, duration, missingAssertions );
-            m_reporter->sectionEnded( testCaseSectionStats );
+            if( !passesRun ) {
+                SectionStats testCaseSectionStats( testCaseSection, assertions, duration, missingAssertions );
+                m_reporter->sectionEnded( testCaseSectionStats );
+            }
+        }
+
+        struct CheckpointedSection {
+            CheckpointedSection() : running( false ), finished( false ) {}
+            TrackerState state;
+            std::vector<CheckpointPasses::Pass> passes;
+            bool running;
+            bool finished; // Complete, or no longer entered
+        };
+
+        // A [checkpoint] test case has reached its first section. Rather than
+        // being run again from the start for each pass through its sections,
+        // each pass is run by a process forked from here, which carries on
+        // from this point. Passes through different top level sections do not
+        // depend on each other, so up to --checkpoint-workers of them are run
+        // at once. Their events are then reported in the order a serial run
+        // would have reported them, and the test case is left
+        void runPassesFromCheckpoint() {
+            static const std::size_t exploring = static_cast<std::size_t>( -1 ); // The first pass, which finds the sections
+            std::vector<CheckpointedSection> sections; // Top level, in the order they were found
+            std::vector<CheckpointPasses::Pass> passesWithoutSection;
+            std::size_t workers = static_cast<std::size_t>( m_config->checkpointWorkers() );
+            std::unique_lock<std::recursive_mutex> reporting( m_reportMutex );
+
+            std::unique_ptr<CheckpointPasses> passes( new CheckpointPasses( *m_config ) );
+            bool explored = false;
+            for(;;) {
+                while( passes->running() < workers ) {
+                    std::size_t next = exploring;
+                    if( explored ) {
+                        for( next = 0; next < sections.size() && ( sections[next].running || sections[next].finished ); ++next ) {}
+                        if( next == sections.size() )
+                            break;
+                        sections[next].running = true;
+                    }
+                    else if( passes->running() > 0 )
+                        break;
+                    bool forked;
+                    {
+                        // Or the pass would never get it back
+                        ScopedUnlock forking( m_reportMutex );
+                        forked = passes->fork( next );
+                    }
+                    if( forked ) {
+                        startPass( sections, next );
+                        m_checkpointPasses = std::move( passes );
+                        m_passSectionEntered.clear();
+                        m_reporter = new SerialisingReporter( *m_checkpointPasses, m_reporter->getPreferences() );
+                        return;
+                    }
+                }
+                if( passes->running() == 0 )
+                    break;
+
+                CheckpointPasses::Pass pass;
+                {
+                    // The watchdog may step in while a pass hangs
+                    ScopedUnlock waiting( m_reportMutex );
+                    pass = passes->next();
+                }
+                if( pass.section == exploring )
+                    explored = true;
+                else
+                    sections[pass.section].running = false;
+                std::vector<TrackerState> const& found = pass.testCaseState.children;
+                for( std::vector<TrackerState>::const_iterator it = found.begin(), itEnd = found.end(); it != itEnd; ++it ) {
+                    std::size_t i = findSection( sections, it->name );
+                    if( i == sections.size() ) {
+                        sections.push_back( CheckpointedSection() );
+                        sections.back().state = *it;
+                        sections.back().finished = it->complete;
+                    }
+                    if( it->name == pass.sectionEntered ) {
+                        sections[i].state = *it;
+                        sections[i].finished = it->complete || !pass.ended;
+                    }
+                }
+                std::size_t entered = findSection( sections, pass.sectionEntered );
+                if( pass.section != exploring && entered != pass.section )
+                    sections[pass.section].finished = true; // Not reached any more (or the pass died)
+                if( entered < sections.size() )
+                    sections[entered].passes.push_back( pass );
+                else if( pass.section != exploring )
+                    sections[pass.section].passes.push_back( pass );
+                else
+                    passesWithoutSection.push_back( pass );
+            }
+            passes.reset();
+
+            TestCaseInfo const& testCaseInfo = m_activeTestCase->getTestCaseInfo();
+            SectionInfo testCaseSection( testCaseInfo.lineInfo, testCaseInfo.name, testCaseInfo.description );
+            bool firstPass = true; // Whose section for the test case has been reported as starting already
+            for( std::size_t i = 0; i <= sections.size(); ++i ) {
+                std::vector<CheckpointPasses::Pass> const& sectionPasses = i < sections.size() ? sections[i].passes : passesWithoutSection;
+                for( std::vector<CheckpointPasses::Pass>::const_iterator it = sectionPasses.begin(), itEnd = sectionPasses.end(); it != itEnd; ++it ) {
+                    TestEventReplayer replayer( *m_reporter, testCaseInfo, m_totals );
+                    replayer.openSection( testCaseSection, firstPass );
+                    firstPass = false;
+                    replayer.replayPass( it->events );
+                    if( !it->ended && !replayer.testCaseEnded() )
+                        replayer.interruptPass( it->interruption );
+                    m_totals.assertions += replayer.assertions();
+                }
+            }
+            throw CheckpointPassesRun();
+        }
+
+        static std::size_t findSection( std::vector<CheckpointedSection> const& sections, std::string const& name ) {
+            std::size_t i = 0;
+            while( i < sections.size() && sections[i].state.name != name )
+                ++i;
+            return i;
+        }
+
+        // In the process forked for a pass: only the section it was given is
+        // entered, with the state the passes before it left it in
+        void startPass( std::vector<CheckpointedSection> const& sections, std::size_t section ) {
+            if( sections.empty() )
+                return;
+            TrackerState testCaseState = m_testCaseTracker->state();
+            testCaseState.children.clear();
+            for( std::size_t i = 0; i < sections.size(); ++i )
+                testCaseState.children.push_back( sections[i].state );
+            m_testCaseTracker->restore( testCaseState );
+            for( std::size_t i = 0; i < sections.size(); ++i ) {
+                ITracker* tracker = m_testCaseTracker->findChild( sections[i].state.name );
+                if( i != section && tracker && tracker->isSectionTracker() )
+                    static_cast<SectionTracker*>( tracker )->skip();
+            }
         }
 
         void invokeActiveTestCase() {
+            if( m_sharesProcess ) {
+                m_activeTestCase->invoke();
+                return;
+            }
             FatalConditionHandler fatalConditionHandler; // Handle signals
             m_activeTestCase->invoke();
             fatalConditionHandler.reset();
@@ -371,6 +729,32 @@ namespace Catch {
 
     private:
 
+        // A benchmark regressed if its median got slower than in the baseline
+        // by more than the threshold, and the rank-sum test finds its samples
+        // slower than those of the baseline at the confidence level. Either
+        // way, the outcome is reported as an assertion of the benchmark
+        void compareWithBaseline( BenchmarkStats const& stats, std::vector<double> const& baseline ) {
+            double baselineMedian = Benchmark::median( baseline );
+            double change = baselineMedian > 0 ? ( stats.median / baselineMedian - 1 ) * 100 : 0;
+            Benchmark::RankSumTest test = Benchmark::mannWhitney( baseline, stats.samples );
+            bool regressed = change > m_config->benchmarkThreshold()
+                && test.pGreater < 1 - m_config->benchmarkConfidenceInterval();
+
+            std::ostringstream oss;
+            oss << "Benchmark '" << stats.name << "' " << ( regressed ? "regressed" : "did not regress" )
+                << ": median " << formatBenchmarkDuration( stats.median )
+                << " against " << formatBenchmarkDuration( baselineMedian )
+                << " at baseline " << m_config->benchmarkBaseline().commit()
+                << std::fixed << std::setprecision( 1 )
+                << " (" << ( change >= 0 ? "+" : "" ) << change << "%, threshold " << m_config->benchmarkThreshold() << "%"
+                << std::setprecision( 4 ) << ", p = " << test.pGreater << ")";
+
+            AssertionResultData data;
+            data.resultType = regressed ? ResultWas::ExplicitFailure : ResultWas::Ok;
+            data.message = oss.str();
+            assertionEnded( AssertionResult( AssertionInfo( "BENCHMARK", stats.lineInfo, "", ResultDisposition::ContinueOnFailure ), data ) );
+        }
+
         ResultBuilder makeUnexpectedResultBuilder() const {
             return ResultBuilder(   m_lastAssertionInfo.macroName.c_str(),
                                     m_lastAssertionInfo.lineInfo,
@@ -391,19 +775,35 @@ namespace Catch {
 
         TestRunInfo m_runInfo;
         IMutableContext& m_context;
+        Ptr<IConfig const> m_previousConfig;
+        IRunner* m_previousRunner;
+        IResultCapture* m_previousResultCapture;
         TestCase const* m_activeTestCase;
         ITracker* m_testCaseTracker;
         ITracker* m_currentSectionTracker;
         AssertionResult m_lastResult;
+        std::unique_ptr<BenchmarkComplexityStats> m_lastComplexity;
 
         Ptr<IConfig const> m_config;
+        RunJournal* m_journal;
+        ImpactRecorder* m_impactRecorder;
+        unsigned int m_rngSeed; // 0 for the configured one
+        bool m_sharesProcess; // With test cases running on other threads
+        bool m_checkpointPending; // The active test case is to be checkpointed at its first section
+        std::unique_ptr<CheckpointPasses> m_checkpointPasses; // Only in a process forked to run a pass
+        std::string m_passSectionEntered;
         Totals m_totals;
         Ptr<IStreamingReporter> m_reporter;
         std::vector<MessageInfo> m_messages;
         AssertionInfo m_lastAssertionInfo;
         std::vector<SectionEndInfo> m_unfinishedSections;
         std::vector<ITracker*> m_activeSections;
+        std::vector<SectionInfo> m_activeSectionInfos;
         TrackerContext m_trackerContext;
+        // Held by whichever thread reports, or keeps the books of, the test
+        // case being run: its own, one it started, or the watchdog's
+        std::recursive_mutex m_reportMutex;
+        TestWatchdog m_watchdog;
     };
 
     IResultCapture& getResultCapture() {
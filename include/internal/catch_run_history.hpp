@@ -0,0 +1,293 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_RUN_HISTORY_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_RUN_HISTORY_HPP_INCLUDED
+
+#include "catch_option.hpp"
+#include "catch_replace_file.hpp"
+
+#include <map>
+#include <unordered_set>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+
+namespace Catch {
+
+    // What is known of the previous runs of each test case, kept in a text file
+    // between runs. There is one line per test case: its (escaped) name, then
+    // tab separated key=value fields. Fields with an unknown key are kept as
+    // they are, so files written by a newer version can still be updated
+    class RunHistory {
+    public:
+        enum { DurationsKept = 10, ResultsKept = 20 };
+
+        struct Entry {
+            Entry() : failed( false ), peakMemoryKb( 0 ) {}
+
+            std::vector<double> durations; // Most recent last
+            bool failed; // The last time it was run
+            std::string results; // 'p' or 'f' for each of the last runs, most recent last
+            std::vector<std::string> failedSectionPath; // Where it first failed, below the test case
+            std::size_t peakMemoryKb; // Resident, the last time it was run. 0 if not known
+            std::map<std::string, std::string> otherFields;
+        };
+
+        // A missing file is an empty history
+        void load( std::string const& filename ) {
+            std::ifstream f( filename.c_str() );
+            read( f );
+        }
+        void read( std::istream& is ) {
+            std::string line;
+            while( std::getline( is, line ) ) {
+                if( line.empty() || line[0] == '#' )
+                    continue;
+                std::vector<std::string> fields = split( line, '\t' );
+                Entry& entry = m_entries[unescape( fields[0] )];
+                for( std::size_t i = 1; i < fields.size(); ++i ) {
+                    std::string::size_type eq = fields[i].find( '=' );
+                    if( eq == std::string::npos )
+                        continue;
+                    std::string key = fields[i].substr( 0, eq );
+                    std::string value = fields[i].substr( eq+1 );
+                    if( key == "durations" )
+                        entry.durations = parseList( value );
+                    else if( key == "failed" ) {
+                        entry.failed = true;
+                        entry.failedSectionPath = parsePath( value );
+                        m_failedLastRun.insert( unescape( fields[0] ) );
+                    }
+                    else if( key == "results" )
+                        entry.results = value;
+                    else if( key == "peakMemory" )
+                        std::istringstream( value ) >> entry.peakMemoryKb;
+                    else
+                        entry.otherFields[key] = value;
+                }
+                // Histories written before results were kept only know the last one
+                if( entry.failed && entry.results.empty() )
+                    entry.results = "f";
+            }
+        }
+
+        // Replaced whole, so an interrupted run cannot leave a truncated history
+        bool save( std::string const& filename ) const {
+            std::ostringstream oss;
+            write( oss );
+            return replaceFile( filename, oss.str() );
+        }
+        void write( std::ostream& os ) const {
+            os << "# Catch run history\n";
+            for( std::map<std::string, Entry>::const_iterator it = m_entries.begin(), itEnd = m_entries.end(); it != itEnd; ++it ) {
+                os << escape( it->first );
+                if( !it->second.durations.empty() ) {
+                    os << "\tdurations=";
+                    for( std::size_t i = 0; i < it->second.durations.size(); ++i )
+                        os << ( i > 0 ? "," : "" ) << it->second.durations[i];
+                }
+                if( it->second.failed ) {
+                    os << "\tfailed=";
+                    for( std::size_t i = 0; i < it->second.failedSectionPath.size(); ++i )
+                        os << ( i > 0 ? "/" : "" ) << escapePathPart( it->second.failedSectionPath[i] );
+                }
+                if( !it->second.results.empty() )
+                    os << "\tresults=" << it->second.results;
+                if( it->second.peakMemoryKb > 0 )
+                    os << "\tpeakMemory=" << it->second.peakMemoryKb;
+                for( std::map<std::string, std::string>::const_iterator field = it->second.otherFields.begin(), fieldEnd = it->second.otherFields.end(); field != fieldEnd; ++field )
+                    os << '\t' << field->first << '=' << field->second;
+                os << '\n';
+            }
+        }
+
+        void recordDuration( std::string const& testName, double durationInSeconds ) {
+            std::vector<double>& durations = m_entries[testName].durations;
+            durations.push_back( durationInSeconds );
+            if( durations.size() > DurationsKept )
+                durations.erase( durations.begin(), durations.end() - DurationsKept );
+        }
+
+        void recordPeakMemory( std::string const& testName, std::size_t peakMemoryKb ) {
+            m_entries[testName].peakMemoryKb = peakMemoryKb;
+        }
+
+        // Sections are given from the outermost one, not counting the test case itself
+        void recordResult( std::string const& testName, bool failed, std::vector<std::string> const& failedSectionPath ) {
+            Entry& entry = m_entries[testName];
+            entry.failed = failed;
+            entry.failedSectionPath = failed ? failedSectionPath : std::vector<std::string>();
+            entry.results += failed ? 'f' : 'p';
+            if( entry.results.size() > ResultsKept )
+                entry.results.erase( 0, entry.results.size() - ResultsKept );
+        }
+
+        // As loaded, so not changed by the results of the current run
+        bool failedLastRun( std::string const& testName ) const {
+            return m_failedLastRun.find( testName ) != m_failedLastRun.end();
+        }
+        std::vector<std::string> failedSectionPath( std::string const& testName ) const {
+            std::map<std::string, Entry>::const_iterator it = m_entries.find( testName );
+            return it != m_entries.end() ? it->second.failedSectionPath : std::vector<std::string>();
+        }
+
+        // Within the last ResultsKept runs
+        std::size_t recordedFailures( std::string const& testName ) const {
+            std::map<std::string, Entry>::const_iterator it = m_entries.find( testName );
+            return it != m_entries.end() ? static_cast<std::size_t>( std::count( it->second.results.begin(), it->second.results.end(), 'f' ) ) : 0;
+        }
+        // Each recorded failure counts half as much as the one a run after it,
+        // so a test that failed last run weighs at least 1. Nothing for a test
+        // without recorded results
+        Option<double> failureWeight( std::string const& testName ) const {
+            std::map<std::string, Entry>::const_iterator it = m_entries.find( testName );
+            if( it == m_entries.end() || it->second.results.empty() )
+                return Option<double>();
+            double weight = 0, worth = 1;
+            for( std::string::const_reverse_iterator result = it->second.results.rbegin(), resultEnd = it->second.results.rend(); result != resultEnd; ++result, worth /= 2 )
+                if( *result == 'f' )
+                    weight += worth;
+            return weight;
+        }
+
+        // The mean of the recorded durations
+        Option<double> expectedDuration( std::string const& testName ) const {
+            std::map<std::string, Entry>::const_iterator it = m_entries.find( testName );
+            if( it == m_entries.end() || it->second.durations.empty() )
+                return Option<double>();
+            double total = 0;
+            for( std::size_t i = 0; i < it->second.durations.size(); ++i )
+                total += it->second.durations[i];
+            return total / static_cast<double>( it->second.durations.size() );
+        }
+
+        // The expected duration of a test that has been run before, or else
+        // of an average one (a guess is better than assuming it is free)
+        std::vector<double> estimateDurations( std::vector<std::string> const& testNames ) const {
+            std::vector<double> estimates( testNames.size(), -1.0 );
+            double known = 0;
+            std::size_t knownCount = 0;
+            for( std::size_t i = 0; i < testNames.size(); ++i ) {
+                if( Option<double> duration = expectedDuration( testNames[i] ) ) {
+                    estimates[i] = *duration;
+                    known += *duration;
+                    ++knownCount;
+                }
+            }
+            double average = knownCount > 0 ? known / static_cast<double>( knownCount ) : 0;
+            for( std::size_t i = 0; i < estimates.size(); ++i )
+                if( estimates[i] < 0 )
+                    estimates[i] = average;
+            return estimates;
+        }
+
+        // In kilobytes, as for durations: a test that has not been run before
+        // is expected to take as much as the average one
+        std::vector<std::size_t> estimatePeakMemory( std::vector<std::string> const& testNames ) const {
+            std::vector<std::size_t> estimates( testNames.size(), 0 );
+            std::size_t known = 0, knownCount = 0;
+            for( std::size_t i = 0; i < testNames.size(); ++i ) {
+                std::map<std::string, Entry>::const_iterator it = m_entries.find( testNames[i] );
+                if( it != m_entries.end() && it->second.peakMemoryKb > 0 ) {
+                    estimates[i] = it->second.peakMemoryKb;
+                    known += it->second.peakMemoryKb;
+                    ++knownCount;
+                }
+            }
+            std::size_t average = knownCount > 0 ? known / knownCount : 0;
+            for( std::size_t i = 0; i < estimates.size(); ++i )
+                if( estimates[i] == 0 )
+                    estimates[i] = average;
+            return estimates;
+        }
+
+        // Test names are escaped the same way in the run journal
+        static std::string escape( std::string const& str ) {
+            std::string escaped;
+            for( std::string::const_iterator it = str.begin(), itEnd = str.end(); it != itEnd; ++it ) {
+                switch( *it ) {
+                    case '\\': escaped += "\\\\"; break;
+                    case '\t': escaped += "\\t"; break;
+                    case '\n': escaped += "\\n"; break;
+                    case '\r': escaped += "\\r"; break;
+                    default: escaped += *it;
+                }
+            }
+            return escaped;
+        }
+        static std::string unescape( std::string const& str ) {
+            std::string unescaped;
+            for( std::string::size_type i = 0; i < str.size(); ++i ) {
+                if( str[i] == '\\' && i+1 < str.size() ) {
+                    switch( str[++i] ) {
+                        case 't': unescaped += '\t'; break;
+                        case 'n': unescaped += '\n'; break;
+                        case 'r': unescaped += '\r'; break;
+                        default: unescaped += str[i];
+                    }
+                }
+                else
+                    unescaped += str[i];
+            }
+            return unescaped;
+        }
+
+    private:
+        static std::vector<std::string> split( std::string const& str, char separator ) {
+            std::vector<std::string> parts;
+            std::string::size_type start = 0, end;
+            while( ( end = str.find( separator, start ) ) != std::string::npos ) {
+                parts.push_back( str.substr( start, end-start ) );
+                start = end+1;
+            }
+            parts.push_back( str.substr( start ) );
+            return parts;
+        }
+        static std::vector<double> parseList( std::string const& value ) {
+            std::vector<double> values;
+            std::vector<std::string> parts = split( value, ',' );
+            for( std::size_t i = 0; i < parts.size(); ++i ) {
+                std::istringstream iss( parts[i] );
+                double d;
+                if( iss >> d )
+                    values.push_back( d );
+            }
+            return values;
+        }
+        // Section names are separated by slashes, so slashes within them are escaped
+        static std::string escapePathPart( std::string const& str ) {
+            std::string escaped = escape( str );
+            std::string::size_type pos = 0;
+            while( ( pos = escaped.find( '/', pos ) ) != std::string::npos ) {
+                escaped.insert( pos, 1, '\\' );
+                pos += 2;
+            }
+            return escaped;
+        }
+        static std::vector<std::string> parsePath( std::string const& value ) {
+            std::vector<std::string> path;
+            if( value.empty() )
+                return path;
+            std::string::size_type start = 0;
+            for( std::string::size_type i = 0; i <= value.size(); ++i ) {
+                if( i < value.size() && value[i] == '\\' )
+                    ++i;
+                else if( i == value.size() || value[i] == '/' ) {
+                    path.push_back( unescape( value.substr( start, i-start ) ) );
+                    start = i+1;
+                }
+            }
+            return path;
+        }
+        std::map<std::string, Entry> m_entries;
+        std::unordered_set<std::string> m_failedLastRun; // Looked up for every test case
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_RUN_HISTORY_HPP_INCLUDED
@@ -0,0 +1,78 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_RUN_HISTORY_RECORDER_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_RUN_HISTORY_RECORDER_HPP_INCLUDED
+
+#include "catch_interfaces_reporter.h"
+#include "catch_run_history.hpp"
+
+namespace Catch {
+
+    // Listens to the reporter events to update the run history. The wall time
+    // of a test case is that of its test case sections, summed over all the
+    // times it was entered to run each of its leaf sections. A failed test case
+    // is recorded with the path of the section its first failure was in, and
+    // each test case with the peak resident memory of the process running it
+    class RunHistoryRecorder : public SharedImpl<IStreamingReporter> {
+    public:
+        RunHistoryRecorder( RunHistory& history )
+        :   m_history( history ),
+            m_testCaseDuration( 0 ),
+            m_failed( false )
+        {}
+
+        virtual ReporterPreferences getPreferences() const CATCH_OVERRIDE {
+            return ReporterPreferences();
+        }
+
+        virtual void noMatchingTestCases( std::string const& ) CATCH_OVERRIDE {}
+        virtual void testRunStarting( TestRunInfo const& ) CATCH_OVERRIDE {}
+        virtual void testGroupStarting( GroupInfo const& ) CATCH_OVERRIDE {}
+        virtual void testGroupEnded( TestGroupStats const& ) CATCH_OVERRIDE {}
+        virtual void testRunEnded( TestRunStats const& ) CATCH_OVERRIDE {}
+        virtual void skipTest( TestCaseInfo const& ) CATCH_OVERRIDE {}
+        virtual void assertionStarting( AssertionInfo const& ) CATCH_OVERRIDE {}
+
+        virtual bool assertionEnded( AssertionStats const& assertionStats ) CATCH_OVERRIDE {
+            if( !m_failed && !assertionStats.assertionResult.isOk() ) {
+                m_failed = true;
+                m_failedSectionPath.assign( m_sectionNames.begin() + ( m_sectionNames.empty() ? 0 : 1 ), m_sectionNames.end() );
+            }
+            return false;
+        }
+
+        virtual void testCaseStarting( TestCaseInfo const& ) CATCH_OVERRIDE {
+            m_sectionNames.clear();
+            m_testCaseDuration = 0;
+            m_failed = false;
+            m_failedSectionPath.clear();
+        }
+        virtual void sectionStarting( SectionInfo const& sectionInfo ) CATCH_OVERRIDE {
+            m_sectionNames.push_back( sectionInfo.name );
+        }
+        virtual void sectionEnded( SectionStats const& sectionStats ) CATCH_OVERRIDE {
+            m_sectionNames.pop_back();
+            if( m_sectionNames.empty() )
+                m_testCaseDuration += sectionStats.durationInSeconds;
+        }
+        virtual void testCaseEnded( TestCaseStats const& testCaseStats ) CATCH_OVERRIDE {
+            m_history.recordDuration( testCaseStats.testInfo.name, m_testCaseDuration );
+            bool failed = testCaseStats.totals.assertions.failed > 0;
+            m_history.recordResult( testCaseStats.testInfo.name, failed, m_failedSectionPath );
+            if( testCaseStats.peakMemoryKb > 0 )
+                m_history.recordPeakMemory( testCaseStats.testInfo.name, testCaseStats.peakMemoryKb );
+        }
+
+    private:
+        RunHistory& m_history;
+        std::vector<std::string> m_sectionNames; // Starting with the test case itself
+        double m_testCaseDuration;
+        bool m_failed;
+        std::vector<std::string> m_failedSectionPath;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_RUN_HISTORY_RECORDER_HPP_INCLUDED
@@ -0,0 +1,169 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_RUN_JOURNAL_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_RUN_JOURNAL_HPP_INCLUDED
+
+#include "catch_run_history.hpp"
+#include "catch_totals.hpp"
+#include "catch_option.hpp"
+#include "catch_common.h"
+#include "catch_replace_file.hpp"
+
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
+#include <cstdio>
+
+namespace Catch {
+
+    // Records the totals of each test case as soon as it completes, so a run
+    // that dies part way can be resumed from where it got to. There is one line
+    // per test case: its (escaped) name, then tab separated key=value fields.
+    // A test case run in this process is first recorded as attempted, so one
+    // that brings the process down can be told apart, and the journal is marked
+    // once the run gets to the end. Each line is handed to the system straight
+    // away, which is enough to survive the process being killed, but is only
+    // synced to the disk in batches (surviving the machine going down), as that
+    // is much slower
+    class RunJournal : NonCopyable {
+    public:
+        enum { SyncBatchSize = 32 };
+
+        RunJournal() : m_file( CATCH_NULL ), m_unsynced( 0 ) {}
+        ~RunJournal() {
+            close();
+        }
+
+        // When resuming, the test cases already recorded are read back (any
+        // partly written record is dropped) and the journal carries on from
+        // there. A missing journal, or one whose run got to the end, is just
+        // started afresh
+        bool open( std::string const& filename, bool resume ) {
+            close();
+            m_completed.clear();
+            m_attempted.clear();
+            std::string records;
+            if( resume ) {
+                std::ifstream f( filename.c_str(), std::ios::binary );
+                std::string content( ( std::istreambuf_iterator<char>( f ) ), std::istreambuf_iterator<char>() );
+                std::istringstream iss( content.substr( 0, content.find_last_of( '\n' ) + 1 ) );
+                std::string line;
+                while( std::getline( iss, line ) ) {
+                    if( line == endOfRunMark() ) {
+                        records.clear();
+                        m_completed.clear();
+                        m_attempted.clear();
+                    }
+                    else if( parseRecord( line ) )
+                        records += line + '\n';
+                }
+            }
+
+            // Rewritten rather than appended to, so a torn record cannot be glued to the next one
+            if( !replaceFile( filename, "# Catch run journal\n" + records ) )
+                return false;
+
+            m_file = std::fopen( filename.c_str(), "ab" );
+            m_lastSync = std::chrono::steady_clock::now();
+            return m_file != CATCH_NULL;
+        }
+
+        void close() {
+            if( m_file ) {
+                syncFile( m_file );
+                std::fclose( m_file );
+                m_file = CATCH_NULL;
+            }
+        }
+
+        Option<Totals> completed( std::string const& testName ) const {
+            std::unordered_map<std::string, Totals>::const_iterator it = m_completed.find( testName );
+            return it != m_completed.end() ? Option<Totals>( it->second ) : Option<Totals>();
+        }
+        // Attempted by the run being resumed, which died before it completed
+        bool crashed( std::string const& testName ) const {
+            return m_attempted.find( testName ) != m_attempted.end();
+        }
+
+        void attempt( std::string const& testName ) {
+            write( RunHistory::escape( testName ) + "\tattempted\n" );
+        }
+        void record( std::string const& testName, Totals const& totals ) {
+            std::ostringstream oss;
+            oss << RunHistory::escape( testName )
+                << "\ttestCases=" << totals.testCases.passed << ',' << totals.testCases.failed << ',' << totals.testCases.failedButOk
+                << "\tassertions=" << totals.assertions.passed << ',' << totals.assertions.failed << ',' << totals.assertions.failedButOk
+                << '\n';
+            write( oss.str() );
+        }
+        // Resuming from here on starts a new run
+        void endOfRun() {
+            write( endOfRunMark() + '\n' );
+            if( m_file )
+                syncFile( m_file );
+        }
+
+    private:
+        static std::string endOfRunMark() {
+            return "# End of run";
+        }
+
+        void write( std::string const& line ) {
+            if( !m_file )
+                return;
+            std::fwrite( line.data(), 1, line.size(), m_file );
+            std::fflush( m_file );
+
+            if( ++m_unsynced >= SyncBatchSize || std::chrono::steady_clock::now() - m_lastSync > std::chrono::seconds( 1 ) ) {
+                syncFile( m_file );
+                m_unsynced = 0;
+                m_lastSync = std::chrono::steady_clock::now();
+            }
+        }
+
+        bool parseRecord( std::string const& line ) {
+            if( line.empty() || line[0] == '#' )
+                return false;
+            std::string::size_type tab = line.find( '\t' );
+            if( tab == std::string::npos )
+                return false;
+            std::string testName = RunHistory::unescape( line.substr( 0, tab ) );
+            if( line.compare( tab, std::string::npos, "\tattempted" ) == 0 ) {
+                m_attempted.insert( testName );
+                m_completed.erase( testName );
+                return true;
+            }
+            Totals totals;
+            if( !parseCounts( line, "\ttestCases=", totals.testCases ) ||
+                    !parseCounts( line, "\tassertions=", totals.assertions ) )
+                return false;
+            m_completed[testName] = totals;
+            m_attempted.erase( testName );
+            return true;
+        }
+        static bool parseCounts( std::string const& line, std::string const& key, Counts& counts ) {
+            std::string::size_type pos = line.find( key );
+            if( pos == std::string::npos )
+                return false;
+            std::istringstream iss( line.substr( pos + key.size() ) );
+            char comma1 = 0, comma2 = 0;
+            iss >> counts.passed >> comma1 >> counts.failed >> comma2 >> counts.failedButOk;
+            return !iss.fail() && comma1 == ',' && comma2 == ',';
+        }
+
+        std::FILE* m_file;
+        std::size_t m_unsynced;
+        std::chrono::steady_clock::time_point m_lastSync;
+        std::unordered_map<std::string, Totals> m_completed;
+        std::unordered_set<std::string> m_attempted; // But not completed
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_RUN_JOURNAL_HPP_INCLUDED
@@ -0,0 +1,257 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_SECTION_CHECKPOINT_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_SECTION_CHECKPOINT_HPP_INCLUDED
+
+#include "catch_test_event_stream.hpp"
+#include "catch_test_case_tracker.hpp"
+#include "catch_interfaces_config.h"
+#include "catch_stream.h"
+#include "catch_platform.h"
+#include "catch_cpu_pinning.hpp"
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef CATCH_PLATFORM_WINDOWS
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+namespace Catch {
+
+    // Thrown out of a [checkpoint] test case by the process that reached its
+    // checkpoint, once all the passes through it have been run from there
+    struct CheckpointPassesRun {};
+
+    inline void writeTrackerState( TestEventWriter& writer, TrackerState const& state ) {
+        writer.write( state.name );
+        writer.write( state.runState );
+        writer.write( state.complete );
+        writer.write( state.isIndexTracker );
+        writer.write( state.index );
+        writer.write( state.size );
+        writer.write( state.children.size() );
+        for( std::vector<TrackerState>::const_iterator it = state.children.begin(), itEnd = state.children.end(); it != itEnd; ++it )
+            writeTrackerState( writer, *it );
+    }
+    inline TrackerState readTrackerState( TestEventReader& reader ) {
+        TrackerState state;
+        state.name = reader.readString();
+        state.runState = reader.readInt();
+        state.complete = reader.readBool();
+        state.isIndexTracker = reader.readBool();
+        state.index = reader.readInt();
+        state.size = reader.readInt();
+        state.children.resize( reader.readSize() );
+        for( std::vector<TrackerState>::iterator it = state.children.begin(), itEnd = state.children.end(); it != itEnd; ++it )
+            *it = readTrackerState( reader );
+        return state;
+    }
+
+    // The processes running passes through a [checkpoint] test case. Each is
+    // forked from the process that reached the checkpoint - the first section
+    // of the test case - so it starts with everything the test case did up to
+    // there, and sends back the events of its pass and the state of the
+    // sections at the end of it. In a forked process, this is where the events
+    // of its pass go
+    class CheckpointPasses : public ITestEventSink, NonCopyable {
+    public:
+        struct Pass {
+            Pass() : section( 0 ), ended( false ) {}
+            std::size_t section; // As given to fork()
+            std::string events;
+            std::string interruption; // Set if the process died before the pass ended
+            std::string sectionEntered; // The name of its tracker, if the pass entered a top level section
+            TrackerState testCaseState;
+            bool ended;
+        };
+
+#ifdef CATCH_PLATFORM_WINDOWS
+
+        static bool isSupported() { return false; }
+
+        CheckpointPasses( IConfig const& ) {
+            throw std::domain_error( "Checkpointing sections is not supported on this platform" );
+        }
+        bool fork( std::size_t ) { return false; }
+        std::size_t running() const { return 0; }
+        Pass next() {
+            throw std::logic_error( "Illogical state" );
+        }
+        virtual void eventsFlushed( std::string const&, bool ) CATCH_OVERRIDE {}
+        void endPass( std::string const&, TrackerState const& ) {}
+
+#else // Not Windows - assumed to be POSIX compatible //////////////////////////
+
+        static bool isSupported() { return true; }
+
+        CheckpointPasses( IConfig const& config ) : m_config( config ), m_passFd( -1 ) {
+            m_previousSigPipe = signal( SIGPIPE, SIG_IGN ); // A dying pass must not take us with it
+        }
+
+        ~CheckpointPasses() {
+            for( std::vector<Process>::iterator it = m_processes.begin(), itEnd = m_processes.end(); it != itEnd; ++it ) {
+                kill( it->pid, SIGKILL ); // Only happens when the test case is left by an exception
+                close( it->fd );
+                int status;
+                while( waitpid( it->pid, &status, 0 ) < 0 && errno == EINTR ) {}
+            }
+            signal( SIGPIPE, m_previousSigPipe );
+        }
+
+        // Returns true in the forked process, which runs the pass
+        bool fork( std::size_t section ) {
+            int resultPipe[2];
+            if( pipe( resultPipe ) != 0 )
+                throw std::runtime_error( std::string( "Unable to create checkpoint pipe: " ) + strerror( errno ) );
+
+            // Anything still buffered would otherwise be written twice
+            Catch::cout().flush();
+            Catch::cerr().flush();
+            m_config.stream().flush();
+            fflush( CATCH_NULL );
+
+            CpuPlacement placement;
+            if( CpuPinning* pinning = CpuPinning::active() )
+                placement = pinning->nextForChild();
+
+            pid_t pid = ::fork();
+            if( pid < 0 )
+                throw std::runtime_error( std::string( "Unable to fork checkpointed pass: " ) + strerror( errno ) );
+
+            if( pid == 0 ) {
+                if( placement.cpu >= 0 )
+                    CpuPinning::pin( placement );
+                close( resultPipe[0] );
+                for( std::vector<Process>::const_iterator it = m_processes.begin(), itEnd = m_processes.end(); it != itEnd; ++it )
+                    close( it->fd );
+                m_processes.clear(); // None of them are this one's to wait for
+                signal( SIGPIPE, SIG_DFL );
+                m_passFd = resultPipe[1];
+                return true;
+            }
+
+            close( resultPipe[1] );
+            Process process;
+            process.pid = pid;
+            process.fd = resultPipe[0];
+            process.pass.section = section;
+            m_processes.push_back( process );
+            return false;
+        }
+
+        std::size_t running() const {
+            return m_processes.size();
+        }
+
+        // Blocks until one of the passes has ended, or its process has died
+        Pass next() {
+            if( m_processes.empty() )
+                throw std::logic_error( "No checkpointed pass left to wait for" );
+            for(;;) {
+                std::vector<pollfd> fds( m_processes.size() );
+                for( std::size_t i = 0; i < m_processes.size(); ++i ) {
+                    fds[i].fd = m_processes[i].fd;
+                    fds[i].events = POLLIN;
+                    fds[i].revents = 0;
+                }
+                if( poll( &fds[0], fds.size(), -1 ) < 0 ) {
+                    if( errno == EINTR )
+                        continue;
+                    throw std::runtime_error( std::string( "Unable to wait for checkpointed passes: " ) + strerror( errno ) );
+                }
+                for( std::size_t i = 0; i < fds.size(); ++i ) {
+                    if( fds[i].revents == 0 )
+                        continue;
+                    Process& process = m_processes[i];
+                    char buffer[65536];
+                    ssize_t got = read( process.fd, buffer, sizeof( buffer ) );
+                    if( got < 0 && errno == EINTR )
+                        continue;
+                    if( got <= 0 )
+                        return processExited( i );
+                    process.frames.append( buffer, static_cast<std::size_t>( got ) );
+
+                    EventFrame::Kind kind;
+                    std::string payload;
+                    while( !process.pass.ended && process.frames.nextFrame( kind, payload ) ) {
+                        if( kind == EventFrame::PassEnded ) {
+                            TestEventReader reader( payload );
+                            process.pass.sectionEntered = reader.readString();
+                            process.pass.testCaseState = readTrackerState( reader );
+                            process.pass.ended = true;
+                        }
+                        else
+                            process.pass.events += payload;
+                    }
+                }
+            }
+        }
+
+        virtual void eventsFlushed( std::string const& events, bool ) CATCH_OVERRIDE {
+            if( !writeFrame( m_passFd, EventFrame::Events, events ) )
+                _exit( 1 ); // Nobody is listening any more
+        }
+
+        // Run by the forked process at the end of its pass. Never returns
+        void endPass( std::string const& sectionEntered, TrackerState const& testCaseState ) {
+            TestEventWriter writer;
+            writer.write( sectionEntered );
+            writeTrackerState( writer, testCaseState );
+            writeFrame( m_passFd, EventFrame::PassEnded, writer.data() );
+            Catch::cout().flush();
+            Catch::cerr().flush();
+            fflush( CATCH_NULL );
+            _exit( 0 );
+        }
+
+    private:
+        struct Process {
+            Process() : pid( -1 ), fd( -1 ) {}
+            pid_t pid;
+            int fd;
+            EventFrameBuffer frames;
+            Pass pass;
+        };
+
+        Pass processExited( std::size_t index ) {
+            Process process = m_processes[index];
+            m_processes.erase( m_processes.begin() + static_cast<std::ptrdiff_t>( index ) );
+            close( process.fd );
+
+            int status = 0;
+            while( waitpid( process.pid, &status, 0 ) < 0 && errno == EINTR ) {}
+
+            if( !process.pass.ended ) {
+                std::ostringstream oss;
+                if( WIFSIGNALED( status ) )
+                    oss << "Checkpointed pass " << process.pid << " was terminated by signal " << WTERMSIG( status )
+                        << " (" << strsignal( WTERMSIG( status ) ) << ")";
+                else
+                    oss << "Checkpointed pass " << process.pid << " exited with code " << WEXITSTATUS( status )
+                        << " before it ended";
+                process.pass.interruption = oss.str();
+            }
+            return process.pass;
+        }
+
+        IConfig const& m_config;
+        int m_passFd; // In a forked process
+        std::vector<Process> m_processes;
+        void (*m_previousSigPipe)( int );
+
+#endif // not Windows
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_SECTION_CHECKPOINT_HPP_INCLUDED
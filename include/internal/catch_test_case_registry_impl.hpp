@@ -12,12 +12,15 @@
 #include "catch_test_case_info.h"
 #include "catch_test_spec.hpp"
 #include "catch_context.h"
+#include "catch_run_history.hpp"
+#include "catch_test_impact.hpp"
 
 #include <vector>
 #include <set>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <stdint.h>
 
 namespace Catch {
 
@@ -25,6 +28,43 @@ namespace Catch {
         bool operator() (TestCase i,TestCase j) const { return (i<j);}
     };
 
+    // Orders indices into a list of estimated durations, longest first
+    struct LongestFirst {
+        LongestFirst( std::vector<double> const& durations ) : m_durations( durations ) {}
+        bool operator() ( std::size_t i, std::size_t j ) const { return m_durations[i] > m_durations[j]; }
+        std::vector<double> const& m_durations;
+    };
+
+    struct FailedLastRun {
+        FailedLastRun( RunHistory const& history ) : m_history( history ) {}
+        bool operator() ( TestCase const& testCase ) const { return m_history.failedLastRun( testCase.name ); }
+        RunHistory const& m_history;
+    };
+
+    inline std::vector<double> estimateDurations( IConfig const& config, std::vector<TestCase> const& testCases ) {
+        std::vector<std::string> names;
+        names.reserve( testCases.size() );
+        for( std::vector<TestCase>::const_iterator it = testCases.begin(), itEnd = testCases.end(); it != itEnd; ++it )
+            names.push_back( it->name );
+        return config.history().estimateDurations( names );
+    }
+
+    // Slow tests go first so they don't end up running on their own at the
+    // end of a parallel or sharded run. Ties stay in declaration order
+    inline std::vector<TestCase> sortLongestFirst( IConfig const& config, std::vector<TestCase> const& testCases ) {
+        std::vector<double> durations = estimateDurations( config, testCases );
+        std::vector<std::size_t> order( testCases.size() );
+        for( std::size_t i = 0; i < order.size(); ++i )
+            order[i] = i;
+        std::stable_sort( order.begin(), order.end(), LongestFirst( durations ) );
+
+        std::vector<TestCase> sorted;
+        sorted.reserve( testCases.size() );
+        for( std::size_t i = 0; i < order.size(); ++i )
+            sorted.push_back( testCases[order[i]] );
+        return sorted;
+    }
+
     inline std::vector<TestCase> sortTests( IConfig const& config, std::vector<TestCase> const& unsortedTestCases ) {
 
         std::vector<TestCase> sorted = unsortedTestCases;
@@ -40,14 +80,86 @@ namespace Catch {
                     std::shuffle( sorted.begin(), sorted.end(), rng );
                 }
                 break;
+            case RunTests::InDurationOrder:
+                sorted = sortLongestFirst( config, sorted );
+                break;
+            case RunTests::InFailuresFirstOrder:
+                std::stable_partition( sorted.begin(), sorted.end(), FailedLastRun( config.history() ) );
+                break;
             case RunTests::InDeclarationOrder:
                 // already in declaration order
                 break;
         }
         return sorted;
     }
+    // Shards are chosen from a hash of the test name (FNV-1a), not from the test's
+    // position, so adding or removing a test does not move any other test
+    inline std::size_t shardOf( std::string const& testName, std::size_t shardCount ) {
+        uint64_t hash = 14695981039346656037ULL;
+        for( std::string::const_iterator it = testName.begin(), itEnd = testName.end(); it != itEnd; ++it ) {
+            hash ^= static_cast<unsigned char>( *it );
+            hash *= 1099511628211ULL;
+        }
+        return static_cast<std::size_t>( hash % shardCount );
+    }
+    inline bool isInShard( TestCase const& testCase, IConfig const& config ) {
+        return config.shardCount() <= 1
+            || shardOf( testCase.name, static_cast<std::size_t>( config.shardCount() ) ) == static_cast<std::size_t>( config.shardIndex() );
+    }
+
+    // With --shard-balance the tests are instead dealt out longest first, each
+    // to the shard with the least work so far, so the shards take about as long
+    // as each other. Every shard must come to the same assignment, so it is made
+    // over all the tests the test spec selects (hidden or not) rather than over
+    // what this particular run or listing is going to use, and from the same
+    // history file
+    inline std::set<std::string> balancedShard( IConfig const& config ) {
+        std::vector<TestCase> candidates;
+        std::vector<TestCase> const& allTestCases = getRegistryHub().getTestCaseRegistry().getAllTests();
+        for( std::vector<TestCase>::const_iterator it = allTestCases.begin(), itEnd = allTestCases.end(); it != itEnd; ++it )
+            if( !config.testSpec().hasFilters() || config.testSpec().matches( *it ) )
+                candidates.push_back( *it );
+        std::sort( candidates.begin(), candidates.end(), LexSort() );
+        candidates = sortLongestFirst( config, candidates );
+        std::vector<double> durations = estimateDurations( config, candidates );
+
+        std::size_t shardCount = static_cast<std::size_t>( config.shardCount() );
+        std::vector<double> shardDurations( shardCount, 0.0 );
+        std::set<std::string> shard;
+        for( std::size_t i = 0; i < candidates.size(); ++i ) {
+            std::size_t leastBusy = static_cast<std::size_t>( std::min_element( shardDurations.begin(), shardDurations.end() ) - shardDurations.begin() );
+            shardDurations[leastBusy] += durations[i];
+            if( leastBusy == static_cast<std::size_t>( config.shardIndex() ) )
+                shard.insert( candidates[i].name );
+        }
+        return shard;
+    }
+    inline bool hasRecordedDurations( IConfig const& config, std::vector<TestCase> const& testCases ) {
+        for( std::vector<TestCase>::const_iterator it = testCases.begin(), itEnd = testCases.end(); it != itEnd; ++it )
+            if( config.history().expectedDuration( it->name ) )
+                return true;
+        return false;
+    }
+    inline std::vector<TestCase> selectShard( std::vector<TestCase> const& testCases, IConfig const& config ) {
+        std::vector<TestCase> selected;
+        if( config.balanceShards() && hasRecordedDurations( config, getRegistryHub().getTestCaseRegistry().getAllTests() ) ) {
+            std::set<std::string> shard = balancedShard( config );
+            for( std::vector<TestCase>::const_iterator it = testCases.begin(), itEnd = testCases.end(); it != itEnd; ++it )
+                if( shard.find( it->name ) != shard.end() )
+                    selected.push_back( *it );
+        }
+        else {
+            for( std::vector<TestCase>::const_iterator it = testCases.begin(), itEnd = testCases.end(); it != itEnd; ++it )
+                if( isInShard( *it, config ) )
+                    selected.push_back( *it );
+        }
+        return selected;
+    }
+
     bool matchTest( TestCase const& testCase, TestSpec const& testSpec, IConfig const& config ) {
-        return testSpec.matches( testCase ) && ( config.allowThrows() || !testCase.throws() );
+        return testSpec.matches( testCase ) && ( config.allowThrows() || !testCase.throws() ) &&
+            ( !config.rerunFailed() || config.history().failedLastRun( testCase.name ) ) &&
+            config.impactMap().selects( testCase.name );
     }
 
     void enforceNoDuplicateTestCases( std::vector<TestCase> const& functions ) {
@@ -77,6 +189,8 @@ namespace Catch {
                 ++it )
             if( matchTest( *it, testSpec, config ) )
                 filtered.push_back( *it );
+        if( config.shardCount() > 1 )
+            filtered = selectShard( filtered, config );
         return filtered;
     }
     std::vector<TestCase> const& getAllTestCasesSorted( IConfig const& config ) {
@@ -86,7 +200,7 @@ namespace Catch {
     class TestRegistry : public ITestCaseRegistry {
     public:
         TestRegistry()
-        :   m_currentSortOrder( RunTests::InDeclarationOrder ),
+        :   m_checkedForDuplicates( false ),
             m_unnamedCount( 0 )
         {}
         virtual ~TestRegistry();
@@ -104,20 +218,23 @@ namespace Catch {
         virtual std::vector<TestCase> const& getAllTests() const {
             return m_functions;
         }
+        // Sorted afresh each time, as the order can depend on the seed or the
+        // run history, which may differ from one run of a session to the next
         virtual std::vector<TestCase> const& getAllTestsSorted( IConfig const& config ) const {
-            if( m_sortedFunctions.empty() )
+            if( !m_checkedForDuplicates ) {
                 enforceNoDuplicateTestCases( m_functions );
-
-            if(  m_currentSortOrder != config.runOrder() || m_sortedFunctions.empty() ) {
-                m_sortedFunctions = sortTests( config, m_functions );
-                m_currentSortOrder = config.runOrder();
+                m_checkedForDuplicates = true;
             }
+
+            if( config.runOrder() == RunTests::InDeclarationOrder )
+                return m_functions;
+            m_sortedFunctions = sortTests( config, m_functions );
             return m_sortedFunctions;
         }
 
     private:
         std::vector<TestCase> m_functions;
-        mutable RunTests::InWhatOrder m_currentSortOrder;
+        mutable bool m_checkedForDuplicates;
         mutable std::vector<TestCase> m_sortedFunctions;
         size_t m_unnamedCount;
         std::ios_base::Init m_ostreamInit; // Forces cout/ cerr to be initialised
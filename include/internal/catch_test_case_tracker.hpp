@@ -12,6 +12,7 @@
 #include "catch_ptr.hpp"
 
 #include <map>
+#include <algorithm>
 #include <string>
 #include <assert.h>
 #include <vector>
@@ -19,6 +20,20 @@
 namespace Catch {
 namespace TestCaseTracking {
 
+    // What a tracker and those within it have run so far, so the run can be
+    // carried on by another process (see catch_section_checkpoint.hpp)
+    struct TrackerState {
+        TrackerState() : runState( 0 ), complete( false ), isIndexTracker( false ), index( -1 ), size( 0 ) {}
+
+        std::string name;
+        int runState;
+        bool complete;
+        bool isIndexTracker;
+        int index; // Of index trackers
+        int size;
+        std::vector<TrackerState> children;
+    };
+
     struct ITracker : SharedImpl<> {
         virtual ~ITracker();
 
@@ -41,6 +56,10 @@ namespace TestCaseTracking {
         virtual void addChild( Ptr<ITracker> const& child ) = 0;
         virtual ITracker* findChild( std::string const& name ) = 0;
         virtual void openChild() = 0;
+
+        // Of this tracker and all those within it
+        virtual TrackerState state() const = 0;
+        virtual void restore( TrackerState const& state ) = 0;
         
         // Debug/ checking
         virtual bool isSectionTracker() const = 0;
@@ -117,6 +136,11 @@ namespace TestCaseTracking {
                 return tracker->name() == m_name;
             }
         };
+        struct IsIncomplete {
+            bool operator ()( Ptr<ITracker> const& tracker ) const {
+                return !tracker->isComplete();
+            }
+        };
         typedef std::vector<Ptr<ITracker> > Children;
         std::string m_name;
         TrackerContext& m_ctx;
@@ -172,6 +196,17 @@ namespace TestCaseTracking {
             }
         }
 
+        virtual TrackerState state() const CATCH_OVERRIDE {
+            TrackerState state;
+            state.name = m_name;
+            state.runState = m_runState;
+            state.complete = isComplete();
+            for( Children::const_iterator it = m_children.begin(), itEnd = m_children.end(); it != itEnd; ++it )
+                state.children.push_back( (*it)->state() );
+            return state;
+        }
+        virtual void restore( TrackerState const& state ) CATCH_OVERRIDE;
+
         virtual bool isSectionTracker() const CATCH_OVERRIDE { return false; }
         virtual bool isIndexTracker() const CATCH_OVERRIDE { return false; }
         
@@ -201,7 +236,9 @@ namespace TestCaseTracking {
                     m_runState = CompletedSuccessfully;
                     break;
                 case ExecutingChildren:
-                    if( m_children.empty() || m_children.back()->isComplete() )
+                    // Not just the last child: sections off a selected path
+                    // count as complete before the ones ahead of them are
+                    if( std::find_if( m_children.begin(), m_children.end(), IsIncomplete() ) == m_children.end() )
                         m_runState = CompletedSuccessfully;
                     break;
 
@@ -232,14 +269,45 @@ namespace TestCaseTracking {
     };
 
     class SectionTracker : public TrackerBase {
+        std::vector<std::string> m_filters; // The path the sections within this one must follow
+        bool m_skipped;
     public:
         SectionTracker( std::string const& name, TrackerContext& ctx, ITracker* parent )
-        :   TrackerBase( name, ctx, parent )
-        {}
+        :   TrackerBase( name, ctx, parent ),
+            m_skipped( false )
+        {
+            if( parent ) {
+                while( !parent->isSectionTracker() )
+                    parent = &parent->parent();
+                std::vector<std::string> const& filters = static_cast<SectionTracker*>( parent )->m_filters;
+                if( !filters.empty() ) {
+                    if( sectionName( name ) == filters.front() )
+                        m_filters.assign( filters.begin()+1, filters.end() );
+                    else
+                        m_skipped = true;
+                }
+            }
+        }
         virtual ~SectionTracker();
 
         virtual bool isSectionTracker() const CATCH_OVERRIDE { return true; }
-        
+
+        // A section off the selected path, or run by another process, is never
+        // opened, but counts as complete so that its parent does not need
+        // another run for it
+        virtual bool isComplete() const CATCH_OVERRIDE {
+            return m_skipped || TrackerBase::isComplete();
+        }
+        void skip() {
+            m_skipped = true;
+        }
+
+        // Only the sections along this path, one name per level, are entered
+        // from now on; those within the last of them all are
+        void selectPath( std::vector<std::string> const& sectionNames ) {
+            m_filters = sectionNames;
+        }
+
         static SectionTracker& acquire( TrackerContext& ctx, std::string const& name ) {
             SectionTracker* section = CATCH_NULL;
 
@@ -259,6 +327,12 @@ namespace TestCaseTracking {
             }
             return *section;
         }
+
+    private:
+        // Sections are tracked as name@location
+        static std::string sectionName( std::string const& trackerName ) {
+            return trackerName.substr( 0, trackerName.rfind( '@' ) );
+        }
     };
 
     class IndexTracker : public TrackerBase {
@@ -299,6 +373,18 @@ namespace TestCaseTracking {
 
         int index() const { return m_index; }
 
+        virtual TrackerState state() const CATCH_OVERRIDE {
+            TrackerState state = TrackerBase::state();
+            state.isIndexTracker = true;
+            state.index = m_index;
+            state.size = m_size;
+            return state;
+        }
+        virtual void restore( TrackerState const& state ) CATCH_OVERRIDE {
+            TrackerBase::restore( state );
+            m_index = state.index;
+        }
+
         void moveNext() {
             m_index++;
             m_children.clear();
@@ -311,6 +397,20 @@ namespace TestCaseTracking {
         }
     };
 
+    inline void TrackerBase::restore( TrackerState const& state ) {
+        m_runState = static_cast<CycleState>( state.runState );
+        m_children.clear();
+        for( std::vector<TrackerState>::const_iterator it = state.children.begin(), itEnd = state.children.end(); it != itEnd; ++it ) {
+            Ptr<ITracker> child;
+            if( it->isIndexTracker )
+                child = new IndexTracker( it->name, m_ctx, this, it->size );
+            else
+                child = new SectionTracker( it->name, m_ctx, this );
+            m_children.push_back( child );
+            child->restore( *it );
+        }
+    }
+
     inline ITracker& TrackerContext::startRun() {
         m_rootTracker = new SectionTracker( "{root}", *this, CATCH_NULL );
         m_currentTracker = CATCH_NULL;
@@ -321,6 +421,7 @@ namespace TestCaseTracking {
 } // namespace TestCaseTracking
 
 using TestCaseTracking::ITracker;
+using TestCaseTracking::TrackerState;
 using TestCaseTracking::TrackerContext;
 using TestCaseTracking::SectionTracker;
 using TestCaseTracking::IndexTracker;
@@ -0,0 +1,703 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_TEST_EVENT_STREAM_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_TEST_EVENT_STREAM_HPP_INCLUDED
+
+#include "catch_interfaces_reporter.h"
+#include "catch_assertionresult.h"
+#include "catch_platform.h"
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <stdexcept>
+#include <stdint.h>
+
+#ifndef CATCH_PLATFORM_WINDOWS
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+namespace Catch {
+
+    // The reporter events of one test case, flattened into a byte string so
+    // they can be sent to another process (or kept aside) and replayed later.
+    // Both ends are always the same binary, so values are copied raw.
+    struct TestEvent { enum Type {
+        SectionStarting = 1,
+        AssertionEnded,
+        SectionEnded,
+        TestCaseEnded,
+        BenchmarkEnded,
+        BenchmarkCompared,
+        BenchmarkFitted,
+        BenchmarkScaled
+    }; };
+
+    // Events travel between processes in frames: a 32 bit payload length,
+    // a frame kind and the payload itself
+    struct EventFrame { enum Kind {
+        Events = 0,
+        TestEnded = 1,
+        TestStarting = 2,
+        // The output of a test run, sent to the client of a test server
+        StandardOutput = 3,
+        StandardError = 4,
+        ExitCode = 5,
+        // The end of a pass through a test case from a section checkpoint,
+        // with the state of its sections
+        PassEnded = 6
+    }; };
+
+    class TestEventWriter {
+    public:
+        void writeType( TestEvent::Type type ) {
+            writeRaw( static_cast<unsigned char>( type ) );
+        }
+        void write( std::string const& value ) {
+            write( value.size() );
+            m_data.append( value );
+        }
+        void write( std::size_t value ) { writeRaw( static_cast<uint64_t>( value ) ); }
+        void write( int value ) { writeRaw( value ); }
+        void write( double value ) { writeRaw( value ); }
+        void write( bool value ) { writeRaw( static_cast<unsigned char>( value ? 1 : 0 ) ); }
+        void write( SourceLineInfo const& lineInfo ) {
+            write( lineInfo.file );
+            write( lineInfo.line );
+        }
+        void write( Counts const& counts ) {
+            write( counts.passed );
+            write( counts.failed );
+            write( counts.failedButOk );
+        }
+        void write( Totals const& totals ) {
+            write( totals.assertions );
+            write( totals.testCases );
+        }
+        void write( SectionInfo const& info ) {
+            write( info.name );
+            write( info.description );
+            write( info.lineInfo );
+        }
+        void write( MessageInfo const& info ) {
+            write( info.macroName );
+            write( info.lineInfo );
+            write( static_cast<int>( info.type ) );
+            write( info.message );
+            write( static_cast<std::size_t>( info.sequence ) );
+        }
+        void write( BenchmarkEstimate const& estimate ) {
+            write( estimate.point );
+            write( estimate.lowerBound );
+            write( estimate.upperBound );
+            write( estimate.confidenceInterval );
+        }
+        void write( BenchmarkStats const& stats ) {
+            write( stats.name );
+            write( stats.lineInfo );
+            write( stats.iterations );
+            write( stats.resamples );
+            write( stats.clockResolution );
+            write( stats.clockOverhead );
+            write( stats.samples.size() );
+            for( std::vector<double>::const_iterator it = stats.samples.begin(), itEnd = stats.samples.end(); it != itEnd; ++it )
+                write( *it );
+            write( stats.mean );
+            write( stats.median );
+            write( stats.standardDeviation );
+            write( stats.outliers.samplesSeen );
+            write( stats.outliers.lowSevere );
+            write( stats.outliers.lowMild );
+            write( stats.outliers.highMild );
+            write( stats.outliers.highSevere );
+        }
+        void write( BenchmarkComparisonStats const& stats ) {
+            write( stats.oldName );
+            write( stats.newName );
+            write( stats.lineInfo );
+            write( stats.samples );
+            write( stats.ratio );
+            write( stats.z );
+            write( stats.pNewSlower );
+            write( stats.pNewFaster );
+        }
+        void write( BenchmarkComplexityStats const& stats ) {
+            write( stats.name );
+            write( stats.lineInfo );
+            write( stats.sizes.size() );
+            for( std::size_t i = 0; i < stats.sizes.size(); ++i ) {
+                write( stats.sizes[i] );
+                write( stats.medians[i] );
+            }
+            write( stats.fits.size() );
+            for( std::vector<ComplexityFit>::const_iterator it = stats.fits.begin(), itEnd = stats.fits.end(); it != itEnd; ++it )
+                write( *it );
+            write( stats.best );
+        }
+        void write( ComplexityFit const& fit ) {
+            write( static_cast<int>( fit.order ) );
+            write( fit.coefficient );
+            write( fit.rms );
+        }
+        void write( BenchmarkScalingStats const& stats ) {
+            write( stats.name );
+            write( stats.lineInfo );
+            write( stats.iterations );
+            write( stats.samples );
+            write( stats.threadCounts.size() );
+            for( std::vector<BenchmarkThreadScaling>::const_iterator it = stats.threadCounts.begin(), itEnd = stats.threadCounts.end(); it != itEnd; ++it ) {
+                write( it->threads );
+                write( it->medianTime );
+                write( it->opsPerSecond );
+                write( it->opsPerSecondPerThread );
+                write( it->efficiency );
+            }
+        }
+        void write( AssertionResult const& result );
+
+        std::string const& data() const { return m_data; }
+        bool empty() const { return m_data.empty(); }
+        void clear() { m_data.clear(); }
+
+    private:
+        template<typename T>
+        void writeRaw( T const& value ) {
+            m_data.append( reinterpret_cast<char const*>( &value ), sizeof( T ) );
+        }
+        std::string m_data;
+    };
+
+    class TestEventReader {
+    public:
+        TestEventReader( std::string const& data ) : m_data( data ), m_pos( 0 ) {}
+
+        bool atEnd() const { return m_pos >= m_data.size(); }
+
+        TestEvent::Type readType() {
+            return static_cast<TestEvent::Type>( readRaw<unsigned char>() );
+        }
+        std::string readString() {
+            std::size_t size = readSize();
+            require( size );
+            std::string value = m_data.substr( m_pos, size );
+            m_pos += size;
+            return value;
+        }
+        std::size_t readSize() { return static_cast<std::size_t>( readRaw<uint64_t>() ); }
+        int readInt() { return readRaw<int>(); }
+        double readDouble() { return readRaw<double>(); }
+        bool readBool() { return readRaw<unsigned char>() != 0; }
+        SourceLineInfo readLineInfo() {
+            SourceLineInfo lineInfo;
+            lineInfo.file = readString();
+            lineInfo.line = readSize();
+            return lineInfo;
+        }
+        Counts readCounts() {
+            Counts counts;
+            counts.passed = readSize();
+            counts.failed = readSize();
+            counts.failedButOk = readSize();
+            return counts;
+        }
+        Totals readTotals() {
+            Totals totals;
+            totals.assertions = readCounts();
+            totals.testCases = readCounts();
+            return totals;
+        }
+        SectionInfo readSectionInfo() {
+            std::string name = readString();
+            std::string description = readString();
+            return SectionInfo( readLineInfo(), name, description );
+        }
+        MessageInfo readMessageInfo() {
+            std::string macroName = readString();
+            SourceLineInfo lineInfo = readLineInfo();
+            ResultWas::OfType type = static_cast<ResultWas::OfType>( readInt() );
+            MessageInfo info( macroName, lineInfo, type );
+            info.message = readString();
+            info.sequence = static_cast<unsigned int>( readSize() );
+            return info;
+        }
+        BenchmarkEstimate readBenchmarkEstimate() {
+            BenchmarkEstimate estimate;
+            estimate.point = readDouble();
+            estimate.lowerBound = readDouble();
+            estimate.upperBound = readDouble();
+            estimate.confidenceInterval = readDouble();
+            return estimate;
+        }
+        BenchmarkStats readBenchmarkStats() {
+            std::string name = readString();
+            BenchmarkStats stats( name, readLineInfo() );
+            stats.iterations = readSize();
+            stats.resamples = readSize();
+            stats.clockResolution = readDouble();
+            stats.clockOverhead = readDouble();
+            stats.samples.resize( readSize() );
+            for( std::vector<double>::iterator it = stats.samples.begin(), itEnd = stats.samples.end(); it != itEnd; ++it )
+                *it = readDouble();
+            stats.mean = readBenchmarkEstimate();
+            stats.median = readDouble();
+            stats.standardDeviation = readBenchmarkEstimate();
+            stats.outliers.samplesSeen = readSize();
+            stats.outliers.lowSevere = readSize();
+            stats.outliers.lowMild = readSize();
+            stats.outliers.highMild = readSize();
+            stats.outliers.highSevere = readSize();
+            return stats;
+        }
+        BenchmarkComparisonStats readBenchmarkComparisonStats() {
+            std::string oldName = readString();
+            std::string newName = readString();
+            BenchmarkComparisonStats stats( oldName, newName, readLineInfo() );
+            stats.samples = readSize();
+            stats.ratio = readBenchmarkEstimate();
+            stats.z = readDouble();
+            stats.pNewSlower = readDouble();
+            stats.pNewFaster = readDouble();
+            return stats;
+        }
+        ComplexityFit readComplexityFit() {
+            ComplexityFit fit( static_cast<Complexity::Order>( readInt() ) );
+            fit.coefficient = readDouble();
+            fit.rms = readDouble();
+            return fit;
+        }
+        BenchmarkComplexityStats readBenchmarkComplexityStats() {
+            std::string name = readString();
+            BenchmarkComplexityStats stats( name, readLineInfo() );
+            std::size_t sizes = readSize();
+            for( std::size_t i = 0; i < sizes; ++i ) {
+                stats.sizes.push_back( readSize() );
+                stats.medians.push_back( readDouble() );
+            }
+            std::size_t fits = readSize();
+            for( std::size_t i = 0; i < fits; ++i )
+                stats.fits.push_back( readComplexityFit() );
+            stats.best = readComplexityFit();
+            return stats;
+        }
+        BenchmarkScalingStats readBenchmarkScalingStats() {
+            std::string name = readString();
+            BenchmarkScalingStats stats( name, readLineInfo() );
+            stats.iterations = readSize();
+            stats.samples = readSize();
+            stats.threadCounts.resize( readSize() );
+            for( std::vector<BenchmarkThreadScaling>::iterator it = stats.threadCounts.begin(), itEnd = stats.threadCounts.end(); it != itEnd; ++it ) {
+                it->threads = readSize();
+                it->medianTime = readDouble();
+                it->opsPerSecond = readDouble();
+                it->opsPerSecondPerThread = readDouble();
+                it->efficiency = readDouble();
+            }
+            return stats;
+        }
+        AssertionResult readAssertionResult();
+
+    private:
+        void require( std::size_t size ) const {
+            if( m_data.size() - m_pos < size )
+                throw std::runtime_error( "Truncated test event stream" );
+        }
+        template<typename T>
+        T readRaw() {
+            require( sizeof( T ) );
+            T value;
+            std::memcpy( &value, m_data.data() + m_pos, sizeof( T ) );
+            m_pos += sizeof( T );
+            return value;
+        }
+        std::string const& m_data;
+        std::size_t m_pos;
+    };
+
+    namespace Detail {
+        // AssertionResult keeps its parts to itself
+        struct AssertionResultParts : AssertionResult {
+            AssertionResultParts( AssertionResult const& result ) : AssertionResult( result ) {}
+            AssertionInfo const& info() const { return m_info; }
+            AssertionResultData const& data() const { return m_resultData; }
+        };
+    }
+
+    inline void TestEventWriter::write( AssertionResult const& result ) {
+        Detail::AssertionResultParts parts( result );
+        write( parts.info().macroName );
+        write( parts.info().lineInfo );
+        write( parts.info().capturedExpression );
+        write( static_cast<int>( parts.info().resultDisposition ) );
+        write( parts.data().reconstructedExpression );
+        write( parts.data().message );
+        write( static_cast<int>( parts.data().resultType ) );
+    }
+
+    inline AssertionResult TestEventReader::readAssertionResult() {
+        std::string macroName = readString();
+        SourceLineInfo lineInfo = readLineInfo();
+        std::string capturedExpression = readString();
+        ResultDisposition::Flags disposition = static_cast<ResultDisposition::Flags>( readInt() );
+        AssertionResultData data;
+        data.reconstructedExpression = readString();
+        data.message = readString();
+        data.resultType = static_cast<ResultWas::OfType>( readInt() );
+        return AssertionResult( AssertionInfo( macroName, lineInfo, capturedExpression, disposition ), data );
+    }
+
+#ifndef CATCH_PLATFORM_WINDOWS
+    inline bool writeAllToFd( int fd, char const* data, std::size_t size ) {
+        while( size > 0 ) {
+            ssize_t written = ::write( fd, data, size );
+            if( written < 0 ) {
+                if( errno == EINTR )
+                    continue;
+                return false;
+            }
+            data += written;
+            size -= static_cast<std::size_t>( written );
+        }
+        return true;
+    }
+    inline bool writeFrame( int fd, EventFrame::Kind kind, std::string const& payload ) {
+        std::string frame;
+        uint32_t size = static_cast<uint32_t>( payload.size() );
+        frame.append( reinterpret_cast<char const*>( &size ), sizeof( size ) );
+        frame.push_back( static_cast<char>( kind ) );
+        frame.append( payload );
+        return writeAllToFd( fd, frame.data(), frame.size() );
+    }
+#endif
+
+    // Splits whatever has been read from a pipe so far into whole frames
+    class EventFrameBuffer {
+    public:
+        void append( char const* data, std::size_t size ) { m_buffer.append( data, size ); }
+
+        bool nextFrame( EventFrame::Kind& kind, std::string& payload ) {
+            static const std::size_t headerSize = sizeof( uint32_t ) + 1;
+            if( m_buffer.size() < headerSize )
+                return false;
+            uint32_t size;
+            std::memcpy( &size, m_buffer.data(), sizeof( size ) );
+            if( m_buffer.size() < headerSize + size )
+                return false;
+            kind = static_cast<EventFrame::Kind>( m_buffer[sizeof( size )] );
+            payload = m_buffer.substr( headerSize, size );
+            m_buffer.erase( 0, headerSize + size );
+            return true;
+        }
+        void clear() { m_buffer.clear(); }
+
+    private:
+        std::string m_buffer;
+    };
+
+    // Records the events of each test case instead of reporting them.
+    // Events are handed to the sink as they are flushed - at the end of each
+    // section, so little is lost if the process dies part way through a test
+    struct ITestEventSink {
+        virtual ~ITestEventSink() {}
+        virtual void eventsFlushed( std::string const& events, bool testCaseEnded ) = 0;
+    };
+
+    // Keeps the events of a test case run in this process, to be replayed
+    struct RecordingEventSink : ITestEventSink {
+        virtual void eventsFlushed( std::string const& flushed, bool ) CATCH_OVERRIDE {
+            events += flushed;
+        }
+        std::string events;
+    };
+
+    class SerialisingReporter : public SharedImpl<IStreamingReporter> {
+    public:
+        SerialisingReporter( ITestEventSink& sink, ReporterPreferences const& preferences )
+        :   m_sink( sink ),
+            m_preferences( preferences )
+        {}
+
+        virtual ReporterPreferences getPreferences() const CATCH_OVERRIDE {
+            return m_preferences;
+        }
+
+        // Run and group level events belong to whoever replays the tests
+        virtual void noMatchingTestCases( std::string const& ) CATCH_OVERRIDE {}
+        virtual void testRunStarting( TestRunInfo const& ) CATCH_OVERRIDE {}
+        virtual void testGroupStarting( GroupInfo const& ) CATCH_OVERRIDE {}
+        virtual void testGroupEnded( TestGroupStats const& ) CATCH_OVERRIDE {}
+        virtual void testRunEnded( TestRunStats const& ) CATCH_OVERRIDE {}
+        virtual void skipTest( TestCaseInfo const& ) CATCH_OVERRIDE {}
+        virtual void testCaseStarting( TestCaseInfo const& ) CATCH_OVERRIDE {}
+        virtual void assertionStarting( AssertionInfo const& ) CATCH_OVERRIDE {}
+
+        virtual void sectionStarting( SectionInfo const& sectionInfo ) CATCH_OVERRIDE {
+            m_writer.writeType( TestEvent::SectionStarting );
+            m_writer.write( sectionInfo );
+        }
+        virtual bool assertionEnded( AssertionStats const& assertionStats ) CATCH_OVERRIDE {
+            m_writer.writeType( TestEvent::AssertionEnded );
+            m_writer.write( assertionStats.assertionResult );
+            m_writer.write( assertionStats.infoMessages.size() );
+            for( std::vector<MessageInfo>::const_iterator it = assertionStats.infoMessages.begin(), itEnd = assertionStats.infoMessages.end();
+                    it != itEnd;
+                    ++it )
+                m_writer.write( *it );
+            // Whether the messages get cleared is up to the reporter the events
+            // are replayed into, so keep them all and let the replay filter them
+            return false;
+        }
+        virtual void benchmarkEnded( BenchmarkStats const& benchmarkStats ) CATCH_OVERRIDE {
+            m_writer.writeType( TestEvent::BenchmarkEnded );
+            m_writer.write( benchmarkStats );
+        }
+        virtual void benchmarkCompared( BenchmarkComparisonStats const& comparisonStats ) CATCH_OVERRIDE {
+            m_writer.writeType( TestEvent::BenchmarkCompared );
+            m_writer.write( comparisonStats );
+        }
+        virtual void benchmarkFitted( BenchmarkComplexityStats const& complexityStats ) CATCH_OVERRIDE {
+            m_writer.writeType( TestEvent::BenchmarkFitted );
+            m_writer.write( complexityStats );
+        }
+        virtual void benchmarkScaled( BenchmarkScalingStats const& scalingStats ) CATCH_OVERRIDE {
+            m_writer.writeType( TestEvent::BenchmarkScaled );
+            m_writer.write( scalingStats );
+        }
+        virtual void sectionEnded( SectionStats const& sectionStats ) CATCH_OVERRIDE {
+            m_writer.writeType( TestEvent::SectionEnded );
+            m_writer.write( sectionStats.sectionInfo );
+            m_writer.write( sectionStats.assertions );
+            m_writer.write( sectionStats.durationInSeconds );
+            m_writer.write( sectionStats.missingAssertions );
+            flush( false );
+        }
+        virtual void testCaseEnded( TestCaseStats const& testCaseStats ) CATCH_OVERRIDE {
+            m_writer.writeType( TestEvent::TestCaseEnded );
+            m_writer.write( testCaseStats.totals );
+            m_writer.write( testCaseStats.stdOut );
+            m_writer.write( testCaseStats.stdErr );
+            m_writer.write( testCaseStats.aborting );
+            m_writer.write( testCaseStats.peakMemoryKb );
+            m_writer.write( testCaseStats.placement.cpu );
+            m_writer.write( testCaseStats.placement.numaNode );
+            flush( true );
+        }
+
+    private:
+        void flush( bool testCaseEnded ) {
+            if( !m_writer.empty() || testCaseEnded )
+                m_sink.eventsFlushed( m_writer.data(), testCaseEnded );
+            m_writer.clear();
+        }
+
+        ITestEventSink& m_sink;
+        ReporterPreferences m_preferences;
+        TestEventWriter m_writer;
+    };
+
+    // Feeds recorded events back into a real reporter. The running totals seen
+    // by the reporter are rebuilt from the assertions, starting at baseTotals,
+    // so they read as if the test had been run in this process
+    class TestEventReplayer {
+    public:
+        TestEventReplayer( IStreamingReporter& reporter, TestCaseInfo const& testInfo, Totals const& baseTotals )
+        :   m_reporter( reporter ),
+            m_testInfo( testInfo ),
+            m_runningTotals( baseTotals ),
+            m_messagesClearedUpTo( 0 ),
+            m_testCaseEnded( false ),
+            m_replayingPass( false ),
+            m_retryOutcome( RetryOutcome::NotRetried ),
+            m_retries( 0 )
+        {}
+
+        // Reported along with the end of the test case
+        void setRetryOutcome( RetryOutcome::Kind retryOutcome, std::size_t retries ) {
+            m_retryOutcome = retryOutcome;
+            m_retries = retries;
+        }
+
+        // Replays the events of a single pass through the test case, which start
+        // within the sections opened with openSection(). The test case is left
+        // to be ended by whoever replays it, unless the pass ended it there and
+        // then - when a fatal error was reported
+        void replayPass( std::string const& events ) {
+            m_replayingPass = true;
+            replay( events );
+        }
+
+        void replay( std::string const& events ) {
+            TestEventReader reader( events );
+            while( !reader.atEnd() && !m_testCaseEnded ) {
+                switch( reader.readType() ) {
+                    case TestEvent::SectionStarting: {
+                        SectionInfo sectionInfo = reader.readSectionInfo();
+                        m_openSections.push_back( SectionEndInfo( sectionInfo, m_assertions, 0 ) );
+                        m_reporter.sectionStarting( sectionInfo );
+                        break;
+                    }
+                    case TestEvent::AssertionEnded: {
+                        AssertionResult result = reader.readAssertionResult();
+                        std::vector<MessageInfo> messages;
+                        for( std::size_t i = reader.readSize(); i > 0; --i ) {
+                            MessageInfo message = reader.readMessageInfo();
+                            if( message.sequence > m_messagesClearedUpTo )
+                                messages.push_back( message );
+                        }
+                        countAssertion( result );
+                        AssertionStats stats( result, std::vector<MessageInfo>(), m_runningTotals );
+                        stats.infoMessages = messages;
+                        if( m_reporter.assertionEnded( stats ) && !messages.empty() )
+                            m_messagesClearedUpTo = messages.back().sequence;
+                        m_lastLineInfo = result.getSourceInfo();
+                        break;
+                    }
+                    case TestEvent::BenchmarkEnded:
+                        m_reporter.benchmarkEnded( reader.readBenchmarkStats() );
+                        break;
+                    case TestEvent::BenchmarkCompared:
+                        m_reporter.benchmarkCompared( reader.readBenchmarkComparisonStats() );
+                        break;
+                    case TestEvent::BenchmarkFitted:
+                        m_reporter.benchmarkFitted( reader.readBenchmarkComplexityStats() );
+                        break;
+                    case TestEvent::BenchmarkScaled:
+                        m_reporter.benchmarkScaled( reader.readBenchmarkScalingStats() );
+                        break;
+                    case TestEvent::SectionEnded: {
+                        SectionInfo sectionInfo = reader.readSectionInfo();
+                        Counts assertions = reader.readCounts();
+                        double duration = reader.readDouble();
+                        bool missingAssertions = reader.readBool();
+                        // A fatal error ends the test case section with inner sections
+                        // still open. Sections left by an exception end outermost first,
+                        // so otherwise only their number can be relied on, not their order
+                        if( isOutermostSection( sectionInfo ) )
+                            while( m_openSections.size() > 1 )
+                                endInnermostSection();
+                        if( !m_openSections.empty() )
+                            m_openSections.pop_back();
+                        m_reporter.sectionEnded( SectionStats( sectionInfo, assertions, duration, missingAssertions ) );
+                        break;
+                    }
+                    case TestEvent::TestCaseEnded: {
+                        m_testCaseTotals = reader.readTotals();
+                        std::string stdOut = reader.readString();
+                        std::string stdErr = reader.readString();
+                        bool aborting = reader.readBool();
+                        std::size_t peakMemoryKb = reader.readSize();
+                        CpuPlacement placement;
+                        placement.cpu = reader.readInt();
+                        placement.numaNode = reader.readInt();
+                        while( !m_openSections.empty() )
+                            endInnermostSection();
+                        if( m_replayingPass )
+                            m_testCaseEnded = true;
+                        else {
+                            TestCaseStats stats( m_testInfo, m_testCaseTotals, stdOut, stdErr, aborting );
+                            stats.peakMemoryKb = peakMemoryKb;
+                            stats.placement = placement;
+                            endTestCase( stats );
+                        }
+                        break;
+                    }
+                    default:
+                        throw std::runtime_error( "Corrupt test event stream" );
+                }
+            }
+        }
+
+        // Opens a section the events of a pass start within (the test case's
+        // own, say), reporting it as starting unless that was already done
+        void openSection( SectionInfo const& sectionInfo, bool alreadyReported ) {
+            m_openSections.push_back( SectionEndInfo( sectionInfo, m_assertions, 0 ) );
+            if( !alreadyReported )
+                m_reporter.sectionStarting( sectionInfo );
+        }
+
+        // The events stopped before the test case ended - the process running it
+        // died. Report that as a fatal error in whatever was running at the time
+        // and close everything that was left open
+        void interrupt( std::string const& message ) {
+            if( m_testCaseEnded )
+                return;
+
+            interruptPass( message );
+
+            m_testCaseTotals = Totals();
+            m_testCaseTotals.assertions = m_assertions;
+            m_testCaseTotals.testCases.failed = 1;
+            endTestCase( TestCaseStats( m_testInfo, m_testCaseTotals, "", "", false ) );
+        }
+        // As above, but leaving the test case to be ended by whoever replays it
+        void interruptPass( std::string const& message ) {
+            AssertionResultData data;
+            data.resultType = ResultWas::FatalErrorCondition;
+            data.message = message;
+            SourceLineInfo lineInfo = m_lastLineInfo.empty() ? m_testInfo.lineInfo : m_lastLineInfo;
+            AssertionResult result( AssertionInfo( "", lineInfo, "", ResultDisposition::Normal ), data );
+            countAssertion( result );
+
+            if( m_openSections.empty() ) {
+                SectionInfo testCaseSection( m_testInfo.lineInfo, m_testInfo.name, m_testInfo.description );
+                m_openSections.push_back( SectionEndInfo( testCaseSection, Counts(), 0 ) );
+                m_reporter.sectionStarting( testCaseSection );
+            }
+            m_reporter.assertionEnded( AssertionStats( result, std::vector<MessageInfo>(), m_runningTotals ) );
+
+            while( !m_openSections.empty() )
+                endInnermostSection();
+        }
+
+        bool testCaseEnded() const { return m_testCaseEnded; }
+        Totals const& testCaseTotals() const { return m_testCaseTotals; }
+        Counts const& assertions() const { return m_assertions; } // Those replayed so far
+
+    private:
+        bool isOutermostSection( SectionInfo const& sectionInfo ) const {
+            if( m_openSections.empty() )
+                return false;
+            SectionInfo const& outermost = m_openSections.front().sectionInfo;
+            return outermost.name == sectionInfo.name && outermost.lineInfo == sectionInfo.lineInfo;
+        }
+        void endTestCase( TestCaseStats stats ) {
+            stats.retryOutcome = m_retryOutcome;
+            stats.retries = m_retries;
+            m_reporter.testCaseEnded( stats );
+            m_testCaseEnded = true;
+        }
+        void endInnermostSection() {
+            SectionEndInfo const& endInfo = m_openSections.back();
+            m_reporter.sectionEnded( SectionStats( endInfo.sectionInfo, m_assertions - endInfo.prevAssertions, 0, false ) );
+            m_openSections.pop_back();
+        }
+        void countAssertion( AssertionResult const& result ) {
+            if( result.getResultType() == ResultWas::Ok ) {
+                m_assertions.passed++;
+                m_runningTotals.assertions.passed++;
+            }
+            else if( !result.isOk() ) {
+                m_assertions.failed++;
+                m_runningTotals.assertions.failed++;
+            }
+        }
+
+        IStreamingReporter& m_reporter;
+        TestCaseInfo m_testInfo;
+        Totals m_runningTotals;
+        Totals m_testCaseTotals;
+        Counts m_assertions;
+        std::vector<SectionEndInfo> m_openSections;
+        SourceLineInfo m_lastLineInfo;
+        unsigned int m_messagesClearedUpTo;
+        bool m_testCaseEnded;
+        bool m_replayingPass;
+        RetryOutcome::Kind m_retryOutcome;
+        std::size_t m_retries;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_TEST_EVENT_STREAM_HPP_INCLUDED
@@ -0,0 +1,168 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_TEST_IMPACT_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_TEST_IMPACT_HPP_INCLUDED
+
+#include "catch_run_history.hpp"
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+
+namespace Catch {
+
+    // Which source files each test case was seen to execute, as recorded by
+    // --record-impact, so that only the test cases a change can affect need be
+    // run. The file starts with the table of source files, one per line, each
+    // "file<tab>path" and numbered from 0 in turn; then there is one line per
+    // test case, "test<tab>(escaped) name<tab>" then the comma separated
+    // numbers of the files it executed
+    class TestImpactMap {
+    public:
+        TestImpactMap() : m_selecting( false ) {}
+
+        // A missing file is an empty map
+        void load( std::string const& filename ) {
+            std::ifstream f( filename.c_str() );
+            read( f );
+        }
+        void read( std::istream& is ) {
+            std::vector<std::size_t> fileIndices; // From the file's numbering to ours
+            std::string line;
+            while( std::getline( is, line ) ) {
+                std::string::size_type tab = line.find( '\t' );
+                if( tab == std::string::npos )
+                    continue;
+                std::string kind = line.substr( 0, tab );
+                if( kind == "file" )
+                    fileIndices.push_back( internFile( RunHistory::unescape( line.substr( tab+1 ) ) ) );
+                else if( kind == "test" ) {
+                    std::string::size_type filesTab = line.find( '\t', tab+1 );
+                    std::vector<std::size_t>& footprint = m_footprints[RunHistory::unescape( line.substr( tab+1, filesTab-tab-1 ) )];
+                    footprint.clear();
+                    if( filesTab == std::string::npos )
+                        continue;
+                    std::istringstream iss( line.substr( filesTab+1 ) );
+                    std::size_t index;
+                    char comma;
+                    while( iss >> index ) {
+                        if( index < fileIndices.size() )
+                            footprint.push_back( fileIndices[index] );
+                        iss >> comma;
+                    }
+                }
+            }
+        }
+
+        // Replaced whole, so an interrupted run cannot leave a truncated map
+        bool save( std::string const& filename ) const {
+            std::ostringstream oss;
+            write( oss );
+            return replaceFile( filename, oss.str() );
+        }
+        // Only the files some test case still executes are written, renumbered
+        void write( std::ostream& os ) const {
+            std::vector<std::size_t> numbers( m_files.size(), m_files.size() );
+            std::size_t written = 0;
+            os << "# Catch impact map\n";
+            for( std::map<std::string, std::vector<std::size_t> >::const_iterator it = m_footprints.begin(), itEnd = m_footprints.end(); it != itEnd; ++it ) {
+                for( std::size_t i = 0; i < it->second.size(); ++i ) {
+                    if( numbers[it->second[i]] == m_files.size() ) {
+                        numbers[it->second[i]] = written++;
+                        os << "file\t" << RunHistory::escape( m_files[it->second[i]] ) << '\n';
+                    }
+                }
+            }
+            for( std::map<std::string, std::vector<std::size_t> >::const_iterator it = m_footprints.begin(), itEnd = m_footprints.end(); it != itEnd; ++it ) {
+                os << "test\t" << RunHistory::escape( it->first ) << '\t';
+                for( std::size_t i = 0; i < it->second.size(); ++i )
+                    os << ( i > 0 ? "," : "" ) << numbers[it->second[i]];
+                os << '\n';
+            }
+        }
+
+        // Replaces whatever was recorded for the test case before
+        void recordFootprint( std::string const& testName, std::vector<std::string> const& files ) {
+            std::vector<std::size_t>& footprint = m_footprints[testName];
+            footprint.clear();
+            for( std::size_t i = 0; i < files.size(); ++i )
+                footprint.push_back( internFile( files[i] ) );
+        }
+        std::vector<std::string> footprint( std::string const& testName ) const {
+            std::vector<std::string> files;
+            std::map<std::string, std::vector<std::size_t> >::const_iterator it = m_footprints.find( testName );
+            if( it != m_footprints.end() )
+                for( std::size_t i = 0; i < it->second.size(); ++i )
+                    files.push_back( m_files[it->second[i]] );
+            return files;
+        }
+
+        // From now on only the test cases that executed one of these files are
+        // selected - and those not recorded yet, as nothing is known of them.
+        // Paths match when one is the other with leading directories removed, as
+        // a list of changes is usually relative to the top of the source tree
+        // while compilers record whatever path they were given
+        void selectImpactedBy( std::vector<std::string> const& changedFiles ) {
+            m_selecting = true;
+            m_impacted.clear();
+            std::vector<bool> changed( m_files.size(), false );
+            for( std::size_t i = 0; i < m_files.size(); ++i )
+                for( std::size_t j = 0; j < changedFiles.size() && !changed[i]; ++j )
+                    changed[i] = isSameFile( m_files[i], changedFiles[j] );
+            for( std::map<std::string, std::vector<std::size_t> >::const_iterator it = m_footprints.begin(), itEnd = m_footprints.end(); it != itEnd; ++it ) {
+                for( std::size_t i = 0; i < it->second.size(); ++i ) {
+                    if( changed[it->second[i]] ) {
+                        m_impacted.insert( it->first );
+                        break;
+                    }
+                }
+            }
+        }
+        bool selects( std::string const& testName ) const {
+            return !m_selecting ||
+                m_impacted.find( testName ) != m_impacted.end() ||
+                m_footprints.find( testName ) == m_footprints.end();
+        }
+
+        static bool isSameFile( std::string const& path1, std::string const& path2 ) {
+            std::string a = normalisePath( path1 ), b = normalisePath( path2 );
+            if( a.size() < b.size() )
+                std::swap( a, b );
+            return !b.empty() && a.compare( a.size() - b.size(), b.size(), b ) == 0 &&
+                ( a.size() == b.size() || a[a.size() - b.size() - 1] == '/' );
+        }
+
+    private:
+        static std::string normalisePath( std::string path ) {
+            for( std::string::iterator it = path.begin(), itEnd = path.end(); it != itEnd; ++it )
+                if( *it == '\\' )
+                    *it = '/';
+            while( path.compare( 0, 2, "./" ) == 0 )
+                path.erase( 0, 2 );
+            return path;
+        }
+        std::size_t internFile( std::string const& file ) {
+            std::unordered_map<std::string, std::size_t>::const_iterator it = m_fileIndices.find( file );
+            if( it != m_fileIndices.end() )
+                return it->second;
+            m_files.push_back( file );
+            return m_fileIndices[file] = m_files.size() - 1;
+        }
+
+        std::vector<std::string> m_files;
+        std::unordered_map<std::string, std::size_t> m_fileIndices;
+        std::map<std::string, std::vector<std::size_t> > m_footprints; // Indices into m_files
+        bool m_selecting;
+        std::unordered_set<std::string> m_impacted; // Looked up for every test case
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_TEST_IMPACT_HPP_INCLUDED
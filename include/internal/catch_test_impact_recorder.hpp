@@ -0,0 +1,212 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_TEST_IMPACT_RECORDER_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_TEST_IMPACT_RECORDER_HPP_INCLUDED
+
+#include "catch_test_impact.hpp"
+#include "catch_common.h"
+#include "catch_platform.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstdlib>
+#include <stdint.h>
+
+#if defined(__GNUC__) && !defined(CATCH_PLATFORM_WINDOWS)
+#define CATCH_INTERNAL_COVERAGE_HOOKS
+#endif
+
+namespace Catch {
+
+    namespace Detail {
+
+        // The state behind the sanitizer coverage hooks below. Code compiled
+        // with -fsanitize-coverage=trace-pc-guard gets a 32 bit guard for each
+        // of its edges, and calls the hook with it whenever the edge is taken.
+        // Each guard is given an id; while recording, the first call for a guard
+        // notes its id and zeroes it, so the guard costs next to nothing from
+        // then on. Only the guards noted are given their ids back at the end,
+        // which keeps resetting them between test cases proportional to what
+        // the test case executed, rather than to the size of the program.
+        // A thread left running by a test case may still be in the hook as
+        // recording stops: stop() closes the count of touched guards, so a
+        // hook that has zeroed its guard either gets a slot that stop() waits
+        // for and resets, or finds the count closed and resets the guard itself.
+        // Plain data, so it is usable before any constructor has run
+        struct CoverageGuards {
+            enum : uint32_t { Closed = 0x80000000u }; // In touchedCount, once stopped
+
+            uint32_t** guards;     // By id, from 1
+            uint32_t count;
+            uint32_t* touchedIds;  // The guards zeroed while recording. 0 until written
+            void** touchedPcs;     // Where each of them was called from
+            uint32_t touchedCount;
+            bool recording;
+
+            void start() {
+#ifdef CATCH_INTERNAL_COVERAGE_HOOKS
+                uint32_t previous = __atomic_load_n( &touchedCount, __ATOMIC_RELAXED ) & ~Closed;
+                for( uint32_t i = 0; i < previous; ++i )
+                    touchedIds[i] = 0;
+                __atomic_store_n( &touchedCount, 0, __ATOMIC_RELEASE );
+                __atomic_store_n( &recording, true, __ATOMIC_RELEASE );
+#endif
+            }
+            // Returns the number of guards touched, whose ids and call sites are
+            // then in touchedIds and touchedPcs until the next start()
+            uint32_t stop() {
+#ifdef CATCH_INTERNAL_COVERAGE_HOOKS
+                __atomic_store_n( &recording, false, __ATOMIC_RELEASE );
+                uint32_t touched = __atomic_fetch_or( &touchedCount, Closed, __ATOMIC_ACQ_REL );
+                for( uint32_t i = 0; i < touched; ++i ) {
+                    uint32_t id;
+                    while( ( id = __atomic_load_n( &touchedIds[i], __ATOMIC_ACQUIRE ) ) == 0 ) {} // Its hook is still writing it
+                    __atomic_store_n( guards[id], id, __ATOMIC_RELAXED );
+                }
+                return touched;
+#else
+                return 0;
+#endif
+            }
+        };
+
+        CoverageGuards coverageGuards;
+    }
+}
+
+#ifdef CATCH_INTERNAL_COVERAGE_HOOKS
+
+// The hooks are weak, so a fuzzer or coverage tool linked in takes precedence.
+// They must not be instrumented themselves, and only call builtins
+#if defined(__clang__)
+#define CATCH_INTERNAL_NOT_INSTRUMENTED __attribute__((no_sanitize("coverage")))
+#else
+#define CATCH_INTERNAL_NOT_INSTRUMENTED
+#endif
+
+// Called by each instrumented module as it is loaded
+extern "C" __attribute__((weak)) CATCH_INTERNAL_NOT_INSTRUMENTED
+void __sanitizer_cov_trace_pc_guard_init( uint32_t* start, uint32_t* stop ) {
+    Catch::Detail::CoverageGuards& state = Catch::Detail::coverageGuards;
+    if( start == stop || *start != 0 )
+        return; // Already done
+    uint32_t capacity = state.count + static_cast<uint32_t>( stop - start ) + 1;
+    state.guards = static_cast<uint32_t**>( std::realloc( state.guards, capacity * sizeof( uint32_t* ) ) );
+    state.touchedIds = static_cast<uint32_t*>( std::realloc( state.touchedIds, capacity * sizeof( uint32_t ) ) );
+    state.touchedPcs = static_cast<void**>( std::realloc( state.touchedPcs, capacity * sizeof( void* ) ) );
+    if( !state.guards || !state.touchedIds || !state.touchedPcs )
+        std::abort();
+    for( uint32_t i = state.count; i < capacity; ++i )
+        state.touchedIds[i] = 0;
+    for( uint32_t* guard = start; guard != stop; ++guard ) {
+        *guard = ++state.count;
+        state.guards[*guard] = guard;
+    }
+}
+
+extern "C" __attribute__((weak)) CATCH_INTERNAL_NOT_INSTRUMENTED
+void __sanitizer_cov_trace_pc_guard( uint32_t* guard ) {
+    Catch::Detail::CoverageGuards& state = Catch::Detail::coverageGuards;
+    if( !__atomic_load_n( &state.recording, __ATOMIC_RELAXED ) )
+        return;
+    uint32_t id = __atomic_exchange_n( guard, 0, __ATOMIC_RELAXED );
+    if( id == 0 )
+        return;
+    uint32_t slot = __atomic_fetch_add( &state.touchedCount, 1, __ATOMIC_ACQ_REL );
+    if( slot & Catch::Detail::CoverageGuards::Closed ) {
+        __atomic_store_n( guard, id, __ATOMIC_RELAXED ); // Recording stopped meanwhile
+        return;
+    }
+    state.touchedPcs[slot] = __builtin_return_address( 0 );
+    __atomic_store_n( &state.touchedIds[slot], id, __ATOMIC_RELEASE );
+}
+
+// Only there when a sanitizer runtime is linked in
+extern "C" __attribute__((weak))
+void __sanitizer_symbolize_pc( void* pc, char const* format, char* buffer, std::size_t bufferSize );
+
+#endif // CATCH_INTERNAL_COVERAGE_HOOKS
+
+namespace Catch {
+
+    // Records the source files each test case executes into an impact map, from
+    // the coverage of the edges it took. Each guard is looked up in the debug
+    // information only the first time any test case touches it
+    class ImpactRecorder : NonCopyable {
+    public:
+        ImpactRecorder( TestImpactMap& impactMap ) : m_impactMap( impactMap ) {
+#ifdef CATCH_INTERNAL_COVERAGE_HOOKS
+            if( Detail::coverageGuards.count == 0 )
+                throw std::domain_error( "--record-impact needs the tests to be compiled with -fsanitize-coverage=trace-pc-guard" );
+            if( !__sanitizer_symbolize_pc )
+                throw std::domain_error( "--record-impact needs a sanitizer runtime (e.g. -fsanitize=address) to tell which source files were executed" );
+#else
+            throw std::domain_error( "--record-impact is not supported with this compiler" );
+#endif
+        }
+
+        void testStarting() {
+            Detail::coverageGuards.start();
+        }
+
+        void testEnded( std::string const& testName ) {
+            uint32_t touched = Detail::coverageGuards.stop();
+            std::vector<bool> executed( m_files.size(), false );
+            std::vector<std::string> footprint;
+            for( uint32_t i = 0; i < touched; ++i ) {
+                int file = fileOf( Detail::coverageGuards.touchedIds[i], Detail::coverageGuards.touchedPcs[i] );
+                if( file < 0 )
+                    continue;
+                if( static_cast<std::size_t>( file ) >= executed.size() )
+                    executed.resize( m_files.size(), false );
+                if( !executed[file] ) {
+                    executed[file] = true;
+                    footprint.push_back( m_files[file] );
+                }
+            }
+            m_impactMap.recordFootprint( testName, footprint );
+        }
+
+    private:
+        enum { Unknown = -2, NoFile = -1 };
+
+        int fileOf( uint32_t guardId, void* pc ) {
+            if( m_guardFiles.size() <= guardId )
+                m_guardFiles.resize( Detail::coverageGuards.count + 1, Unknown );
+            int& file = m_guardFiles[guardId];
+            if( file == Unknown ) {
+                file = NoFile;
+#ifdef CATCH_INTERNAL_COVERAGE_HOOKS
+                char buffer[4096] = "";
+                // The call itself, rather than the instruction after it
+                __sanitizer_symbolize_pc( static_cast<char*>( pc ) - 1, "%s", buffer, sizeof( buffer ) );
+                std::string name = buffer;
+                if( !name.empty() && name[0] != '<' )
+                    file = internFile( name );
+#else
+                (void)pc;
+#endif
+            }
+            return file;
+        }
+        int internFile( std::string const& name ) {
+            std::unordered_map<std::string, int>::const_iterator it = m_fileIndices.find( name );
+            if( it != m_fileIndices.end() )
+                return it->second;
+            m_files.push_back( name );
+            return m_fileIndices[name] = static_cast<int>( m_files.size() - 1 );
+        }
+
+        TestImpactMap& m_impactMap;
+        std::vector<int> m_guardFiles; // Indices into m_files, by guard id
+        std::vector<std::string> m_files;
+        std::unordered_map<std::string, int> m_fileIndices;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_TEST_IMPACT_RECORDER_HPP_INCLUDED
@@ -0,0 +1,288 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_TEST_RESULT_CACHE_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_TEST_RESULT_CACHE_HPP_INCLUDED
+
+#include "catch_test_case_info.h"
+#include "catch_totals.hpp"
+#include "catch_option.hpp"
+#include "catch_common.h"
+#include "catch_platform.h"
+#include "catch_replace_file.hpp"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+#ifndef CATCH_PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__linux__) && defined(__GLIBC__)
+#define CATCH_INTERNAL_ELF_BUILD_ID
+#include <link.h>
+#include <elf.h>
+#endif
+
+namespace Catch {
+
+    namespace Detail {
+
+        // 64 bit FNV-1a, fed a piece at a time
+        class ContentHash {
+        public:
+            ContentHash() : m_hash( 14695981039346656037ULL ) {}
+
+            ContentHash& add( char const* data, std::size_t size ) {
+                for( std::size_t i = 0; i < size; ++i ) {
+                    m_hash ^= static_cast<unsigned char>( data[i] );
+                    m_hash *= 1099511628211ULL;
+                }
+                return *this;
+            }
+            ContentHash& add( std::string const& str ) {
+                return add( str.data(), str.size() ).add( "", 1 ); // So "ab"+"c" differs from "a"+"bc"
+            }
+            ContentHash& add( uint64_t value ) {
+                return add( reinterpret_cast<char const*>( &value ), sizeof( value ) );
+            }
+            uint64_t value() const { return m_hash; }
+
+        private:
+            uint64_t m_hash;
+        };
+
+        inline Option<uint64_t> hashFile( std::string const& filename ) {
+            std::ifstream f( filename.c_str(), std::ios::binary );
+            if( !f )
+                return Option<uint64_t>();
+            ContentHash hash;
+            char buffer[65536];
+            while( f.read( buffer, sizeof( buffer ) ) || f.gcount() > 0 )
+                hash.add( buffer, static_cast<std::size_t>( f.gcount() ) );
+            return hash.value();
+        }
+
+#ifdef CATCH_INTERNAL_ELF_BUILD_ID
+        inline int findBuildId( dl_phdr_info* info, std::size_t, void* buildId ) {
+            for( int i = 0; i < info->dlpi_phnum; ++i ) {
+                ElfW(Phdr) const& segment = info->dlpi_phdr[i];
+                if( segment.p_type != PT_NOTE )
+                    continue;
+                char const* note = reinterpret_cast<char const*>( info->dlpi_addr + segment.p_vaddr );
+                char const* end = note + segment.p_memsz;
+                while( note + sizeof( ElfW(Nhdr) ) <= end ) {
+                    ElfW(Nhdr) const* header = reinterpret_cast<ElfW(Nhdr) const*>( note );
+                    char const* name = note + sizeof( ElfW(Nhdr) );
+                    char const* desc = name + ( ( header->n_namesz + 3 ) & ~3u );
+                    if( header->n_type == NT_GNU_BUILD_ID && header->n_namesz == 4 && std::memcmp( name, "GNU", 4 ) == 0 ) {
+                        static_cast<std::string*>( buildId )->assign( desc, header->n_descsz );
+                        return 1;
+                    }
+                    note = desc + ( ( header->n_descsz + 3 ) & ~3u );
+                }
+            }
+            return 1; // The program itself comes first, and is the only one of interest
+        }
+#endif
+
+        // Identifies the build of the test binary: from the build id the linker
+        // put in it where there is one, or else from its contents
+        inline Option<uint64_t> hashBuild( std::string const& processName ) {
+#ifdef CATCH_INTERNAL_ELF_BUILD_ID
+            std::string buildId;
+            dl_iterate_phdr( findBuildId, &buildId );
+            if( !buildId.empty() )
+                return ContentHash().add( buildId ).value();
+            if( Option<uint64_t> hash = hashFile( "/proc/self/exe" ) )
+                return hash;
+#endif
+            return hashFile( processName );
+        }
+
+        // A read only view of a whole file, mapped into memory where possible
+        class MappedFile : NonCopyable {
+        public:
+            MappedFile() : m_data( CATCH_NULL ), m_size( 0 ) {}
+            ~MappedFile() {
+#ifndef CATCH_PLATFORM_WINDOWS
+                if( m_data && m_contents.empty() )
+                    munmap( const_cast<char*>( m_data ), m_size );
+#endif
+            }
+
+            bool open( std::string const& filename ) {
+#ifndef CATCH_PLATFORM_WINDOWS
+                int fd = ::open( filename.c_str(), O_RDONLY );
+                if( fd < 0 )
+                    return false;
+                struct stat info;
+                if( fstat( fd, &info ) == 0 && info.st_size > 0 ) {
+                    void* data = mmap( CATCH_NULL, static_cast<std::size_t>( info.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+                    if( data != MAP_FAILED ) {
+                        m_data = static_cast<char const*>( data );
+                        m_size = static_cast<std::size_t>( info.st_size );
+                    }
+                }
+                ::close( fd );
+                return m_data != CATCH_NULL;
+#else
+                std::ifstream f( filename.c_str(), std::ios::binary );
+                m_contents.assign( std::istreambuf_iterator<char>( f ), std::istreambuf_iterator<char>() );
+                m_data = m_contents.empty() ? CATCH_NULL : &m_contents[0];
+                m_size = m_contents.size();
+                return m_data != CATCH_NULL;
+#endif
+            }
+
+            char const* data() const { return m_data; }
+            std::size_t size() const { return m_size; }
+
+        private:
+            char const* m_data;
+            std::size_t m_size;
+            std::vector<char> m_contents; // Where files cannot be mapped
+        };
+    }
+
+    // Remembers which test cases passed, keyed by a hash of what they depend
+    // on: their name, the build of the test binary, their source file and any
+    // data files they declare with [data:<path>] tags. While none of these
+    // change, a test case that passed need not be run again.
+    // The index is a single file, mapped into memory as it is: a header, then
+    // fixed size entries sorted by the hash of the test name, so a lookup is a
+    // binary search and opening the cache costs nothing, however big it is
+    class TestResultCache {
+    public:
+        struct Entry {
+            uint64_t nameHash;
+            uint64_t contentHash;
+            uint64_t assertions;
+        };
+        struct EntryOrder {
+            bool operator() ( Entry const& entry, uint64_t nameHash ) const { return entry.nameHash < nameHash; }
+        };
+
+        TestResultCache() : m_entries( CATCH_NULL ), m_entryCount( 0 ) {}
+
+        // A missing or unreadable index is an empty cache
+        void open( std::string const& filename, std::string const& processName ) {
+            m_buildHash = Detail::hashBuild( processName );
+            if( !m_index.open( filename ) || m_index.size() < HeaderSize ||
+                    std::memcmp( m_index.data(), magic(), MagicSize ) != 0 )
+                return;
+            uint64_t count;
+            std::memcpy( &count, m_index.data() + MagicSize, sizeof( count ) );
+            if( m_index.size() != HeaderSize + count * sizeof( Entry ) )
+                return;
+            m_entries = reinterpret_cast<Entry const*>( m_index.data() + HeaderSize );
+            m_entryCount = static_cast<std::size_t>( count );
+        }
+
+        // The totals of a pass made with the same dependencies, if there was one
+        Option<Totals> cachedPass( TestCaseInfo const& testInfo ) {
+            Option<uint64_t> contentHash = hashDependencies( testInfo );
+            if( !contentHash )
+                return Option<Totals>();
+            uint64_t nameHash = Detail::ContentHash().add( testInfo.name ).value();
+            Entry const* end = m_entries + m_entryCount;
+            Entry const* entry = std::lower_bound( m_entries, end, nameHash, EntryOrder() );
+            if( entry == end || entry->nameHash != nameHash || entry->contentHash != *contentHash )
+                return Option<Totals>();
+            Totals totals;
+            totals.testCases.passed = 1;
+            totals.assertions.passed = static_cast<std::size_t>( entry->assertions );
+            return totals;
+        }
+
+        // Only passes are kept. Test cases not run keep what they had
+        void recordResult( TestCaseInfo const& testInfo, Totals const& totals ) {
+            uint64_t nameHash = Detail::ContentHash().add( testInfo.name ).value();
+            Option<uint64_t> contentHash = hashDependencies( testInfo );
+            if( contentHash && totals.testCases.passed > 0 && totals.assertions.failed == 0 ) {
+                Entry entry = { nameHash, *contentHash, totals.assertions.passed };
+                m_changes[nameHash] = entry;
+            }
+            else {
+                Entry removed = { nameHash, 0, 0 };
+                m_changes[nameHash] = removed;
+            }
+        }
+
+        // Replaced rather than written over, as the old index may still be mapped (here or by another run)
+        bool save( std::string const& filename ) const {
+            std::vector<Entry> entries;
+            entries.reserve( m_entryCount + m_changes.size() );
+            std::map<uint64_t, Entry>::const_iterator change = m_changes.begin(), changesEnd = m_changes.end();
+            for( std::size_t i = 0; i <= m_entryCount; ++i ) {
+                uint64_t nameHash = i < m_entryCount ? m_entries[i].nameHash : ~uint64_t( 0 );
+                for( ; change != changesEnd && change->first <= nameHash; ++change )
+                    if( change->second.contentHash != 0 )
+                        entries.push_back( change->second );
+                if( i < m_entryCount && m_changes.find( nameHash ) == changesEnd )
+                    entries.push_back( m_entries[i] );
+            }
+
+            uint64_t count = entries.size();
+            std::string content( magic(), MagicSize );
+            content.append( reinterpret_cast<char const*>( &count ), sizeof( count ) );
+            if( !entries.empty() )
+                content.append( reinterpret_cast<char const*>( &entries[0] ), sizeof( Entry ) * entries.size() );
+            return replaceFile( filename, content );
+        }
+
+    private:
+        enum { MagicSize = 8, HeaderSize = MagicSize + sizeof( uint64_t ) };
+        static char const* magic() { return "CatchRC1"; }
+
+        // Nothing can be cached for a test case whose source cannot be read
+        Option<uint64_t> hashDependencies( TestCaseInfo const& testInfo ) {
+            if( !m_buildHash )
+                return Option<uint64_t>();
+            Option<uint64_t> sourceHash = hashFile( testInfo.lineInfo.file );
+            if( !sourceHash )
+                return Option<uint64_t>();
+
+            Detail::ContentHash hash;
+            hash.add( testInfo.name ).add( *m_buildHash ).add( *sourceHash );
+            for( std::set<std::string>::const_iterator it = testInfo.tags.begin(), itEnd = testInfo.tags.end(); it != itEnd; ++it ) {
+                if( toLower( it->substr( 0, 5 ) ) != "data:" )
+                    continue;
+                // A data file that is missing is a dependency all the same
+                Option<uint64_t> dataHash = hashFile( it->substr( 5 ) );
+                hash.add( it->substr( 5 ) ).add( dataHash ? *dataHash : 0 );
+            }
+            return hash.value() != 0 ? hash.value() : 1; // 0 marks a removed entry
+        }
+
+        // Many test cases share a source file, so each one is only read once
+        Option<uint64_t> hashFile( std::string const& filename ) {
+            std::map<std::string, Option<uint64_t> >::const_iterator it = m_fileHashes.find( filename );
+            if( it == m_fileHashes.end() )
+                it = m_fileHashes.insert( std::make_pair( filename, Detail::hashFile( filename ) ) ).first;
+            return it->second;
+        }
+
+        Detail::MappedFile m_index;
+        Entry const* m_entries;
+        std::size_t m_entryCount;
+        Option<uint64_t> m_buildHash;
+        std::map<std::string, Option<uint64_t> > m_fileHashes;
+        std::map<uint64_t, Entry> m_changes;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_TEST_RESULT_CACHE_HPP_INCLUDED
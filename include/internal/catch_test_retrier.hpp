@@ -0,0 +1,102 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_TEST_RETRIER_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_TEST_RETRIER_HPP_INCLUDED
+
+#include "catch_worker_pool.hpp"
+#include "catch_repeat_statistics.hpp"
+#include "catch_test_event_stream.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Catch {
+
+    // Runs failed test cases again (--retry-failed), each time in a process
+    // freshly forked from the runner, to tell a real failure from a flaky one.
+    // The first attempt is forked as well, so one that brings its process down
+    // is retried like any other failure, rather than taking the run with it.
+    // The first retry uses the seed the test case failed with, later ones
+    // seeds derived from it. Retrying stops at the first pass.
+    // Test cases are recorded rather than reported as they run, so that only
+    // the attempt that stands - the passing retry, if there is one, or else
+    // the original failure - is reported, along with what the retries made of it
+    class TestRetrier : NonCopyable {
+    public:
+        struct Attempt {
+            Attempt() : failed( false ) {}
+            std::string events;
+            std::string interruption; // Set if the process died before the test case ended
+            bool failed;
+        };
+
+        TestRetrier( Ptr<IConfig const> const& config, ReporterPreferences const& preferences, std::size_t maxRetries )
+        :   m_config( config ),
+            m_preferences( preferences ),
+            m_maxRetries( maxRetries )
+        {}
+
+        // Runs the test case in a process forked from this one
+        Attempt runForked( TestCase const& testCase, unsigned int seed ) {
+            std::vector<TestCase> testCases( 1, testCase );
+            WorkerPool process( m_config, testCases, std::vector<unsigned int>( 1, seed ), 1, 1, m_preferences );
+            return fromWorker( testCase, process.takeResult( 0 ) );
+        }
+        // Takes a test case run by a worker
+        Attempt fromWorker( TestCase const& testCase, WorkerPool::Result const& result ) {
+            return makeAttempt( testCase, result.events, result.interruption );
+        }
+
+        // The attempt is replaced by the passing retry, if there is one
+        RetryOutcome::Kind retry( TestCase const& testCase, unsigned int seed, Attempt& attempt, std::size_t& retries ) {
+            for( retries = 1; retries <= m_maxRetries; ++retries ) {
+                unsigned int retrySeed = retries == 1 ? seed : RepeatStatistics::repetitionSeed( seed, retries - 1 );
+                Attempt retried = runForked( testCase, retrySeed );
+                if( !retried.failed ) {
+                    attempt = retried;
+                    return retries == 1 ? RetryOutcome::Flaky : RetryOutcome::PassedOnRetry;
+                }
+            }
+            retries = m_maxRetries;
+            return RetryOutcome::DeterministicFailure;
+        }
+
+    private:
+        // Only there to find out whether a recorded test case failed
+        struct DiscardingReporter : SharedImpl<IStreamingReporter> {
+            virtual ReporterPreferences getPreferences() const CATCH_OVERRIDE { return ReporterPreferences(); }
+            virtual void noMatchingTestCases( std::string const& ) CATCH_OVERRIDE {}
+            virtual void testRunStarting( TestRunInfo const& ) CATCH_OVERRIDE {}
+            virtual void testGroupStarting( GroupInfo const& ) CATCH_OVERRIDE {}
+            virtual void testCaseStarting( TestCaseInfo const& ) CATCH_OVERRIDE {}
+            virtual void sectionStarting( SectionInfo const& ) CATCH_OVERRIDE {}
+            virtual void assertionStarting( AssertionInfo const& ) CATCH_OVERRIDE {}
+            virtual bool assertionEnded( AssertionStats const& ) CATCH_OVERRIDE { return false; }
+            virtual void sectionEnded( SectionStats const& ) CATCH_OVERRIDE {}
+            virtual void testCaseEnded( TestCaseStats const& ) CATCH_OVERRIDE {}
+            virtual void testGroupEnded( TestGroupStats const& ) CATCH_OVERRIDE {}
+            virtual void testRunEnded( TestRunStats const& ) CATCH_OVERRIDE {}
+            virtual void skipTest( TestCaseInfo const& ) CATCH_OVERRIDE {}
+        };
+
+        static Attempt makeAttempt( TestCase const& testCase, std::string const& events, std::string const& interruption ) {
+            Attempt attempt;
+            attempt.events = events;
+            attempt.interruption = interruption;
+            DiscardingReporter reporter;
+            TestEventReplayer replayer( reporter, testCase.getTestCaseInfo(), Totals() );
+            replayer.replay( events );
+            attempt.failed = !replayer.testCaseEnded() || replayer.testCaseTotals().testCases.failed > 0;
+            return attempt;
+        }
+
+        Ptr<IConfig const> m_config;
+        ReporterPreferences m_preferences;
+        std::size_t m_maxRetries;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_TEST_RETRIER_HPP_INCLUDED
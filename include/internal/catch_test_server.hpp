@@ -0,0 +1,335 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_TEST_SERVER_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_TEST_SERVER_HPP_INCLUDED
+
+#include "catch_test_event_stream.hpp"
+#include "catch_stream.h"
+#include "catch_common.h"
+#include "catch_platform.h"
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cstdio>
+
+#ifndef CATCH_PLATFORM_WINDOWS
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+namespace Catch {
+
+    // Runs the tests asked for by one request, as if the arguments had been
+    // given on the command line. Called in a process forked for the request
+    struct ITestRequestRunner {
+        virtual ~ITestRequestRunner() {}
+        virtual int runRequest( std::vector<std::string> const& args ) = 0;
+    };
+
+#ifndef CATCH_PLATFORM_WINDOWS
+    inline sockaddr_un makeSocketAddress( std::string const& socketPath ) {
+        sockaddr_un address;
+        std::memset( &address, 0, sizeof( address ) );
+        address.sun_family = AF_UNIX;
+        if( socketPath.size() >= sizeof( address.sun_path ) )
+            throw std::domain_error( "Socket path is too long: " + socketPath );
+        std::memcpy( address.sun_path, socketPath.c_str(), socketPath.size() );
+        return address;
+    }
+#endif
+
+    // Keeps an initialised test runner around and runs tests on request, so
+    // repeated runs don't pay for start up each time. Clients connect to a
+    // local (UNIX domain) socket and send newline terminated lines: the working
+    // directory to run in (which may be empty), then one command line argument
+    // per line, then an empty line. Each request is run in a process forked
+    // from the server. Its output and then its exit code are sent back in frames
+    class TestServer : NonCopyable {
+    public:
+
+#ifdef CATCH_PLATFORM_WINDOWS
+
+        TestServer( std::string const& ) {
+            throw std::domain_error( "The test server is not supported on this platform" );
+        }
+        int serve( ITestRequestRunner& ) {
+            throw std::logic_error( "Illogical state" );
+        }
+
+#else // Not Windows - assumed to be POSIX compatible //////////////////////////
+
+        TestServer( std::string const& socketPath )
+        :   m_socketPath( socketPath ),
+            m_listenFd( -1 )
+        {
+            sockaddr_un address = makeSocketAddress( socketPath );
+
+            // A socket left behind by a previous server would stop us binding,
+            // but one a server still answers on is not ours to take over
+            struct stat info;
+            if( lstat( socketPath.c_str(), &info ) == 0 && S_ISSOCK( info.st_mode ) ) {
+                int probeFd = socket( AF_UNIX, SOCK_STREAM, 0 );
+                bool answered = probeFd >= 0 && connect( probeFd, reinterpret_cast<sockaddr*>( &address ), sizeof( address ) ) == 0;
+                if( probeFd >= 0 )
+                    close( probeFd );
+                if( answered )
+                    throw std::runtime_error( "A test server is already listening on " + socketPath );
+                unlink( socketPath.c_str() );
+            }
+
+            m_listenFd = socket( AF_UNIX, SOCK_STREAM, 0 );
+            if( m_listenFd < 0 ||
+                    bind( m_listenFd, reinterpret_cast<sockaddr*>( &address ), sizeof( address ) ) != 0 ||
+                    listen( m_listenFd, 16 ) != 0 ) {
+                std::string error = strerror( errno );
+                if( m_listenFd >= 0 )
+                    close( m_listenFd );
+                throw std::runtime_error( "Unable to listen on " + socketPath + ": " + error );
+            }
+        }
+        ~TestServer() {
+            close( m_listenFd );
+            unlink( m_socketPath.c_str() );
+        }
+
+        // Only returns if the server can no longer accept connections
+        int serve( ITestRequestRunner& runner ) {
+            // The connection handlers are never waited for, so the system
+            // reaps them as they end, rather than leaving them as zombies
+            struct sigaction noChildWait;
+            std::memset( &noChildWait, 0, sizeof( noChildWait ) );
+            noChildWait.sa_handler = SIG_DFL;
+            noChildWait.sa_flags = SA_NOCLDWAIT;
+            sigaction( SIGCHLD, &noChildWait, &m_previousSigChld );
+
+            Catch::cout() << "Serving tests on " << m_socketPath << std::endl;
+            for(;;) {
+                int connectionFd = accept( m_listenFd, CATCH_NULL, CATCH_NULL );
+                if( connectionFd < 0 ) {
+                    if( errno == EINTR || errno == ECONNABORTED )
+                        continue;
+                    Catch::cerr() << "Unable to accept connection: " << strerror( errno ) << std::endl;
+                    sigaction( SIGCHLD, &m_previousSigChld, CATCH_NULL );
+                    return (std::numeric_limits<int>::max)();
+                }
+
+                Catch::cout().flush();
+                Catch::cerr().flush();
+                std::fflush( CATCH_NULL );
+                pid_t pid = fork();
+                if( pid == 0 )
+                    handleConnection( connectionFd, runner );
+                if( pid < 0 )
+                    Catch::cerr() << "Unable to fork connection handler: " << strerror( errno ) << std::endl;
+                close( connectionFd );
+            }
+        }
+
+    private:
+        // Runs in a process forked for the connection and never returns. The
+        // tests run in yet another process, so that their output can be relayed
+        void handleConnection( int connectionFd, ITestRequestRunner& runner ) {
+            close( m_listenFd );
+            sigaction( SIGCHLD, &m_previousSigChld, CATCH_NULL ); // Its own children are waited for
+            signal( SIGPIPE, SIG_IGN ); // The client may go away at any time
+
+            std::string workingDirectory;
+            std::vector<std::string> args;
+            if( !readRequest( connectionFd, workingDirectory, args ) )
+                _exit( 1 );
+
+            int outPipe[2], errPipe[2];
+            if( pipe( outPipe ) != 0 || pipe( errPipe ) != 0 )
+                _exit( 1 );
+
+            pid_t pid = fork();
+            if( pid < 0 )
+                _exit( 1 );
+            if( pid == 0 ) {
+                close( connectionFd );
+                dup2( outPipe[1], 1 );
+                dup2( errPipe[1], 2 );
+                close( outPipe[0] ); close( outPipe[1] );
+                close( errPipe[0] ); close( errPipe[1] );
+                signal( SIGPIPE, SIG_DFL );
+
+                int exitCode = (std::numeric_limits<int>::max)();
+                if( !workingDirectory.empty() && chdir( workingDirectory.c_str() ) != 0 )
+                    Catch::cerr() << "Unable to change directory to " << workingDirectory << ": " << strerror( errno ) << std::endl;
+                else {
+                    try {
+                        exitCode = runner.runRequest( args );
+                    }
+                    catch( std::exception& ex ) {
+                        Catch::cerr() << ex.what() << std::endl;
+                    }
+                }
+                Catch::cout().flush();
+                Catch::cerr().flush();
+                std::fflush( CATCH_NULL );
+                _exit( exitCode );
+            }
+
+            close( outPipe[1] );
+            close( errPipe[1] );
+            relayOutput( connectionFd, outPipe[0], errPipe[0], pid );
+
+            int status = 0;
+            while( waitpid( pid, &status, 0 ) < 0 && errno == EINTR ) {}
+            int exitCode = WIFEXITED( status ) ? WEXITSTATUS( status ) : 128 + WTERMSIG( status );
+            writeFrame( connectionFd, EventFrame::ExitCode, std::string( reinterpret_cast<char const*>( &exitCode ), sizeof( exitCode ) ) );
+            _exit( 0 );
+        }
+
+        static void relayOutput( int connectionFd, int outFd, int errFd, pid_t pid ) {
+            pollfd fds[2];
+            fds[0].fd = outFd;
+            fds[1].fd = errFd;
+            int openFds = 2;
+            while( openFds > 0 ) {
+                for( std::size_t i = 0; i < 2; ++i ) {
+                    fds[i].events = POLLIN;
+                    fds[i].revents = 0;
+                }
+                if( poll( fds, 2, -1 ) < 0 ) {
+                    if( errno == EINTR )
+                        continue;
+                    break;
+                }
+                for( std::size_t i = 0; i < 2; ++i ) {
+                    if( fds[i].revents == 0 )
+                        continue;
+                    char buffer[65536];
+                    ssize_t got = read( fds[i].fd, buffer, sizeof( buffer ) );
+                    if( got < 0 && errno == EINTR )
+                        continue;
+                    if( got <= 0 ) {
+                        close( fds[i].fd );
+                        fds[i].fd = -1; // poll() ignores it from now on
+                        --openFds;
+                        continue;
+                    }
+                    EventFrame::Kind kind = i == 0 ? EventFrame::StandardOutput : EventFrame::StandardError;
+                    if( !writeFrame( connectionFd, kind, std::string( buffer, static_cast<std::size_t>( got ) ) ) ) {
+                        kill( pid, SIGKILL ); // Nobody is interested in the results any more
+                        return;
+                    }
+                }
+            }
+        }
+
+        static bool readLine( int fd, std::string& line ) {
+            line.clear();
+            char c;
+            for(;;) {
+                ssize_t got = read( fd, &c, 1 );
+                if( got < 0 && errno == EINTR )
+                    continue;
+                if( got <= 0 )
+                    return false;
+                if( c == '\n' )
+                    return true;
+                line += c;
+            }
+        }
+        static bool readRequest( int fd, std::string& workingDirectory, std::vector<std::string>& args ) {
+            if( !readLine( fd, workingDirectory ) )
+                return false;
+            std::string arg;
+            while( readLine( fd, arg ) ) {
+                if( arg.empty() )
+                    return true;
+                args.push_back( arg );
+            }
+            return false;
+        }
+
+        std::string m_socketPath;
+        int m_listenFd;
+        struct sigaction m_previousSigChld;
+
+#endif // not Windows
+    };
+
+    // Sends the arguments to a test server, as if they were given to this
+    // process, and relays what comes back. Returns the exit code of the run
+    inline int runOnTestServer( std::string const& socketPath, std::vector<std::string> const& args ) {
+#ifdef CATCH_PLATFORM_WINDOWS
+        (void)socketPath; (void)args;
+        throw std::domain_error( "The test server is not supported on this platform" );
+#else
+        sockaddr_un address = makeSocketAddress( socketPath );
+
+        int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+        if( fd < 0 || connect( fd, reinterpret_cast<sockaddr*>( &address ), sizeof( address ) ) != 0 ) {
+            std::string error = strerror( errno );
+            if( fd >= 0 )
+                close( fd );
+            throw std::runtime_error( "Unable to connect to test server at " + socketPath + ": " + error );
+        }
+
+        std::string request;
+        char workingDirectory[4096];
+        if( getcwd( workingDirectory, sizeof( workingDirectory ) ) )
+            request += workingDirectory;
+        request += '\n';
+        for( std::vector<std::string>::const_iterator it = args.begin(), itEnd = args.end(); it != itEnd; ++it ) {
+            if( it->empty() || it->find( '\n' ) != std::string::npos ) {
+                close( fd );
+                throw std::domain_error( "Arguments sent to a test server must not be empty or contain newlines" );
+            }
+            request += *it + '\n';
+        }
+        request += '\n';
+
+        Catch::cout().flush();
+        Catch::cerr().flush();
+        std::fflush( CATCH_NULL );
+
+        void (*previousSigPipe)( int ) = signal( SIGPIPE, SIG_IGN );
+        bool ended = false;
+        int exitCode = 0;
+        if( writeAllToFd( fd, request.data(), request.size() ) ) {
+            EventFrameBuffer frames;
+            char buffer[65536];
+            ssize_t got;
+            while( !ended && ( ( got = read( fd, buffer, sizeof( buffer ) ) ) > 0 || ( got < 0 && errno == EINTR ) ) ) {
+                if( got < 0 )
+                    continue;
+                frames.append( buffer, static_cast<std::size_t>( got ) );
+                EventFrame::Kind kind;
+                std::string payload;
+                while( frames.nextFrame( kind, payload ) ) {
+                    if( kind == EventFrame::StandardOutput )
+                        writeAllToFd( 1, payload.data(), payload.size() );
+                    else if( kind == EventFrame::StandardError )
+                        writeAllToFd( 2, payload.data(), payload.size() );
+                    else if( kind == EventFrame::ExitCode && payload.size() == sizeof( exitCode ) ) {
+                        std::memcpy( &exitCode, payload.data(), sizeof( exitCode ) );
+                        ended = true;
+                    }
+                }
+            }
+        }
+        close( fd );
+        signal( SIGPIPE, previousSigPipe );
+        if( !ended )
+            throw std::runtime_error( "Lost connection to test server at " + socketPath );
+        return exitCode;
+#endif
+    }
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_TEST_SERVER_HPP_INCLUDED
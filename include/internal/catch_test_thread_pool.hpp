@@ -0,0 +1,150 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_TEST_THREAD_POOL_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_TEST_THREAD_POOL_HPP_INCLUDED
+
+#include "catch_run_context.hpp"
+#include "catch_worker_pool.hpp"
+#include "catch_test_event_stream.hpp"
+#include "catch_cpu_pinning.hpp"
+#include "catch_context.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Catch {
+
+    // Runs the test cases tagged [parallel] on threads of this process, all
+    // of them from the start, each on the next free thread. Every test case
+    // gets a run context of its own, on its own thread, and its reporter
+    // events are recorded, so the caller can replay them in the order a
+    // serial run would have reported them, just as with a WorkerPool. The
+    // other test cases given are left to the caller, which should finish()
+    // the pool before it runs anything else in this process.
+    // With pinning, each thread is pinned to a CPU of its own in turn
+    class TestThreadPool : NonCopyable {
+    public:
+        typedef WorkerPool::Result Result;
+
+        static bool isParallel( TestCaseInfo const& testInfo ) {
+            return testInfo.lcaseTags.count( "parallel" ) > 0;
+        }
+
+        TestThreadPool( Ptr<IConfig const> const& config,
+                        std::vector<TestCase> const& testCases,
+                        std::vector<unsigned int> const& rngSeeds, // Empty for the configured seed
+                        std::size_t threadCount,
+                        ReporterPreferences const& preferences )
+        :   m_config( config ),
+            m_testCases( testCases ),
+            m_rngSeeds( rngSeeds ),
+            m_preferences( preferences ),
+            m_results( testCases.size() ),
+            m_cancelled( testCases.size(), false ),
+            m_nextQueued( 0 )
+        {
+            for( std::size_t i = 0; i < testCases.size(); ++i )
+                if( isParallel( testCases[i] ) )
+                    m_queue.push_back( i );
+            for( std::size_t i = 0; i < threadCount && i < m_queue.size(); ++i ) {
+                CpuPlacement placement;
+                if( CpuPinning* pinning = CpuPinning::active() )
+                    placement = pinning->nextForChild();
+                m_threads.push_back( std::thread( &TestThreadPool::threadMain, this, placement ) );
+            }
+        }
+
+        ~TestThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                m_nextQueued = m_queue.size(); // Those not started are not wanted any more
+            }
+            finish();
+        }
+
+        // Whether the test case at this index is one of those run here
+        bool runs( std::size_t index ) const {
+            return isParallel( m_testCases[index] );
+        }
+
+        // Blocks until the test case at this index has been run
+        Result takeResult( std::size_t index ) {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            while( !m_results[index].ready )
+                m_resultReady.wait( lock );
+            Result result;
+            result.events.swap( m_results[index].events );
+            result.ready = true;
+            return result;
+        }
+
+        // The test cases from begin to end are not to be run, unless started already
+        void cancel( std::size_t begin, std::size_t end ) {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            for( std::size_t i = begin; i < end && i < m_cancelled.size(); ++i )
+                m_cancelled[i] = true;
+        }
+
+        // Blocks until all the test cases have been run, and the threads are gone
+        void finish() {
+            for( std::vector<std::thread>::iterator it = m_threads.begin(), itEnd = m_threads.end(); it != itEnd; ++it )
+                it->join();
+            m_threads.clear();
+        }
+
+    private:
+        void threadMain( CpuPlacement placement ) {
+            if( placement.cpu >= 0 )
+                CpuPinning::pin( placement ); // Only this thread, on Linux
+            createThreadContext();
+            countsExpectationsPerThread() = true;
+            for(;;) {
+                std::size_t index;
+                {
+                    std::lock_guard<std::mutex> lock( m_mutex );
+                    while( m_nextQueued < m_queue.size() && m_cancelled[m_queue[m_nextQueued]] )
+                        ++m_nextQueued;
+                    if( m_nextQueued == m_queue.size() )
+                        break;
+                    index = m_queue[m_nextQueued++];
+                }
+                RecordingEventSink sink;
+                {
+                    // A fresh context per test, as with workers, so totals
+                    // (and so --abortx) only count what happened in this test
+                    RunContext context( m_config, new SerialisingReporter( sink, m_preferences ) );
+                    context.shareProcess();
+                    if( !m_rngSeeds.empty() )
+                        context.useRngSeed( m_rngSeeds[index] );
+                    context.runTest( m_testCases[index] );
+                }
+                {
+                    std::lock_guard<std::mutex> lock( m_mutex );
+                    m_results[index].events.swap( sink.events );
+                    m_results[index].ready = true;
+                }
+                m_resultReady.notify_all();
+            }
+            cleanUpContext(); // That of this thread
+        }
+
+        Ptr<IConfig const> m_config;
+        std::vector<TestCase> m_testCases;
+        std::vector<unsigned int> m_rngSeeds;
+        ReporterPreferences m_preferences;
+        std::vector<Result> m_results;
+        std::vector<bool> m_cancelled;
+        std::vector<std::size_t> m_queue; // Indices of the [parallel] test cases, in order
+        std::size_t m_nextQueued;
+        std::vector<std::thread> m_threads;
+        std::mutex m_mutex;
+        std::condition_variable m_resultReady;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_TEST_THREAD_POOL_HPP_INCLUDED
@@ -0,0 +1,219 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_TEST_WATCHDOG_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_TEST_WATCHDOG_HPP_INCLUDED
+
+#include "catch_interfaces_capture.h"
+#include "catch_interfaces_config.h"
+#include "catch_stream.h"
+#include "catch_common.h"
+
+#include <string>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__linux__) && defined(__GLIBC__)
+#define CATCH_INTERNAL_THREAD_BACKTRACES
+#include <execinfo.h>
+#include <dirent.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <fstream>
+#endif
+
+namespace Catch {
+
+#ifdef CATCH_INTERNAL_THREAD_BACKTRACES
+
+    namespace Detail {
+        struct CapturedBacktrace {
+            enum { MaxFrames = 64 };
+            void* frames[MaxFrames];
+            int size;
+            std::atomic<bool> done;
+        };
+        inline CapturedBacktrace& capturedBacktrace() {
+            static CapturedBacktrace backtrace;
+            return backtrace;
+        }
+        // Runs on the thread being inspected. backtrace() has already been
+        // called once by then, so it does not need to allocate anything
+        inline void captureBacktrace( int ) {
+            CapturedBacktrace& captured = capturedBacktrace();
+            captured.size = backtrace( captured.frames, CapturedBacktrace::MaxFrames );
+            captured.done = true;
+        }
+
+        // Signals each thread of the process in turn (apart from the calling
+        // one) so it records its own stack, then formats the result
+        inline std::string dumpThreadBacktraces() {
+            std::ostringstream oss;
+            DIR* tasks = opendir( "/proc/self/task" );
+            if( !tasks )
+                return oss.str();
+
+            void* warmUp[1];
+            backtrace( warmUp, 1 );
+
+            int const signalId = SIGRTMIN;
+            struct sigaction action, previousAction;
+            action.sa_handler = captureBacktrace;
+            sigemptyset( &action.sa_mask );
+            action.sa_flags = SA_RESTART;
+            sigaction( signalId, &action, &previousAction );
+
+            pid_t const pid = getpid();
+            pid_t const self = static_cast<pid_t>( syscall( SYS_gettid ) );
+            while( dirent* entry = readdir( tasks ) ) {
+                pid_t tid = static_cast<pid_t>( std::atol( entry->d_name ) );
+                if( tid <= 0 || tid == self )
+                    continue;
+
+                CapturedBacktrace& captured = capturedBacktrace();
+                captured.done = false;
+                if( syscall( SYS_tgkill, pid, tid, signalId ) != 0 )
+                    continue; // It has gone since we listed it
+                for( int waited = 0; waited < 1000 && !captured.done; ++waited )
+                    std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+
+                std::string threadName;
+                std::ifstream comm( ( "/proc/self/task/" + std::string( entry->d_name ) + "/comm" ).c_str() );
+                std::getline( comm, threadName );
+                oss << "\nThread " << tid << " (" << threadName << ( tid == pid ? ", main" : "" ) << "):\n";
+
+                if( !captured.done ) {
+                    oss << "  <did not respond>\n";
+                    continue;
+                }
+                // Frame 0 is the signal handler itself
+                char** symbols = backtrace_symbols( captured.frames, captured.size );
+                for( int i = 1; symbols && i < captured.size; ++i )
+                    oss << "  #" << i-1 << " " << symbols[i] << "\n";
+                std::free( symbols );
+            }
+            sigaction( signalId, &previousAction, CATCH_NULL );
+            closedir( tasks );
+            return oss.str();
+        }
+    }
+
+#endif // CATCH_INTERNAL_THREAD_BACKTRACES
+
+    // Watches over the test case being run from a thread of its own. If the
+    // test case overruns its timeout, the backtraces of all the threads are
+    // dumped and the test is failed through the same route as a fatal signal,
+    // so every reporter gets to finish its report. The process then exits with
+    // TimeoutExitCode, as the hung test case cannot be recovered from. The
+    // timeout is only reported with the run's report mutex held, which the
+    // run only lets go of while the test case's own code runs: the test case
+    // is never caught halfway through reporting, and waits if it tries again
+    class TestWatchdog : NonCopyable {
+    public:
+        enum { TimeoutExitCode = 124 };
+
+        // Given here, as the context the watchdog's thread would find is the
+        // process's, which is not that of a test case run on a thread of its own
+        TestWatchdog( IResultCapture& resultCapture, IConfig const& config, std::recursive_mutex& reportMutex )
+        :   m_resultCapture( resultCapture ),
+            m_config( config ),
+            m_reportMutex( reportMutex ),
+            m_timeoutInMs( 0 ),
+            m_armed( false ),
+            m_stopping( false )
+        {}
+
+        ~TestWatchdog() {
+            if( m_thread.joinable() ) {
+                {
+                    std::lock_guard<std::mutex> lock( m_mutex );
+                    m_stopping = true;
+                }
+                m_condition.notify_all();
+                m_thread.join();
+            }
+        }
+
+        // The thread is only started when first needed
+        void arm( int timeoutInMs ) {
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                m_timeoutInMs = timeoutInMs;
+                m_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds( timeoutInMs );
+                m_armed = true;
+                if( !m_thread.joinable() )
+                    m_thread = std::thread( &TestWatchdog::watch, this );
+            }
+            m_condition.notify_all();
+        }
+
+        void disarm() {
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                m_armed = false;
+            }
+            m_condition.notify_all();
+        }
+
+    private:
+        void watch() {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            while( !m_stopping ) {
+                if( !m_armed )
+                    m_condition.wait( lock );
+                else if( std::chrono::steady_clock::now() < m_deadline )
+                    m_condition.wait_until( lock, m_deadline );
+                else {
+                    // The test case may end while the run is being waited for
+                    lock.unlock();
+                    std::unique_lock<std::recursive_mutex> reporting( m_reportMutex );
+                    lock.lock();
+                    if( m_armed && !m_stopping && std::chrono::steady_clock::now() >= m_deadline ) {
+                        lock.unlock();
+                        timedOut();
+                    }
+                }
+            }
+        }
+
+        void timedOut() {
+            std::ostringstream oss;
+            oss << "Test case did not complete within its " << m_timeoutInMs << " ms timeout";
+#ifdef CATCH_INTERNAL_THREAD_BACKTRACES
+            std::string backtraces = Detail::dumpThreadBacktraces();
+            if( !backtraces.empty() )
+                oss << "\nBacktraces of all threads:\n" << backtraces;
+#endif
+            m_resultCapture.handleFatalErrorCondition( oss.str() );
+
+            // Exit without running static destructors, as the hung thread may still be using them
+            m_config.stream().flush();
+            Catch::cout().flush();
+            Catch::cerr().flush();
+            std::fflush( CATCH_NULL );
+            std::_Exit( TimeoutExitCode );
+        }
+
+        IResultCapture& m_resultCapture;
+        IConfig const& m_config;
+        std::recursive_mutex& m_reportMutex;
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::chrono::steady_clock::time_point m_deadline;
+        int m_timeoutInMs;
+        bool m_armed;
+        bool m_stopping;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_TEST_WATCHDOG_HPP_INCLUDED
@@ -0,0 +1,167 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_TIME_BUDGET_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_TIME_BUDGET_HPP_INCLUDED
+
+#include "catch_run_history.hpp"
+#include "catch_test_case_info.h"
+#include "catch_totals.hpp"
+#include "catch_option.hpp"
+#include "catch_common.h"
+#include "catch_timer.h"
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+
+namespace Catch {
+
+    // Chooses the test cases to run within --time-budget, from the run history.
+    // Each is worth the weight of its recent failures (a test never run before
+    // counts as one that failed last run), and costs its expected duration.
+    // They are run in order of worth per second, cheaper first among equals,
+    // and dealt into the budget in that order; those that don't fit, or that
+    // would no longer fit once the run gets to them, are deferred. The budget
+    // is wall time, so it stretches over the workers running in parallel
+    class TimeBudget : NonCopyable {
+    public:
+        enum { DeferredShown = 20 };
+
+        TimeBudget( RunHistory const& history, double budgetInSeconds, std::size_t workerCount )
+        :   m_history( history ),
+            m_budget( budgetInSeconds ),
+            m_capacity( budgetInSeconds * static_cast<double>( workerCount ) ),
+            m_plannedCount( 0 ),
+            m_ran( 0 ),
+            m_failuresCaught( 0 ),
+            m_failuresRecorded( 0 )
+        {
+            m_timer.start();
+        }
+
+        // Puts the matched test cases in the order they are to be run in,
+        // followed by the deferred ones, and the other test cases after them.
+        // Those whose totals are already known cost nothing
+        void plan( std::vector<TestCase>& allTestCases, std::vector<TestCase>& matchedTestCases, std::vector<Option<Totals> >& knownTotals ) {
+            std::vector<std::string> names;
+            for( std::vector<TestCase>::const_iterator it = matchedTestCases.begin(), itEnd = matchedTestCases.end(); it != itEnd; ++it )
+                names.push_back( it->name );
+            std::vector<double> estimates = m_history.estimateDurations( names );
+
+            std::vector<Candidate> candidates( matchedTestCases.size() );
+            for( std::size_t i = 0; i < candidates.size(); ++i ) {
+                Candidate& candidate = candidates[i];
+                candidate.index = i;
+                candidate.cost = knownTotals[i] ? 0 : estimates[i];
+                Option<double> weight = m_history.failureWeight( names[i] );
+                candidate.worth = weight ? *weight : 1;
+                m_failuresRecorded += m_history.recordedFailures( names[i] );
+            }
+            std::stable_sort( candidates.begin(), candidates.end(), WorthMorePerSecond() );
+
+            double planned = 0;
+            std::vector<Candidate> deferred;
+            std::vector<TestCase> sortedMatches;
+            std::vector<Option<Totals> > sortedTotals;
+            for( std::vector<Candidate>::const_iterator it = candidates.begin(), itEnd = candidates.end(); it != itEnd; ++it ) {
+                if( planned + it->cost > m_capacity ) {
+                    deferred.push_back( *it );
+                    continue;
+                }
+                planned += it->cost;
+                sortedMatches.push_back( matchedTestCases[it->index] );
+                sortedTotals.push_back( knownTotals[it->index] );
+                m_costs.push_back( it->cost );
+            }
+            m_plannedCount = sortedMatches.size();
+            for( std::vector<Candidate>::const_iterator it = deferred.begin(), itEnd = deferred.end(); it != itEnd; ++it ) {
+                sortedMatches.push_back( matchedTestCases[it->index] );
+                sortedTotals.push_back( knownTotals[it->index] );
+                m_costs.push_back( it->cost );
+            }
+
+            std::vector<TestCase> sortedAll = sortedMatches;
+            for( std::vector<TestCase>::const_iterator it = allTestCases.begin(), itEnd = allTestCases.end(); it != itEnd; ++it )
+                if( std::find( matchedTestCases.begin(), matchedTestCases.end(), *it ) == matchedTestCases.end() )
+                    sortedAll.push_back( *it );
+
+            allTestCases.swap( sortedAll );
+            matchedTestCases.swap( sortedMatches );
+            knownTotals.swap( sortedTotals );
+        }
+
+        // By index into the matched test cases, as ordered by plan()
+        bool isPlanned( std::size_t index ) const {
+            return index < m_plannedCount;
+        }
+
+        // Called as the run gets to each matched test case. Unless it has been
+        // handed to a worker already, elapsed time is checked, as estimates
+        // may be off
+        bool admit( TestCase const& testCase, std::size_t index, bool checkElapsed ) {
+            bool fits = isPlanned( index )
+                && ( !checkElapsed || m_costs[index] == 0 || m_timer.getElapsedSeconds() + m_costs[index] <= m_budget );
+            if( fits ) {
+                ++m_ran;
+                m_failuresCaught += m_history.recordedFailures( testCase.name );
+            }
+            else
+                m_deferred.push_back( testCase.name );
+            return fits;
+        }
+
+        void print( std::ostream& os ) const {
+            std::ios_base::fmtflags flags = os.flags();
+            std::streamsize precision = os.precision();
+            os << "\nTime budget of " << m_budget << " s: ran " << m_ran << " of " << m_ran + m_deferred.size() << " test cases";
+            if( !m_deferred.empty() ) {
+                os << ", deferred:\n";
+                for( std::size_t i = 0; i < m_deferred.size() && i < DeferredShown; ++i )
+                    os << "  " << m_deferred[i] << "\n";
+                if( m_deferred.size() > DeferredShown )
+                    os << "  and " << m_deferred.size() - DeferredShown << " more\n";
+            }
+            else
+                os << "\n";
+            if( m_failuresRecorded > 0 )
+                os << "Covered " << m_failuresCaught << " of the " << m_failuresRecorded << " failures in the run history ("
+                   << std::fixed << std::setprecision( 2 ) << 100.0 * static_cast<double>( m_failuresCaught ) / static_cast<double>( m_failuresRecorded ) << "%)\n";
+            else
+                os << "No failures in the run history to cover\n";
+            os.flags( flags );
+            os.precision( precision );
+            os.flush();
+        }
+
+    private:
+        struct Candidate {
+            std::size_t index;
+            double cost;
+            double worth;
+        };
+        struct WorthMorePerSecond {
+            bool operator() ( Candidate const& a, Candidate const& b ) const {
+                double aWorth = a.worth * b.cost, bWorth = b.worth * a.cost; // So that free tests come first
+                return aWorth != bWorth ? aWorth > bWorth : a.cost < b.cost;
+            }
+        };
+
+        RunHistory const& m_history;
+        double m_budget;
+        double m_capacity;
+        Timer m_timer;
+        std::vector<double> m_costs;
+        std::size_t m_plannedCount;
+        std::size_t m_ran;
+        std::vector<std::string> m_deferred;
+        std::size_t m_failuresCaught;
+        std::size_t m_failuresRecorded;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_TIME_BUDGET_HPP_INCLUDED
@@ -18,16 +18,20 @@ typedef unsigned long long uint64_t;
 
 namespace Catch {
 
+    // Measures on a monotonic clock, in nanoseconds (as far as the clock
+    // resolves them), so neither adjustments to the system time nor long
+    // runs throw it out
     class Timer {
     public:
-        Timer() : m_ticks( 0 ) {}
+        Timer() : m_nanoseconds( 0 ) {}
         void start();
-        unsigned int getElapsedMicroseconds() const;
+        uint64_t getElapsedNanoseconds() const;
+        uint64_t getElapsedMicroseconds() const;
         unsigned int getElapsedMilliseconds() const;
         double getElapsedSeconds() const;
 
     private:
-        uint64_t m_ticks;
+        uint64_t m_nanoseconds;
     };
 
 } // namespace Catch
@@ -0,0 +1,503 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_WORKER_POOL_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_WORKER_POOL_HPP_INCLUDED
+
+#include "catch_run_context.hpp"
+#include "catch_test_event_stream.hpp"
+#include "catch_run_history.hpp"
+#include "catch_memory_usage.hpp"
+#include "catch_cpu_pinning.hpp"
+#include "catch_platform.h"
+
+#include <vector>
+#include <string>
+#include <set>
+#include <map>
+#include <sstream>
+#include <ostream>
+#include <stdexcept>
+#include <chrono>
+
+#ifndef CATCH_PLATFORM_WINDOWS
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+namespace Catch {
+
+    // The resources a test case declares with [resource:<name>] tags, which no
+    // other test case using any of them may run alongside, and whether it is
+    // [exclusive], so runs alongside nothing at all
+    struct ResourceLocks {
+        ResourceLocks() : exclusive( false ) {}
+        explicit ResourceLocks( TestCaseInfo const& testInfo ) : exclusive( false ) {
+            for( std::set<std::string>::const_iterator it = testInfo.lcaseTags.begin(), itEnd = testInfo.lcaseTags.end(); it != itEnd; ++it ) {
+                if( startsWith( *it, "resource:" ) && it->size() > 9 )
+                    resources.push_back( it->substr( 9 ) );
+                else if( *it == "exclusive" )
+                    exclusive = true;
+            }
+        }
+        std::vector<std::string> resources;
+        bool exclusive;
+    };
+
+    // Runs test cases in forked worker processes. Workers are forked from the
+    // fully initialised runner, are handed test cases one at a time over a pipe
+    // and send the reporter events of each test back over another.
+    // The results are collected in the order they are asked for, so the caller
+    // can replay them exactly as a serial run would have reported them.
+    // A worker can be limited to a number of tests, after which it is replaced
+    // by a fresh fork, so tests cannot see what earlier tests left behind.
+    // The same test case can be given any number of times, each with its own seed.
+    // Test cases are handed out in order, except that one is passed over while
+    // it would run alongside another holding one of its resource locks, for
+    // the next test case that can run. Nothing is passed over for an exclusive
+    // test case though, which waits for the running ones to end.
+    // With a memory budget, a test case is likewise passed over while the peak
+    // memory the run history expects of it and of the running ones would not
+    // fit in the budget, unless nothing else is running. Workers cannot take
+    // more address space than the budget on top of what they start with
+    class WorkerPool : NonCopyable {
+    public:
+        struct Result {
+            Result() : ready( false ) {}
+            std::string events;
+            std::string interruption; // Set if the worker died before the test case ended
+            bool ready;
+        };
+
+#ifdef CATCH_PLATFORM_WINDOWS
+
+        WorkerPool( Ptr<IConfig const> const&, std::vector<TestCase> const&, std::vector<unsigned int> const&, std::size_t, std::size_t, ReporterPreferences const& ) {
+            throw std::domain_error( "Running tests in worker processes is not supported on this platform" );
+        }
+        Result takeResult( std::size_t ) {
+            throw std::logic_error( "Illogical state" );
+        }
+        void cancel( std::size_t, std::size_t ) {}
+        void printLockWaits( std::ostream& ) const {}
+
+#else // Not Windows - assumed to be POSIX compatible //////////////////////////
+
+        WorkerPool( Ptr<IConfig const> const& config,
+                    std::vector<TestCase> const& testCases,
+                    std::vector<unsigned int> const& rngSeeds, // Empty for the configured seed
+                    std::size_t workerCount,
+                    std::size_t testsPerWorker, // 0 for no limit
+                    ReporterPreferences const& preferences )
+        :   m_config( config ),
+            m_testCases( testCases ),
+            m_rngSeeds( rngSeeds ),
+            m_testsPerWorker( testsPerWorker ),
+            m_preferences( preferences ),
+            m_results( testCases.size() ),
+            m_cancelled( testCases.size(), false ),
+            m_dispatched( testCases.size(), false ),
+            m_heldBackSince( testCases.size() ),
+            m_heldBackBy( testCases.size() ),
+            m_nextToDispatch( 0 ),
+            m_exclusiveHeld( false ),
+            m_memoryBudgetKb( static_cast<std::size_t>( config->memoryBudget() ) * 1024 ),
+            m_memoryInUseKb( 0 )
+        {
+            std::vector<std::string> names;
+            for( std::vector<TestCase>::const_iterator it = testCases.begin(), itEnd = testCases.end(); it != itEnd; ++it ) {
+                m_locks.push_back( ResourceLocks( *it ) );
+                names.push_back( it->name );
+            }
+            if( m_memoryBudgetKb > 0 )
+                m_expectedPeaksKb = config->history().estimatePeakMemory( names );
+            m_previousSigPipe = signal( SIGPIPE, SIG_IGN ); // A dying worker must not take us with it
+            for( std::size_t i = 0; i < workerCount && i < testCases.size(); ++i )
+                startWorker();
+        }
+
+        ~WorkerPool() {
+            for( std::vector<Worker>::iterator it = m_workers.begin(), itEnd = m_workers.end(); it != itEnd; ++it ) {
+                if( it->busy )
+                    kill( it->pid, SIGKILL ); // Only happens when the run is aborted
+                if( it->commandFd >= 0 )
+                    close( it->commandFd );
+                close( it->resultFd );
+            }
+            for( std::vector<Worker>::iterator it = m_workers.begin(), itEnd = m_workers.end(); it != itEnd; ++it ) {
+                int status;
+                while( waitpid( it->pid, &status, 0 ) < 0 && errno == EINTR ) {}
+            }
+            signal( SIGPIPE, m_previousSigPipe );
+        }
+
+        // Blocks until the test case at this index has been run by one of the workers.
+        // Each result can only be taken once
+        Result takeResult( std::size_t index ) {
+            while( !m_results[index].ready ) {
+                if( m_workers.empty() )
+                    throw std::logic_error( "No worker left to run test case: " + m_testCases[index].name );
+                pollWorkers();
+            }
+            Result result;
+            std::swap( result, m_results[index] );
+            return result;
+        }
+
+        // The test cases in this range of indices, whose results will not be
+        // taken, are not run if they have not been started yet
+        void cancel( std::size_t begin, std::size_t end ) {
+            for( std::size_t i = begin; i < end; ++i )
+                m_cancelled[i] = true;
+        }
+
+        // How long test cases waited for each lock, from when a worker was
+        // first free for them. Nothing if no test case declared any
+        void printLockWaits( std::ostream& os ) const {
+            if( m_lockUses.empty() )
+                return;
+            os << "\nResource locks:\n";
+            for( std::map<std::string, LockUse>::const_iterator it = m_lockUses.begin(), itEnd = m_lockUses.end(); it != itEnd; ++it )
+                os << "  " << it->first << ": " << it->second.testCases << " test case" << ( it->second.testCases == 1 ? "" : "s" )
+                   << ", " << it->second.waiters << " waited " << it->second.waitedSeconds << " s in all\n";
+            os.flush();
+        }
+
+    private:
+        struct Worker {
+            Worker() : pid( -1 ), commandFd( -1 ), resultFd( -1 ), testIndex( 0 ), testsDispatched( 0 ), busy( false ), started( false ) {}
+            pid_t pid;
+            int commandFd;
+            int resultFd;
+            std::size_t testIndex;
+            std::size_t testsDispatched;
+            bool busy;
+            bool started; // The worker has picked up the test it was given
+            EventFrameBuffer frames;
+        };
+
+        typedef std::chrono::steady_clock Clock;
+
+        struct LockUse {
+            LockUse() : testCases( 0 ), waiters( 0 ), waitedSeconds( 0 ) {}
+            std::size_t testCases;
+            std::size_t waiters;
+            double waitedSeconds;
+        };
+
+        struct PipeEventSink : ITestEventSink {
+            PipeEventSink( int fd ) : m_fd( fd ) {}
+            virtual void eventsFlushed( std::string const& events, bool testCaseEnded ) CATCH_OVERRIDE {
+                if( !writeFrame( m_fd, testCaseEnded ? EventFrame::TestEnded : EventFrame::Events, events ) )
+                    _exit( 1 ); // Nobody is listening any more
+            }
+            int m_fd;
+        };
+
+        void startWorker() {
+            int commandPipe[2], resultPipe[2];
+            if( pipe( commandPipe ) != 0 )
+                throw std::runtime_error( std::string( "Unable to create worker pipe: " ) + strerror( errno ) );
+            if( pipe( resultPipe ) != 0 ) {
+                close( commandPipe[0] );
+                close( commandPipe[1] );
+                throw std::runtime_error( std::string( "Unable to create worker pipe: " ) + strerror( errno ) );
+            }
+
+            // Anything still buffered would otherwise be written twice
+            Catch::cout().flush();
+            Catch::cerr().flush();
+            m_config->stream().flush();
+            fflush( CATCH_NULL );
+
+            CpuPlacement placement;
+            if( CpuPinning* pinning = CpuPinning::active() )
+                placement = pinning->nextForChild();
+
+            pid_t pid = fork();
+            if( pid < 0 )
+                throw std::runtime_error( std::string( "Unable to fork worker process: " ) + strerror( errno ) );
+
+            if( pid == 0 ) {
+                if( placement.cpu >= 0 )
+                    CpuPinning::pin( placement );
+                close( commandPipe[1] );
+                close( resultPipe[0] );
+                for( std::vector<Worker>::const_iterator it = m_workers.begin(), itEnd = m_workers.end(); it != itEnd; ++it ) {
+                    close( it->commandFd );
+                    close( it->resultFd );
+                }
+                workerMain( commandPipe[0], resultPipe[1] );
+            }
+
+            close( commandPipe[0] );
+            close( resultPipe[1] );
+            Worker worker;
+            worker.pid = pid;
+            worker.commandFd = commandPipe[1];
+            worker.resultFd = resultPipe[0];
+            m_workers.push_back( worker );
+            dispatch( m_workers.back() );
+        }
+
+        // Runs in the forked child and never returns
+        void workerMain( int commandFd, int resultFd ) {
+            signal( SIGPIPE, SIG_DFL );
+            if( m_memoryBudgetKb > 0 )
+                limitAddressSpaceGrowth( m_memoryBudgetKb );
+            PipeEventSink sink( resultFd );
+            Ptr<IStreamingReporter> reporter( new SerialisingReporter( sink, m_preferences ) );
+
+            uint32_t index;
+            while( readCommand( commandFd, index ) ) {
+                if( !writeFrame( resultFd, EventFrame::TestStarting, std::string() ) )
+                    _exit( 1 );
+                // A fresh context per test, so totals (and so --abortx) only
+                // count what happened in this test, as they would serially
+                RunContext context( m_config, reporter );
+                if( !m_rngSeeds.empty() )
+                    context.useRngSeed( m_rngSeeds[index] );
+                context.runTest( m_testCases[index] );
+            }
+            Catch::cout().flush();
+            Catch::cerr().flush();
+            fflush( CATCH_NULL );
+            _exit( 0 );
+        }
+
+        static bool readCommand( int fd, uint32_t& index ) {
+            char* data = reinterpret_cast<char*>( &index );
+            std::size_t remaining = sizeof( index );
+            while( remaining > 0 ) {
+                ssize_t got = read( fd, data, remaining );
+                if( got < 0 && errno == EINTR )
+                    continue;
+                if( got <= 0 )
+                    return false;
+                data += got;
+                remaining -= static_cast<std::size_t>( got );
+            }
+            return true;
+        }
+
+        bool hasWorkLeft() {
+            while( m_nextToDispatch < m_testCases.size() && ( m_dispatched[m_nextToDispatch] || m_cancelled[m_nextToDispatch] ) )
+                m_nextToDispatch++;
+            return m_nextToDispatch < m_testCases.size();
+        }
+
+        static std::string exclusiveLock() { return "[exclusive]"; }
+        static std::string memoryLock() { return "[memory]"; }
+
+        // The lock held by a running test case that this one would need, if any
+        std::string lockConflict( std::size_t index ) const {
+            if( m_exclusiveHeld )
+                return exclusiveLock();
+            if( m_locks[index].exclusive ) {
+                for( std::vector<Worker>::const_iterator it = m_workers.begin(), itEnd = m_workers.end(); it != itEnd; ++it )
+                    if( it->busy )
+                        return exclusiveLock();
+            }
+            for( std::vector<std::string>::const_iterator it = m_locks[index].resources.begin(), itEnd = m_locks[index].resources.end(); it != itEnd; ++it )
+                if( m_heldResources.find( *it ) != m_heldResources.end() )
+                    return *it;
+            if( m_memoryBudgetKb > 0 && m_memoryInUseKb > 0 && m_memoryInUseKb + m_expectedPeaksKb[index] > m_memoryBudgetKb )
+                return memoryLock();
+            return std::string();
+        }
+
+        Option<std::size_t> nextRunnable() {
+            for( std::size_t i = m_nextToDispatch; i < m_testCases.size(); ++i ) {
+                if( m_dispatched[i] || m_cancelled[i] )
+                    continue;
+                std::string conflict = lockConflict( i );
+                if( conflict.empty() )
+                    return i;
+                if( !m_heldBackSince[i] ) {
+                    m_heldBackSince[i] = Clock::now();
+                    m_heldBackBy[i] = conflict;
+                }
+                if( conflict == exclusiveLock() )
+                    break;
+            }
+            return Option<std::size_t>();
+        }
+
+        void acquireLocks( std::size_t index ) {
+            ResourceLocks const& locks = m_locks[index];
+            m_heldResources.insert( locks.resources.begin(), locks.resources.end() );
+            m_exclusiveHeld = locks.exclusive;
+            if( m_memoryBudgetKb > 0 ) {
+                m_memoryInUseKb += m_expectedPeaksKb[index];
+                m_lockUses[memoryLock()].testCases++;
+            }
+            for( std::vector<std::string>::const_iterator it = locks.resources.begin(), itEnd = locks.resources.end(); it != itEnd; ++it )
+                m_lockUses[*it].testCases++;
+            if( locks.exclusive )
+                m_lockUses[exclusiveLock()].testCases++;
+            if( m_heldBackSince[index] ) {
+                LockUse& use = m_lockUses[m_heldBackBy[index]];
+                use.waiters++;
+                use.waitedSeconds += std::chrono::duration<double>( Clock::now() - *m_heldBackSince[index] ).count();
+                m_heldBackSince[index].reset();
+            }
+        }
+        void releaseLocks( std::size_t index ) {
+            ResourceLocks const& locks = m_locks[index];
+            for( std::vector<std::string>::const_iterator it = locks.resources.begin(), itEnd = locks.resources.end(); it != itEnd; ++it )
+                m_heldResources.erase( *it );
+            if( locks.exclusive )
+                m_exclusiveHeld = false;
+            if( m_memoryBudgetKb > 0 )
+                m_memoryInUseKb -= m_expectedPeaksKb[index];
+        }
+        // Once a lock has been released
+        void dispatchIdleWorkers() {
+            for( std::vector<Worker>::iterator it = m_workers.begin(), itEnd = m_workers.end(); it != itEnd; ++it )
+                if( !it->busy && it->commandFd >= 0 )
+                    dispatch( *it );
+        }
+
+        // A worker with nothing it can run yet is left idle, to be dispatched
+        // again when a lock is released
+        void dispatch( Worker& worker ) {
+            worker.started = false;
+            worker.busy = false;
+            if( !hasWorkLeft() || ( m_testsPerWorker > 0 && worker.testsDispatched == m_testsPerWorker ) ) {
+                close( worker.commandFd ); // Nothing left for it, so let it exit
+                worker.commandFd = -1;
+                return;
+            }
+            Option<std::size_t> next = nextRunnable();
+            if( !next )
+                return;
+            worker.testIndex = *next;
+            m_dispatched[worker.testIndex] = true;
+            acquireLocks( worker.testIndex );
+            worker.testsDispatched++;
+            worker.busy = true;
+            // If the worker has already gone this fails, and its result pipe reports end of file
+            uint32_t index = static_cast<uint32_t>( worker.testIndex );
+            writeAllToFd( worker.commandFd, reinterpret_cast<char const*>( &index ), sizeof( index ) );
+        }
+
+        void pollWorkers() {
+            std::vector<pollfd> fds( m_workers.size() );
+            for( std::size_t i = 0; i < m_workers.size(); ++i ) {
+                fds[i].fd = m_workers[i].resultFd;
+                fds[i].events = POLLIN;
+                fds[i].revents = 0;
+            }
+            if( poll( &fds[0], fds.size(), -1 ) < 0 ) {
+                if( errno == EINTR )
+                    return;
+                throw std::runtime_error( std::string( "Unable to wait for worker processes: " ) + strerror( errno ) );
+            }
+
+            std::vector<std::size_t> exited;
+            for( std::size_t i = 0; i < fds.size(); ++i ) {
+                if( fds[i].revents == 0 )
+                    continue;
+                Worker& worker = m_workers[i];
+                char buffer[65536];
+                ssize_t got = read( worker.resultFd, buffer, sizeof( buffer ) );
+                if( got < 0 && errno == EINTR )
+                    continue;
+                if( got <= 0 ) {
+                    exited.push_back( i );
+                    continue;
+                }
+                worker.frames.append( buffer, static_cast<std::size_t>( got ) );
+
+                EventFrame::Kind kind;
+                std::string payload;
+                while( worker.busy && worker.frames.nextFrame( kind, payload ) ) {
+                    if( kind == EventFrame::TestStarting ) {
+                        worker.started = true;
+                        continue;
+                    }
+                    Result& result = m_results[worker.testIndex];
+                    result.events += payload;
+                    if( kind == EventFrame::TestEnded ) {
+                        result.ready = true;
+                        releaseLocks( worker.testIndex );
+                        dispatch( worker );
+                        dispatchIdleWorkers();
+                    }
+                }
+            }
+
+            for( std::vector<std::size_t>::const_reverse_iterator it = exited.rbegin(), itEnd = exited.rend(); it != itEnd; ++it )
+                workerExited( *it );
+        }
+
+        void workerExited( std::size_t workerIndex ) {
+            Worker worker = m_workers[workerIndex];
+            m_workers.erase( m_workers.begin() + static_cast<std::ptrdiff_t>( workerIndex ) );
+            if( worker.commandFd >= 0 )
+                close( worker.commandFd );
+            close( worker.resultFd );
+
+            int status = 0;
+            while( waitpid( worker.pid, &status, 0 ) < 0 && errno == EINTR ) {}
+
+            if( worker.busy && !worker.started ) {
+                // It died on the way out of its previous test (e.g. a fatal
+                // signal, which is reported and then exits), so try again elsewhere
+                m_dispatched[worker.testIndex] = false;
+                m_nextToDispatch = (std::min)( m_nextToDispatch, worker.testIndex );
+            }
+            else if( worker.busy ) {
+                std::ostringstream oss;
+                if( WIFSIGNALED( status ) )
+                    oss << "Worker process " << worker.pid << " was terminated by signal " << WTERMSIG( status )
+                        << " (" << strsignal( WTERMSIG( status ) ) << ")";
+                else
+                    oss << "Worker process " << worker.pid << " exited with code " << WEXITSTATUS( status )
+                        << " before the test case ended";
+                Result& result = m_results[worker.testIndex];
+                result.interruption = oss.str();
+                result.ready = true;
+            }
+            if( worker.busy ) {
+                releaseLocks( worker.testIndex );
+                dispatchIdleWorkers();
+            }
+            // Keep the pool at strength while there is still work to hand out.
+            // The replacement is forked from this process, which is still in
+            // the state it was in before any test ran
+            if( hasWorkLeft() )
+                startWorker();
+        }
+
+        Ptr<IConfig const> m_config;
+        std::vector<TestCase> m_testCases;
+        std::vector<unsigned int> m_rngSeeds;
+        std::size_t m_testsPerWorker;
+        ReporterPreferences m_preferences;
+        std::vector<Result> m_results;
+        std::vector<bool> m_cancelled;
+        std::vector<bool> m_dispatched;
+        std::vector<ResourceLocks> m_locks;
+        std::vector<Option<Clock::time_point> > m_heldBackSince; // While a lock keeps it from a free worker
+        std::vector<std::string> m_heldBackBy;
+        std::vector<Worker> m_workers;
+        std::size_t m_nextToDispatch; // None before this one is left to hand out
+        std::set<std::string> m_heldResources;
+        bool m_exclusiveHeld;
+        std::size_t m_memoryBudgetKb; // 0 for none
+        std::vector<std::size_t> m_expectedPeaksKb;
+        std::size_t m_memoryInUseKb; // Expected of the running test cases
+        std::map<std::string, LockUse> m_lockUses;
+        void (*m_previousSigPipe)( int );
+
+#endif // not Windows
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_WORKER_POOL_HPP_INCLUDED
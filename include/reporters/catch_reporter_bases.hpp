@@ -9,6 +9,7 @@
 #define TWOBLUECUBES_CATCH_REPORTER_BASES_HPP_INCLUDED
 
 #include "../internal/catch_interfaces_reporter.h"
+#include "../internal/catch_benchmark_analysis.hpp"
 
 #include <cstring>
 
@@ -100,8 +101,16 @@ namespace Catch {
             SectionStats stats;
             typedef std::vector<Ptr<SectionNode> > ChildSections;
             typedef std::vector<AssertionStats> Assertions;
+            typedef std::vector<BenchmarkStats> Benchmarks;
+            typedef std::vector<BenchmarkComparisonStats> Comparisons;
+            typedef std::vector<BenchmarkComplexityStats> ComplexityFits;
+            typedef std::vector<BenchmarkScalingStats> Scalings;
             ChildSections childSections;
             Assertions assertions;
+            Benchmarks benchmarks;
+            Comparisons comparisons;
+            ComplexityFits complexityFits;
+            Scalings scalings;
             std::string stdOut;
             std::string stdErr;
         };
@@ -172,6 +181,22 @@ namespace Catch {
             sectionNode.assertions.push_back( assertionStats );
             return true;
         }
+        virtual void benchmarkEnded( BenchmarkStats const& benchmarkStats ) CATCH_OVERRIDE {
+            assert( !m_sectionStack.empty() );
+            m_sectionStack.back()->benchmarks.push_back( benchmarkStats );
+        }
+        virtual void benchmarkCompared( BenchmarkComparisonStats const& comparisonStats ) CATCH_OVERRIDE {
+            assert( !m_sectionStack.empty() );
+            m_sectionStack.back()->comparisons.push_back( comparisonStats );
+        }
+        virtual void benchmarkFitted( BenchmarkComplexityStats const& complexityStats ) CATCH_OVERRIDE {
+            assert( !m_sectionStack.empty() );
+            m_sectionStack.back()->complexityFits.push_back( complexityStats );
+        }
+        virtual void benchmarkScaled( BenchmarkScalingStats const& scalingStats ) CATCH_OVERRIDE {
+            assert( !m_sectionStack.empty() );
+            m_sectionStack.back()->scalings.push_back( scalingStats );
+        }
         virtual void sectionEnded( SectionStats const& sectionStats ) CATCH_OVERRIDE {
             assert( !m_sectionStack.empty() );
             SectionNode& node = *m_sectionStack.back();
@@ -230,6 +255,14 @@ namespace Catch {
         return line;
     }
 
+    // The sections selected with -c, as "outer > inner"
+    inline std::string selectedSectionPath( IConfig const& config ) {
+        std::string path;
+        std::vector<std::string> const& sections = config.sectionsToRun();
+        for( std::size_t i = 0; i < sections.size(); ++i )
+            path += ( i > 0 ? " > " : "" ) + sections[i];
+        return path;
+    }
 
     struct TestEventListenerBase : StreamingReporterBase {
         TestEventListenerBase( ReporterConfig const& _config )
@@ -60,6 +60,8 @@ namespace Catch {
         }
 
         virtual void testRunEnded( TestRunStats const& _testRunStats ) override {
+            if( !m_config->sectionsToRun().empty() )
+                stream << "Sections run: " << selectedSectionPath( *m_config ) << "\n";
             printTotals( _testRunStats.totals );
             stream << "\n" << std::endl;
             StreamingReporterBase::testRunEnded( _testRunStats );
@@ -53,6 +53,112 @@ namespace Catch {
             return true;
         }
 
+        virtual void benchmarkEnded( BenchmarkStats const& _benchmarkStats ) CATCH_OVERRIDE {
+            lazyPrint();
+
+            std::size_t percent = static_cast<std::size_t>( _benchmarkStats.mean.confidenceInterval * 100 + 0.5 );
+            {
+                Colour colour( Colour::Headers );
+                stream << "Benchmark '" << _benchmarkStats.name << "': ";
+            }
+            stream << pluralise( _benchmarkStats.samples.size(), "sample" )
+                   << " of " << pluralise( _benchmarkStats.iterations, "iteration" ) << "\n"
+                   << "  mean:     " << formatBenchmarkDuration( _benchmarkStats.mean.point )
+                   << " [" << formatBenchmarkDuration( _benchmarkStats.mean.lowerBound )
+                   << " - " << formatBenchmarkDuration( _benchmarkStats.mean.upperBound )
+                   << "] (" << percent << "% confidence)\n"
+                   << "  median:   " << formatBenchmarkDuration( _benchmarkStats.median ) << "\n"
+                   << "  std dev:  " << formatBenchmarkDuration( _benchmarkStats.standardDeviation.point )
+                   << " [" << formatBenchmarkDuration( _benchmarkStats.standardDeviation.lowerBound )
+                   << " - " << formatBenchmarkDuration( _benchmarkStats.standardDeviation.upperBound ) << "]\n";
+            BenchmarkOutliers const& outliers = _benchmarkStats.outliers;
+            if( outliers.total() > 0 ) {
+                Colour colour( Colour::SecondaryText );
+                stream << "  outliers: " << outliers.total() << " of " << outliers.samplesSeen << " (";
+                char const* separator = "";
+                printOutlierCount( separator, outliers.lowSevere, "low severe" );
+                printOutlierCount( separator, outliers.lowMild, "low mild" );
+                printOutlierCount( separator, outliers.highMild, "high mild" );
+                printOutlierCount( separator, outliers.highSevere, "high severe" );
+                stream << ")\n";
+            }
+            stream << std::endl;
+        }
+
+        virtual void benchmarkCompared( BenchmarkComparisonStats const& _comparisonStats ) CATCH_OVERRIDE {
+            lazyPrint();
+
+            std::size_t percent = static_cast<std::size_t>( _comparisonStats.ratio.confidenceInterval * 100 + 0.5 );
+            {
+                Colour colour( Colour::Headers );
+                stream << "Benchmark '" << _comparisonStats.newName << "' against '" << _comparisonStats.oldName << "': ";
+            }
+            std::ostringstream ratio;
+            ratio << std::fixed << std::setprecision( 3 ) << _comparisonStats.ratio.point
+                  << " [" << _comparisonStats.ratio.lowerBound << " - " << _comparisonStats.ratio.upperBound << "]";
+            stream << pluralise( _comparisonStats.samples, "sample" ) << " of each, interleaved\n"
+                   << "  ratio:    " << ratio.str() << " (" << percent << "% confidence)\n"
+                   << "  verdict:  ";
+            if( _comparisonStats.newIsSlower() ) {
+                Colour colour( Colour::ResultError );
+                stream << "'" << _comparisonStats.newName << "' is slower";
+            }
+            else if( _comparisonStats.newIsFaster() ) {
+                Colour colour( Colour::ResultSuccess );
+                stream << "'" << _comparisonStats.newName << "' is faster";
+            }
+            else
+                stream << "no significant difference";
+            stream << " (Mann-Whitney p = "
+                   << std::min( _comparisonStats.pNewSlower, _comparisonStats.pNewFaster ) << ")\n"
+                   << std::endl;
+        }
+
+        virtual void benchmarkFitted( BenchmarkComplexityStats const& _complexityStats ) CATCH_OVERRIDE {
+            lazyPrint();
+
+            {
+                Colour colour( Colour::Headers );
+                stream << "Benchmark '" << _complexityStats.name << "': ";
+            }
+            stream << pluralise( _complexityStats.sizes.size(), "size" );
+            if( !_complexityStats.sizes.empty() )
+                stream << ", n from " << _complexityStats.sizes.front() << " to " << _complexityStats.sizes.back();
+            std::ostringstream rms;
+            rms << std::fixed << std::setprecision( 1 );
+            for( std::vector<ComplexityFit>::const_iterator it = _complexityStats.fits.begin(), itEnd = _complexityStats.fits.end(); it != itEnd; ++it )
+                rms << ( it == _complexityStats.fits.begin() ? "" : ", " ) << complexityName( it->order ) << " " << it->rms * 100 << "%";
+            stream << "\n"
+                   << "  best fit: " << complexityName( _complexityStats.best.order )
+                   << " (" << formatBenchmarkDuration( _complexityStats.best.coefficient ) << " per step)\n"
+                   << "  RMS:      " << rms.str() << "\n"
+                   << std::endl;
+        }
+
+        virtual void benchmarkScaled( BenchmarkScalingStats const& _scalingStats ) CATCH_OVERRIDE {
+            lazyPrint();
+
+            {
+                Colour colour( Colour::Headers );
+                stream << "Benchmark '" << _scalingStats.name << "': ";
+            }
+            stream << pluralise( _scalingStats.samples, "round" )
+                   << " of " << pluralise( _scalingStats.iterations, "iteration" ) << " per thread\n"
+                   << "  " << std::setw( 7 ) << "threads"
+                   << std::setw( 17 ) << "ops/s"
+                   << std::setw( 17 ) << "per thread"
+                   << std::setw( 11 ) << "efficiency" << "\n";
+            for( std::vector<BenchmarkThreadScaling>::const_iterator it = _scalingStats.threadCounts.begin(), itEnd = _scalingStats.threadCounts.end(); it != itEnd; ++it ) {
+                std::ostringstream efficiency;
+                efficiency << std::fixed << std::setprecision( 1 ) << it->efficiency * 100 << "%";
+                stream << "  " << std::setw( 7 ) << it->threads
+                       << std::setw( 17 ) << formatBenchmarkRate( it->opsPerSecond )
+                       << std::setw( 17 ) << formatBenchmarkRate( it->opsPerSecondPerThread )
+                       << std::setw( 11 ) << efficiency.str() << "\n";
+            }
+            stream << std::endl;
+        }
+
         virtual void sectionStarting( SectionInfo const& _sectionInfo ) CATCH_OVERRIDE {
             m_headerPrinted = false;
             StreamingReporterBase::sectionStarting( _sectionInfo );
@@ -93,6 +199,10 @@ namespace Catch {
             StreamingReporterBase::testGroupEnded( _testGroupStats );
         }
         virtual void testRunEnded( TestRunStats const& _testRunStats ) CATCH_OVERRIDE {
+            if( !m_config->sectionsToRun().empty() ) {
+                Colour colour( Colour::SecondaryText );
+                stream << "Only the sections along this path were run: " << selectedSectionPath( *m_config ) << "\n";
+            }
             printTotalsDivider( _testRunStats.totals );
             printTotals( _testRunStats.totals );
             stream << std::endl;
@@ -101,6 +211,13 @@ namespace Catch {
 
     private:
 
+        void printOutlierCount( char const*& separator, std::size_t count, char const* kind ) {
+            if( count > 0 ) {
+                stream << separator << count << " " << kind;
+                separator = ", ";
+            }
+        }
+
         class AssertionPrinter {
             void operator= ( AssertionPrinter const& );
         public:
@@ -109,10 +109,11 @@ namespace Catch {
                 if( rootSection.childSections.empty() )
                     className = "global";
             }
-            writeSection( className, "", rootSection );
+            writeSection( stats, className, "", rootSection );
         }
 
-        void writeSection(  std::string const& className,
+        void writeSection(  TestCaseStats const& testCaseStats,
+                            std::string const& className,
                             std::string const& rootName,
                             SectionNode const& sectionNode ) {
             std::string name = trim( sectionNode.stats.sectionInfo.name );
@@ -120,6 +121,8 @@ namespace Catch {
                 name = rootName + "/" + name;
 
             if( !sectionNode.assertions.empty() ||
+                !sectionNode.benchmarks.empty() ||
+                !sectionNode.scalings.empty() ||
                 !sectionNode.stdOut.empty() ||
                 !sectionNode.stdErr.empty() ) {
                 XmlWriter::ScopedElement e = xml.scopedElement( "testcase" );
@@ -132,7 +135,12 @@ namespace Catch {
                     xml.writeAttribute( "name", name );
                 }
                 xml.writeAttribute( "time", Catch::toString( sectionNode.stats.durationInSeconds ) );
+                if( testCaseStats.retryOutcome != RetryOutcome::NotRetried ) {
+                    xml.writeAttribute( "retryOutcome", retryOutcomeName( testCaseStats.retryOutcome ) );
+                    xml.writeAttribute( "retries", testCaseStats.retries );
+                }
 
+                writeBenchmarks( sectionNode );
                 writeAssertions( sectionNode );
 
                 if( !sectionNode.stdOut.empty() )
@@ -146,9 +154,68 @@ namespace Catch {
                     it != itEnd;
                     ++it )
                 if( className.empty() )
-                    writeSection( name, "", **it );
+                    writeSection( testCaseStats, name, "", **it );
                 else
-                    writeSection( className, name, **it );
+                    writeSection( testCaseStats, className, name, **it );
+        }
+
+        // As properties of the test case, named after the benchmark, with times in nanoseconds
+        void writeBenchmarks( SectionNode const& sectionNode ) {
+            if( sectionNode.benchmarks.empty() && sectionNode.scalings.empty() )
+                return;
+            XmlWriter::ScopedElement e = xml.scopedElement( "properties" );
+            for( SectionNode::Benchmarks::const_iterator
+                    it = sectionNode.benchmarks.begin(), itEnd = sectionNode.benchmarks.end();
+                    it != itEnd;
+                    ++it ) {
+                std::string prefix = "benchmark:" + trim( it->name ) + ":";
+                writeProperty( prefix + "samples", it->samples.size() );
+                writeProperty( prefix + "iterations", it->iterations );
+                writeProperty( prefix + "mean", it->mean.point );
+                writeProperty( prefix + "meanLowerBound", it->mean.lowerBound );
+                writeProperty( prefix + "meanUpperBound", it->mean.upperBound );
+                writeProperty( prefix + "median", it->median );
+                writeProperty( prefix + "standardDeviation", it->standardDeviation.point );
+                writeProperty( prefix + "outliers", it->outliers.total() );
+            }
+            // Comparisons come after the benchmarks of both their variants
+            for( SectionNode::Comparisons::const_iterator
+                    it = sectionNode.comparisons.begin(), itEnd = sectionNode.comparisons.end();
+                    it != itEnd;
+                    ++it ) {
+                std::string prefix = "benchmark:" + trim( it->newName ) + ":against:" + trim( it->oldName ) + ":";
+                writeProperty( prefix + "ratio", it->ratio.point );
+                writeProperty( prefix + "ratioLowerBound", it->ratio.lowerBound );
+                writeProperty( prefix + "ratioUpperBound", it->ratio.upperBound );
+                writeProperty( prefix + "pNewSlower", it->pNewSlower );
+                writeProperty( prefix + "pNewFaster", it->pNewFaster );
+            }
+            for( SectionNode::ComplexityFits::const_iterator
+                    it = sectionNode.complexityFits.begin(), itEnd = sectionNode.complexityFits.end();
+                    it != itEnd;
+                    ++it ) {
+                std::string prefix = "benchmark:" + trim( it->name ) + ":";
+                writeProperty( prefix + "complexity", std::string( complexityName( it->best.order ) ) );
+                writeProperty( prefix + "complexityRms", it->best.rms );
+            }
+            for( SectionNode::Scalings::const_iterator
+                    it = sectionNode.scalings.begin(), itEnd = sectionNode.scalings.end();
+                    it != itEnd;
+                    ++it )
+                for( std::vector<BenchmarkThreadScaling>::const_iterator
+                        scaling = it->threadCounts.begin(), scalingEnd = it->threadCounts.end();
+                        scaling != scalingEnd;
+                        ++scaling ) {
+                    std::string prefix = "benchmark:" + trim( it->name ) + ":threads:" + Catch::toString( scaling->threads ) + ":";
+                    writeProperty( prefix + "opsPerSecond", scaling->opsPerSecond );
+                    writeProperty( prefix + "efficiency", scaling->efficiency );
+                }
+        }
+        template<typename T>
+        void writeProperty( std::string const& name, T const& value ) {
+            xml.scopedElement( "property" )
+                .writeAttribute( "name", name )
+                .writeAttribute( "value", value );
         }
 
         void writeAssertions( SectionNode const& sectionNode ) {
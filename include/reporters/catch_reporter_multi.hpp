@@ -83,6 +83,34 @@ public: // IStreamingReporter
         return clearBuffer;
     }
 
+    virtual void benchmarkEnded( BenchmarkStats const& benchmarkStats ) CATCH_OVERRIDE {
+        for( Reporters::const_iterator it = m_reporters.begin(), itEnd = m_reporters.end();
+                it != itEnd;
+                ++it )
+            (*it)->benchmarkEnded( benchmarkStats );
+    }
+
+    virtual void benchmarkCompared( BenchmarkComparisonStats const& comparisonStats ) CATCH_OVERRIDE {
+        for( Reporters::const_iterator it = m_reporters.begin(), itEnd = m_reporters.end();
+                it != itEnd;
+                ++it )
+            (*it)->benchmarkCompared( comparisonStats );
+    }
+
+    virtual void benchmarkFitted( BenchmarkComplexityStats const& complexityStats ) CATCH_OVERRIDE {
+        for( Reporters::const_iterator it = m_reporters.begin(), itEnd = m_reporters.end();
+                it != itEnd;
+                ++it )
+            (*it)->benchmarkFitted( complexityStats );
+    }
+
+    virtual void benchmarkScaled( BenchmarkScalingStats const& scalingStats ) CATCH_OVERRIDE {
+        for( Reporters::const_iterator it = m_reporters.begin(), itEnd = m_reporters.end();
+                it != itEnd;
+                ++it )
+            (*it)->benchmarkScaled( scalingStats );
+    }
+
     virtual void sectionEnded( SectionStats const& sectionStats ) CATCH_OVERRIDE {
         for( Reporters::const_iterator it = m_reporters.begin(), itEnd = m_reporters.end();
                 it != itEnd;
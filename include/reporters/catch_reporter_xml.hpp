@@ -43,6 +43,9 @@ namespace Catch {
             m_xml.startElement( "Catch" );
             if( !m_config->name().empty() )
                 m_xml.writeAttribute( "name", m_config->name() );
+            std::vector<std::string> const& sections = m_config->sectionsToRun();
+            for( std::size_t i = 0; i < sections.size(); ++i )
+                m_xml.scopedElement( "SelectedSection" ).writeAttribute( "name", sections[i] );
         }
 
         virtual void testGroupStarting( GroupInfo const& groupInfo ) CATCH_OVERRIDE {
@@ -141,6 +144,82 @@ namespace Catch {
             return true;
         }
 
+        // Times are in nanoseconds
+        virtual void benchmarkEnded( BenchmarkStats const& benchmarkStats ) CATCH_OVERRIDE {
+            m_xml.startElement( "BenchmarkResults" )
+                .writeAttribute( "name", trim( benchmarkStats.name ) )
+                .writeAttribute( "filename", benchmarkStats.lineInfo.file )
+                .writeAttribute( "line", benchmarkStats.lineInfo.line )
+                .writeAttribute( "samples", benchmarkStats.samples.size() )
+                .writeAttribute( "iterations", benchmarkStats.iterations )
+                .writeAttribute( "resamples", benchmarkStats.resamples )
+                .writeAttribute( "clockResolution", benchmarkStats.clockResolution )
+                .writeAttribute( "clockOverhead", benchmarkStats.clockOverhead );
+            writeBenchmarkEstimate( "mean", benchmarkStats.mean );
+            m_xml.scopedElement( "median" )
+                .writeAttribute( "value", benchmarkStats.median );
+            writeBenchmarkEstimate( "standardDeviation", benchmarkStats.standardDeviation );
+            m_xml.scopedElement( "outliers" )
+                .writeAttribute( "variance", benchmarkStats.outliers.total() )
+                .writeAttribute( "lowSevere", benchmarkStats.outliers.lowSevere )
+                .writeAttribute( "lowMild", benchmarkStats.outliers.lowMild )
+                .writeAttribute( "highMild", benchmarkStats.outliers.highMild )
+                .writeAttribute( "highSevere", benchmarkStats.outliers.highSevere );
+            m_xml.endElement();
+        }
+
+        virtual void benchmarkCompared( BenchmarkComparisonStats const& comparisonStats ) CATCH_OVERRIDE {
+            m_xml.startElement( "BenchmarkComparison" )
+                .writeAttribute( "old", trim( comparisonStats.oldName ) )
+                .writeAttribute( "new", trim( comparisonStats.newName ) )
+                .writeAttribute( "filename", comparisonStats.lineInfo.file )
+                .writeAttribute( "line", comparisonStats.lineInfo.line )
+                .writeAttribute( "samples", comparisonStats.samples );
+            writeBenchmarkEstimate( "ratio", comparisonStats.ratio );
+            m_xml.scopedElement( "mannWhitney" )
+                .writeAttribute( "z", comparisonStats.z )
+                .writeAttribute( "pNewSlower", comparisonStats.pNewSlower )
+                .writeAttribute( "pNewFaster", comparisonStats.pNewFaster );
+            m_xml.endElement();
+        }
+
+        virtual void benchmarkFitted( BenchmarkComplexityStats const& complexityStats ) CATCH_OVERRIDE {
+            m_xml.startElement( "BenchmarkComplexity" )
+                .writeAttribute( "name", trim( complexityStats.name ) )
+                .writeAttribute( "filename", complexityStats.lineInfo.file )
+                .writeAttribute( "line", complexityStats.lineInfo.line )
+                .writeAttribute( "bestFit", complexityName( complexityStats.best.order ) )
+                .writeAttribute( "rms", complexityStats.best.rms );
+            for( std::size_t i = 0; i < complexityStats.sizes.size(); ++i )
+                m_xml.scopedElement( "size" )
+                    .writeAttribute( "n", complexityStats.sizes[i] )
+                    .writeAttribute( "median", complexityStats.medians[i] );
+            for( std::vector<ComplexityFit>::const_iterator it = complexityStats.fits.begin(), itEnd = complexityStats.fits.end(); it != itEnd; ++it )
+                m_xml.scopedElement( "fit" )
+                    .writeAttribute( "complexity", complexityName( it->order ) )
+                    .writeAttribute( "coefficient", it->coefficient )
+                    .writeAttribute( "rms", it->rms );
+            m_xml.endElement();
+        }
+
+        // Times are in nanoseconds and throughputs in operations per second
+        virtual void benchmarkScaled( BenchmarkScalingStats const& scalingStats ) CATCH_OVERRIDE {
+            m_xml.startElement( "BenchmarkScaling" )
+                .writeAttribute( "name", trim( scalingStats.name ) )
+                .writeAttribute( "filename", scalingStats.lineInfo.file )
+                .writeAttribute( "line", scalingStats.lineInfo.line )
+                .writeAttribute( "rounds", scalingStats.samples )
+                .writeAttribute( "iterations", scalingStats.iterations );
+            for( std::vector<BenchmarkThreadScaling>::const_iterator it = scalingStats.threadCounts.begin(), itEnd = scalingStats.threadCounts.end(); it != itEnd; ++it )
+                m_xml.scopedElement( "threads" )
+                    .writeAttribute( "count", it->threads )
+                    .writeAttribute( "medianTime", it->medianTime )
+                    .writeAttribute( "opsPerSecond", it->opsPerSecond )
+                    .writeAttribute( "opsPerSecondPerThread", it->opsPerSecondPerThread )
+                    .writeAttribute( "efficiency", it->efficiency );
+            m_xml.endElement();
+        }
+
         virtual void sectionEnded( SectionStats const& sectionStats ) CATCH_OVERRIDE {
             StreamingReporterBase::sectionEnded( sectionStats );
             if( --m_sectionDepth > 0 ) {
@@ -160,6 +239,14 @@ namespace Catch {
             StreamingReporterBase::testCaseEnded( testCaseStats );
             XmlWriter::ScopedElement e = m_xml.scopedElement( "OverallResult" );
             e.writeAttribute( "success", testCaseStats.totals.assertions.allOk() );
+            if( testCaseStats.retryOutcome != RetryOutcome::NotRetried )
+                e.writeAttribute( "retryOutcome", retryOutcomeName( testCaseStats.retryOutcome ) )
+                    .writeAttribute( "retries", testCaseStats.retries );
+            if( testCaseStats.placement.cpu >= 0 ) {
+                e.writeAttribute( "cpu", testCaseStats.placement.cpu );
+                if( testCaseStats.placement.numaNode >= 0 )
+                    e.writeAttribute( "numaNode", testCaseStats.placement.numaNode );
+            }
 
             if ( m_config->showDurations() == ShowDurations::Always )
                 e.writeAttribute( "durationInSeconds", m_testCaseTimer.getElapsedSeconds() );
@@ -187,6 +274,14 @@ namespace Catch {
         }
 
     private:
+        void writeBenchmarkEstimate( std::string const& name, BenchmarkEstimate const& estimate ) {
+            m_xml.scopedElement( name )
+                .writeAttribute( "value", estimate.point )
+                .writeAttribute( "lowerBound", estimate.lowerBound )
+                .writeAttribute( "upperBound", estimate.upperBound )
+                .writeAttribute( "ci", estimate.confidenceInterval );
+        }
+
         Timer m_testCaseTimer;
         XmlWriter m_xml;
         int m_sectionDepth;
@@ -0,0 +1,547 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch.hpp"
+#include "internal/catch_config.hpp"
+#include "internal/catch_benchmark_analysis.hpp"
+#include "internal/catch_benchmark_baseline.hpp"
+#include "SelfTestHelpers.h"
+#include "LastGitCommit.h"
+
+#include <thread>
+#include <atomic>
+#include <numeric>
+#include <sstream>
+#include <cstdio>
+
+TEST_CASE( "Benchmark samples are summarised", "[benchmark]" ) {
+
+    using namespace Catch;
+    BenchmarkStats stats( "summary", CATCH_INTERNAL_LINEINFO );
+    for( int i = 1; i <= 9; ++i )
+        stats.samples.push_back( 10 + i % 3 );
+    stats.samples.push_back( 100 );
+    Benchmark::analyse( stats, 1000, 0.95 );
+
+    CHECK( stats.resamples == 1000 );
+    CHECK( stats.mean.point == Approx( 19.9 ) );
+    CHECK( stats.mean.lowerBound <= stats.mean.point );
+    CHECK( stats.mean.upperBound >= stats.mean.point );
+    CHECK( stats.mean.confidenceInterval == Approx( 0.95 ) );
+    CHECK( stats.median == Approx( 11 ) );
+    CHECK( stats.standardDeviation.point == Approx( 28.1561 ) );
+    CHECK( stats.outliers.samplesSeen == 10 );
+    CHECK( stats.outliers.highSevere == 1 );
+    CHECK( stats.outliers.total() == 1 );
+
+    // The resampling is seeded, so the same samples give the same bounds
+    BenchmarkStats again( stats );
+    Benchmark::analyse( again, 1000, 0.95 );
+    CHECK( again.mean.lowerBound == stats.mean.lowerBound );
+    CHECK( again.mean.upperBound == stats.mean.upperBound );
+}
+
+TEST_CASE( "Benchmark samples can be ranked against each other", "[benchmark]" ) {
+
+    using namespace Catch;
+    std::vector<double> fast, slow;
+    for( int i = 0; i < 10; ++i ) {
+        fast.push_back( 100 + i );
+        slow.push_back( 105 + i * 2 );
+    }
+
+    Benchmark::RankSumTest slower = Benchmark::mannWhitney( fast, slow );
+    CHECK( slower.z > 0 );
+    CHECK( slower.pGreater < 0.01 );
+
+    Benchmark::RankSumTest faster = Benchmark::mannWhitney( slow, fast );
+    CHECK( faster.z < 0 );
+    CHECK( faster.pGreater > 0.99 );
+    CHECK( slower.u + faster.u == Approx( 100 ) );
+
+    Benchmark::RankSumTest same = Benchmark::mannWhitney( fast, fast );
+    CHECK( same.z == Approx( 0 ) );
+    CHECK( same.pGreater == Approx( 0.5 ) );
+}
+
+TEST_CASE( "Benchmark variants can be compared", "[benchmark]" ) {
+
+    using namespace Catch;
+    BenchmarkStats slow( "slow", CATCH_INTERNAL_LINEINFO ), fast( "fast", CATCH_INTERNAL_LINEINFO );
+    for( int i = 0; i < 10; ++i ) {
+        slow.samples.push_back( 200 + i );
+        fast.samples.push_back( 100 + i );
+    }
+
+    BenchmarkComparisonStats faster( "slow", "fast", CATCH_INTERNAL_LINEINFO );
+    Benchmark::compareVariants( faster, slow, fast, 1000, 0.95 );
+    CHECK( faster.samples == 10 );
+    CHECK( faster.ratio.point == Approx( 104.5 / 204.5 ) );
+    CHECK( faster.ratio.lowerBound <= faster.ratio.point );
+    CHECK( faster.ratio.upperBound >= faster.ratio.point );
+    CHECK( faster.ratio.upperBound < 1 );
+    CHECK( faster.newIsFaster() );
+    CHECK_FALSE( faster.newIsSlower() );
+    CHECK( faster.newIsNotSlower( 0.99 ) );
+
+    BenchmarkComparisonStats slower( "fast", "slow", CATCH_INTERNAL_LINEINFO );
+    Benchmark::compareVariants( slower, fast, slow, 1000, 0.95 );
+    CHECK( slower.ratio.lowerBound > 1 );
+    CHECK( slower.newIsSlower() );
+    CHECK_FALSE( slower.newIsNotSlower( 0.99 ) );
+
+    BenchmarkComparisonStats same( "fast", "fast", CATCH_INTERNAL_LINEINFO );
+    Benchmark::compareVariants( same, fast, fast, 1000, 0.95 );
+    CHECK( same.ratio.point == Approx( 1 ) );
+    CHECK_FALSE( same.newIsSlower() );
+    CHECK_FALSE( same.newIsFaster() );
+}
+
+TEST_CASE( "Benchmark times are fitted to orders of growth", "[benchmark]" ) {
+
+    using namespace Catch;
+    BenchmarkComplexityStats stats( "fitted", CATCH_INTERNAL_LINEINFO );
+    for( std::size_t n = 16; n <= 4096; n *= 2 )
+        stats.sizes.push_back( n );
+    stats.medians.resize( stats.sizes.size() );
+
+    SECTION( "n log n", "" ) {
+        for( std::size_t i = 0; i < stats.sizes.size(); ++i )
+            stats.medians[i] = 3 * Benchmark::complexityFunction( Complexity::O_N_LOG_N, static_cast<double>( stats.sizes[i] ) );
+        Benchmark::fitComplexity( stats );
+        REQUIRE( stats.fits.size() == 5 );
+        CHECK( stats.best.order == Complexity::O_N_LOG_N );
+        CHECK( stats.best.coefficient == Approx( 3 ) );
+        CHECK( stats.best.rms < 1e-9 );
+        CHECK( stats.fits[Complexity::O_N].rms > 0.01 );
+    }
+    SECTION( "quadratic", "" ) {
+        for( std::size_t i = 0; i < stats.sizes.size(); ++i )
+            stats.medians[i] = 0.5 * static_cast<double>( stats.sizes[i] * stats.sizes[i] ) + 100;
+        Benchmark::fitComplexity( stats );
+        CHECK( stats.best.order == Complexity::O_N_SQUARED );
+    }
+    SECTION( "only a little better fitted by a higher order", "" ) {
+        for( std::size_t i = 0; i < stats.sizes.size(); ++i ) {
+            double n = static_cast<double>( stats.sizes[i] );
+            stats.medians[i] = 10 * n + Benchmark::complexityFunction( Complexity::O_N_LOG_N, n );
+        }
+        Benchmark::fitComplexity( stats );
+        REQUIRE( stats.fits[Complexity::O_N_LOG_N].rms < stats.fits[Complexity::O_N].rms );
+        CHECK( stats.best.order == Complexity::O_N );
+    }
+    SECTION( "constant", "" ) {
+        for( std::size_t i = 0; i < stats.sizes.size(); ++i )
+            stats.medians[i] = 42 + ( i % 2 );
+        Benchmark::fitComplexity( stats );
+        CHECK( stats.best.order == Complexity::O_1 );
+        CHECK( stats.best.coefficient == Approx( Benchmark::mean( stats.medians ) ) );
+    }
+}
+
+TEST_CASE( "Benchmark throughput is scaled by thread count", "[benchmark]" ) {
+
+    using namespace Catch;
+    BenchmarkScalingStats stats( "scaled", CATCH_INTERNAL_LINEINFO );
+    stats.iterations = 1000;
+    stats.threadCounts.push_back( BenchmarkThreadScaling( 2 ) );
+    stats.threadCounts.push_back( BenchmarkThreadScaling( 4 ) );
+    stats.threadCounts[0].medianTime = 1e6;
+    stats.threadCounts[1].medianTime = 1.6e6;
+    Benchmark::analyseScaling( stats );
+
+    CHECK( stats.threadCounts[0].opsPerSecond == Approx( 2e6 ) );
+    CHECK( stats.threadCounts[0].opsPerSecondPerThread == Approx( 1e6 ) );
+    CHECK( stats.threadCounts[0].efficiency == Approx( 1 ) );
+    CHECK( stats.threadCounts[1].opsPerSecond == Approx( 2.5e6 ) );
+    CHECK( stats.threadCounts[1].opsPerSecondPerThread == Approx( 6.25e5 ) );
+    CHECK( stats.threadCounts[1].efficiency == Approx( 0.625 ) );
+}
+
+TEST_CASE( "Threads are released together by a spin barrier", "[benchmark]" ) {
+
+    static const std::size_t threadCount = 4;
+    static const std::size_t rounds = 100;
+    Catch::Benchmark::SpinBarrier barrier( threadCount );
+    std::atomic<std::size_t> arrived( 0 );
+    std::atomic<std::size_t> early( 0 ); // Threads let through before all had arrived
+    std::vector<std::thread> threads;
+    for( std::size_t i = 0; i < threadCount; ++i )
+        threads.push_back( std::thread( [&]{
+            for( std::size_t round = 1; round <= rounds; ++round ) {
+                ++arrived;
+                barrier.wait();
+                if( arrived.load() < round * threadCount )
+                    ++early;
+                barrier.wait();
+            }
+        } ) );
+    for( std::size_t i = 0; i < threads.size(); ++i )
+        threads[i].join();
+
+    CHECK( arrived.load() == threadCount * rounds );
+    CHECK( early.load() == 0 );
+}
+
+TEST_CASE( "Benchmark baselines can be written and read back", "[benchmark]" ) {
+
+    using namespace Catch;
+    BenchmarkBaseline written( "abc1234" );
+    written.record( "a test", "with\ttab", std::vector<double>( 3, 1.25 ) );
+    written.record( "a test", "another", std::vector<double>( 1, 123456789.5 ) );
+    std::ostringstream oss;
+    written.write( oss );
+
+    BenchmarkBaseline read;
+    std::istringstream iss( oss.str() );
+    read.read( iss );
+    CHECK( read.commit() == "abc1234" );
+    REQUIRE( read.find( "a test", "with\ttab" ) );
+    CHECK( *read.find( "a test", "with\ttab" ) == std::vector<double>( 3, 1.25 ) );
+    REQUIRE( read.find( "a test", "another" ) );
+    CHECK( read.find( "a test", "another" )->front() == Approx( 123456789.5 ) );
+    CHECK_FALSE( read.find( "another test", "another" ) );
+}
+
+namespace {
+    std::size_t benchmarkProbeIterations = 0;
+}
+
+TEST_CASE( "Benchmark probe", "[.][benchmark]" ) {
+    SECTION( "summing", "" ) {
+        BENCHMARK( "sum" ) {
+            ++benchmarkProbeIterations;
+            std::size_t sum = 0;
+            for( std::size_t i = 0; i < 100; ++i )
+                sum += i * i;
+            Catch::Benchmark::keepAlive( sum );
+        }
+    }
+}
+
+TEST_CASE( "Benchmarks are timed and reported", "[benchmark]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][benchmark]" );
+    configData.benchmarkSamples = 5;
+    configData.benchmarkResamples = 100;
+    configData.benchmarkWarmupTime = 0;
+
+    SECTION( "by the console reporter", "" ) {
+        std::string output;
+        benchmarkProbeIterations = 0;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK( benchmarkProbeIterations >= 5 );
+        CHECK_THAT( output, Contains( "summing" ) );
+        CHECK_THAT( output, Contains( "Benchmark 'sum': 5 samples of" ) );
+        CHECK_THAT( output, Contains( "(95% confidence)" ) );
+        CHECK_THAT( output, Contains( "  median:   " ) );
+    }
+    SECTION( "by the xml reporter", "" ) {
+        configData.reporterNames.push_back( "xml" );
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "<BenchmarkResults name=\"sum\"" ) );
+        CHECK_THAT( output, Contains( "samples=\"5\"" ) );
+        CHECK_THAT( output, Contains( "resamples=\"100\"" ) );
+        CHECK_THAT( output, Contains( "<standardDeviation value=" ) );
+    }
+    SECTION( "by the junit reporter", "" ) {
+        configData.reporterNames.push_back( "junit" );
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "<property name=\"benchmark:sum:samples\" value=\"5\"/>" ) );
+    }
+    SECTION( "when run in a worker", "" ) {
+        configData.workers = 1;
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "Benchmark 'sum': 5 samples of" ) );
+    }
+}
+
+namespace {
+    std::size_t sumOfSquares( std::size_t n, std::size_t offset ) {
+        std::size_t sum = 0;
+        for( std::size_t i = 0; i < n; ++i )
+            sum += ( i + offset ) * ( i + offset );
+        return sum;
+    }
+}
+
+TEST_CASE( "Benchmark comparison probe: faster", "[.][benchmark-compare]" ) {
+    Catch::BenchmarkComparisonStats comparison = BENCHMARK_COMPARE(
+        "slow", [&]{ Catch::Benchmark::keepAlive( sumOfSquares( 2000, 1 ) ); },
+        "fast", [&]{ Catch::Benchmark::keepAlive( sumOfSquares( 20, 1 ) ); } );
+    REQUIRE( comparison.newIsNotSlower( 0.95 ) );
+}
+
+TEST_CASE( "Benchmark comparison probe: slower", "[.][benchmark-slower]" ) {
+    Catch::BenchmarkComparisonStats comparison = BENCHMARK_COMPARE(
+        "fast", [&]{ Catch::Benchmark::keepAlive( sumOfSquares( 20, 1 ) ); },
+        "slow", [&]{ Catch::Benchmark::keepAlive( sumOfSquares( 2000, 1 ) ); } );
+    REQUIRE( comparison.newIsNotSlower( 0.95 ) );
+}
+
+TEST_CASE( "Benchmark variants are sampled in turn and compared", "[benchmark]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][benchmark-compare]" );
+    configData.benchmarkSamples = 10;
+    configData.benchmarkResamples = 100;
+    configData.benchmarkWarmupTime = 0;
+
+    SECTION( "by the console reporter", "" ) {
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "Benchmark 'slow': 10 samples of" ) );
+        CHECK_THAT( output, Contains( "Benchmark 'fast': 10 samples of" ) );
+        CHECK_THAT( output, Contains( "Benchmark 'fast' against 'slow'" ) );
+        CHECK_THAT( output, Contains( "10 samples of each, interleaved" ) );
+        CHECK_THAT( output, Contains( "'fast' is faster" ) );
+    }
+    SECTION( "by the xml reporter", "" ) {
+        configData.reporterNames.push_back( "xml" );
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "<BenchmarkComparison old=\"slow\" new=\"fast\"" ) );
+        CHECK_THAT( output, Contains( "<ratio value=" ) );
+        CHECK_THAT( output, Contains( "<mannWhitney z=" ) );
+    }
+    SECTION( "by the junit reporter", "" ) {
+        configData.reporterNames.push_back( "junit" );
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "<property name=\"benchmark:fast:against:slow:ratio\"" ) );
+    }
+    SECTION( "when run in a worker", "" ) {
+        configData.workers = 1;
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "'fast' is faster" ) );
+    }
+    SECTION( "failing a new variant required not to be slower", "" ) {
+        configData.testsOrTags[0] = "[.][benchmark-slower]";
+        std::string output;
+        CHECK( runSession( configData, output ) == 1 );
+        CHECK_THAT( output, Contains( "'slow' is slower" ) );
+        CHECK_THAT( output, Contains( "comparison.newIsNotSlower( 0.95 )" ) );
+    }
+}
+
+namespace {
+    std::vector<std::size_t> const& rangeProbeValues() {
+        static std::vector<std::size_t> values( 65536, 3 );
+        return values;
+    }
+}
+
+TEST_CASE( "Benchmark range probe: linear", "[.][benchmark-range]" ) {
+    std::vector<std::size_t> const& values = rangeProbeValues();
+    BENCHMARK_RANGE( "sum", n, Catch::Generators::geometric<std::size_t>( 1024, 65536, 4 ) ) {
+        Catch::Benchmark::keepAlive( std::accumulate( values.begin(), values.begin() + n, std::size_t( 0 ) ) );
+    }
+    REQUIRE_COMPLEXITY( O_N );
+}
+
+TEST_CASE( "Benchmark range probe: quadratic", "[.][benchmark-quadratic]" ) {
+    std::vector<std::size_t> const& values = rangeProbeValues();
+    BENCHMARK_RANGE( "pairs", n, Catch::Generators::geometric<std::size_t>( 64, 1024 ) ) {
+        std::size_t pairs = 0;
+        for( std::size_t i = 0; i < n; ++i )
+            for( std::size_t j = 0; j < n; ++j )
+                pairs += values[i] ^ ( values[j] + j );
+        Catch::Benchmark::keepAlive( pairs );
+    }
+    REQUIRE_COMPLEXITY( O_N_LOG_N );
+}
+
+namespace {
+    // The rest of the suite may be loading the machine meanwhile, which can
+    // throw the times of a whole size out: a run so disturbed is run again
+    int runRangeSession( Catch::ConfigData const& configData, std::string& output ) {
+        int result = 1;
+        for( int attempt = 0; attempt < 5 && result != 0; ++attempt ) {
+            output.clear();
+            result = runSession( configData, output );
+        }
+        return result;
+    }
+}
+
+TEST_CASE( "Benchmark ranges are fitted to orders of growth", "[benchmark]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][benchmark-range]" );
+    configData.benchmarkSamples = 10;
+    configData.benchmarkResamples = 100;
+    configData.benchmarkWarmupTime = 5;
+
+    SECTION( "by the console reporter", "" ) {
+        std::string output;
+        CHECK( runRangeSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "Benchmark 'sum/1024': 10 samples of" ) );
+        CHECK_THAT( output, Contains( "Benchmark 'sum/65536': 10 samples of" ) );
+        CHECK_THAT( output, Contains( "Benchmark 'sum': 4 sizes, n from 1024 to 65536" ) );
+        CHECK_THAT( output, Contains( "best fit: O(n) (" ) );
+        CHECK_THAT( output, Contains( "O(n log n)" ) );
+    }
+    SECTION( "by the xml reporter", "" ) {
+        configData.reporterNames.push_back( "xml" );
+        std::string output;
+        CHECK( runRangeSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "<BenchmarkComplexity name=\"sum\"" ) );
+        CHECK_THAT( output, Contains( "<size n=\"4096\"" ) );
+        CHECK_THAT( output, Contains( "<fit complexity=\"O(n^2)\"" ) );
+    }
+    SECTION( "by the junit reporter", "" ) {
+        configData.reporterNames.push_back( "junit" );
+        std::string output;
+        CHECK( runRangeSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "<property name=\"benchmark:sum:complexity\"" ) );
+    }
+    SECTION( "when run in a worker", "" ) {
+        configData.workers = 1;
+        std::string output;
+        CHECK( runRangeSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "Benchmark 'sum': 4 sizes" ) );
+    }
+    SECTION( "failing a complexity above the one required", "" ) {
+        configData.testsOrTags[0] = "[.][benchmark-quadratic]";
+        std::string output;
+        CHECK( runSession( configData, output ) == 1 );
+        CHECK_THAT( output, Contains( "best fit: O(n^2)" ) );
+        CHECK_THAT( output, Contains( "REQUIRE_COMPLEXITY( O_N_LOG_N )" ) );
+        CHECK_THAT( output, Contains( "O(n^2) is at most O(n log n)" ) );
+    }
+}
+
+namespace {
+    std::atomic<std::size_t> threadsProbeCalls( 0 );
+}
+
+TEST_CASE( "Benchmark threads probe", "[.][benchmark-threads]" ) {
+    Catch::BenchmarkScalingStats scaling = BENCHMARK_THREADS( "count", Catch::Generators::between( 1, 2 ), [&]{
+        threadsProbeCalls.fetch_add( 1, std::memory_order_relaxed );
+    } );
+    REQUIRE( scaling.threadCounts.size() == 2 );
+    CHECK( scaling.threadCounts[0].efficiency == Approx( 1 ) );
+    CHECK( scaling.threadCounts[1].opsPerSecond > 0 );
+}
+
+TEST_CASE( "Benchmark threads probe: throwing", "[.][benchmark-threads-throw]" ) {
+    std::thread::id testThread = std::this_thread::get_id();
+    BENCHMARK_THREADS( "throw", Catch::Generators::values( 1, 3 ), [&]{
+        if( std::this_thread::get_id() != testThread )
+            throw std::runtime_error( "thrown on a benchmark thread" );
+    } );
+}
+
+TEST_CASE( "Benchmark threads probe: pinned", "[.][benchmark-threads-pinned]" ) {
+    BENCHMARK_THREADS( "pinned", Catch::Generators::values( 1, 3 ), [&]{
+        CHECK( Catch::CpuPinning::current().cpu == 0 );
+    } );
+}
+
+TEST_CASE( "Benchmarks are run on each thread count", "[benchmark]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][benchmark-threads]" );
+    configData.benchmarkSamples = 5;
+    configData.benchmarkResamples = 100;
+    configData.benchmarkWarmupTime = 0;
+
+    SECTION( "by the console reporter", "" ) {
+        std::string output;
+        threadsProbeCalls = 0;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK( threadsProbeCalls.load() > 0 );
+        CHECK_THAT( output, Contains( "Benchmark 'count': 5 rounds of" ) );
+        CHECK_THAT( output, Contains( "threads            ops/s       per thread efficiency" ) );
+        CHECK_THAT( output, Contains( "100.0%" ) );
+    }
+    SECTION( "by the xml reporter", "" ) {
+        configData.reporterNames.push_back( "xml" );
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "<BenchmarkScaling name=\"count\"" ) );
+        CHECK_THAT( output, Contains( "<threads count=\"2\"" ) );
+        CHECK_THAT( output, Contains( "efficiency=" ) );
+    }
+    SECTION( "by the junit reporter", "" ) {
+        configData.reporterNames.push_back( "junit" );
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "<property name=\"benchmark:count:threads:2:opsPerSecond\"" ) );
+    }
+    SECTION( "when run in a worker", "" ) {
+        configData.workers = 1;
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "Benchmark 'count': 5 rounds of" ) );
+    }
+    SECTION( "failing on an exception from any thread", "" ) {
+        configData.testsOrTags[0] = "[.][benchmark-threads-throw]";
+        std::string output;
+        CHECK( runSession( configData, output ) == 1 );
+        CHECK_THAT( output, Contains( "thrown on a benchmark thread" ) );
+    }
+    SECTION( "with each thread pinned, checking where it runs", "" ) {
+        configData.testsOrTags[0] = "[.][benchmark-threads-pinned]";
+        configData.pin = true;
+        configData.cpus.push_back( 0 );
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "Benchmark 'pinned': 5 rounds of" ) );
+    }
+}
+
+TEST_CASE( "Benchmarks are compared with a baseline", "[benchmark]" ) {
+
+    using namespace Catch;
+    std::string const filename = "CatchSelfTest.baseline";
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][benchmark]" );
+    configData.benchmarkSamples = 10;
+    configData.benchmarkResamples = 100;
+    configData.benchmarkWarmupTime = 0;
+
+    SECTION( "failing those that regressed", "" ) {
+        writeFile( filename, "commit=0000000\nBenchmark probe\tsum\tsamples=1,1.1,1.2,1.3,1.4,1.5,1.6,1.7,1.8,1.9\n" );
+        configData.benchmarkCompareFilename = filename;
+        std::string output;
+        CHECK( runSession( configData, output ) == 1 );
+        CHECK_THAT( output, Contains( "Benchmark 'sum' regressed: median" ) );
+        CHECK_THAT( output, Contains( "against 1.45 ns at baseline" ) );
+        CHECK_THAT( output, Contains( "0000000" ) );
+
+        configData.workers = 1;
+        CHECK( runSession( configData, output ) == 1 );
+    }
+    SECTION( "passing those that did not", "" ) {
+        writeFile( filename, "commit=0000000\nBenchmark probe\tsum\tsamples=1e9,1e9,1e9\n" );
+        configData.benchmarkCompareFilename = filename;
+        configData.showSuccessfulTests = true;
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "Benchmark 'sum' did not regress: median" ) );
+    }
+    SECTION( "saved along with the commit", "" ) {
+        configData.benchmarkBaselineFilename = filename;
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+
+        BenchmarkBaseline saved;
+        REQUIRE( saved.load( filename ) );
+        CHECK( saved.commit() == GIT_LAST_COMMIT_ABBRHASH );
+        REQUIRE( saved.find( "Benchmark probe", "sum" ) );
+        CHECK( saved.find( "Benchmark probe", "sum" )->size() == 10 );
+    }
+
+    std::remove( filename.c_str() );
+}
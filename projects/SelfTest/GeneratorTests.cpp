@@ -11,6 +11,8 @@
 #define CATCH_CONFIG_PREFIX_ALL
 #include "catch.hpp"
 
+#include <climits>
+
 inline int multiply( int a, int b )
 {
     return a*b;
@@ -27,6 +29,23 @@ CATCH_TEST_CASE( "Generators over two ranges", "[generators]" )
     CATCH_REQUIRE( multiply( j, 2 ) == j*2 );
 }
 
+CATCH_TEST_CASE( "Generators can be gone through at once", "[generators]" )
+{
+    using namespace Catch::Generators;
+
+    Catch::CompositeGenerator<int> sizes = between( 1, 3 ).then( geometric( 8, 100, 3 ).then( 1000 ) );
+
+    CATCH_REQUIRE( sizes.size() == 7 );
+    CATCH_CHECK( sizes.getValue( 0 ) == 1 );
+    CATCH_CHECK( sizes.getValue( 2 ) == 3 );
+    CATCH_CHECK( sizes.getValue( 3 ) == 8 );
+    CATCH_CHECK( sizes.getValue( 5 ) == 72 );
+    CATCH_CHECK( sizes.getValue( 6 ) == 1000 );
+    CATCH_CHECK( geometric( 0, 10 ).size() == 1 );
+    CATCH_CHECK( geometric( 1, INT_MAX ).size() == 31 );
+    CATCH_CHECK( geometric( 1, INT_MAX ).getValue( 30 ) == 1 << 30 );
+}
+
 struct IntPair { int first, second; };
 
 CATCH_TEST_CASE( "Generator over a range of pairs", "[generators]" )
@@ -0,0 +1,46 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch.hpp"
+#include "internal/catch_test_impact.hpp"
+
+#include <cstdio>
+
+TEST_CASE( "Impact map selects the tests a change can affect", "[impact]" ) {
+
+    using namespace Catch;
+    std::string const mapFilename = "CatchSelfTest.impact";
+    {
+        TestImpactMap impactMap;
+        impactMap.recordFootprint( "parser", { "/src/project/include/parser.h", "/src/project/src/parser.cpp" } );
+        impactMap.recordFootprint( "printer", { "/src/project/src/printer.cpp" } );
+        impactMap.recordFootprint( "both", { "/src/project/src/printer.cpp", "/src/project/include/parser.h" } );
+        impactMap.recordFootprint( "replaced", { "/src/project/src/gone.cpp" } );
+        impactMap.recordFootprint( "replaced", { "/src/project/src/printer.cpp" } );
+        REQUIRE( impactMap.save( mapFilename ) );
+    }
+    TestImpactMap impactMap;
+    impactMap.load( mapFilename );
+    std::remove( mapFilename.c_str() );
+    CHECK( impactMap.footprint( "both" ) == std::vector<std::string>( { "/src/project/src/printer.cpp", "/src/project/include/parser.h" } ) );
+    CHECK( impactMap.selects( "parser" ) );
+
+    SECTION( "Changed files are matched by their trailing path", "" ) {
+        impactMap.selectImpactedBy( { "include/parser.h" } );
+        CHECK( impactMap.selects( "parser" ) );
+        CHECK( impactMap.selects( "both" ) );
+        CHECK_FALSE( impactMap.selects( "printer" ) );
+        CHECK_FALSE( impactMap.selects( "replaced" ) );
+    }
+    SECTION( "Only whole path components match", "" ) {
+        impactMap.selectImpactedBy( { "rinter.cpp", "./src/gone.cpp" } );
+        CHECK_FALSE( impactMap.selects( "printer" ) );
+        CHECK_FALSE( impactMap.selects( "replaced" ) );
+    }
+    SECTION( "Tests not recorded yet are selected", "" ) {
+        impactMap.selectImpactedBy( std::vector<std::string>() );
+        CHECK_FALSE( impactMap.selects( "parser" ) );
+        CHECK( impactMap.selects( "new" ) );
+    }
+}
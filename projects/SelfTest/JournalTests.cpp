@@ -0,0 +1,126 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch.hpp"
+#include "internal/catch_run_journal.hpp"
+#include "internal/catch_config.hpp"
+#include "SelfTestHelpers.h"
+
+#include <fstream>
+
+TEST_CASE( "Run journal can be resumed", "[journal]" ) {
+
+    using namespace Catch;
+    TemporaryDirectory directory;
+    std::string const filename = directory.file( "journal" );
+    Totals totals;
+    totals.testCases.passed = 1;
+    totals.assertions.passed = 3;
+    totals.assertions.failed = 2;
+    {
+        RunJournal journal;
+        REQUIRE( journal.open( filename, false ) );
+        journal.record( "first\ttest", totals );
+        journal.record( "second", totals );
+    }
+    {
+        // As if the process died while writing a third record
+        std::ofstream f( filename.c_str(), std::ios::app );
+        f << "third\ttestCases=1,0";
+    }
+
+    RunJournal journal;
+    REQUIRE( journal.open( filename, true ) );
+    journal.record( "fourth", totals );
+    journal.close();
+
+    RunJournal resumed;
+    REQUIRE( resumed.open( filename, true ) );
+    Option<Totals> first = resumed.completed( "first\ttest" );
+    REQUIRE( first.some() );
+    CHECK( first->testCases.passed == 1 );
+    CHECK( first->assertions.passed == 3 );
+    CHECK( first->assertions.failed == 2 );
+    CHECK( resumed.completed( "second" ).some() );
+    CHECK( resumed.completed( "third" ).none() );
+    CHECK( resumed.completed( "fourth" ).some() );
+    resumed.close();
+}
+
+TEST_CASE( "Run journal tells crashed test cases and finished runs apart", "[journal]" ) {
+
+    using namespace Catch;
+    TemporaryDirectory directory;
+    std::string const filename = directory.file( "journal" );
+    Totals totals;
+    totals.testCases.passed = 1;
+    {
+        RunJournal journal;
+        REQUIRE( journal.open( filename, false ) );
+        journal.attempt( "completed" );
+        journal.record( "completed", totals );
+        journal.attempt( "crashed" );
+    }
+    {
+        RunJournal resumed;
+        REQUIRE( resumed.open( filename, true ) );
+        CHECK( resumed.completed( "completed" ).some() );
+        CHECK( !resumed.crashed( "completed" ) );
+        CHECK( resumed.completed( "crashed" ).none() );
+        CHECK( resumed.crashed( "crashed" ) );
+        resumed.record( "crashed", totals );
+        resumed.endOfRun();
+    }
+
+    RunJournal restarted;
+    REQUIRE( restarted.open( filename, true ) );
+    CHECK( restarted.completed( "completed" ).none() );
+    CHECK( restarted.completed( "crashed" ).none() );
+    CHECK( !restarted.crashed( "crashed" ) );
+    restarted.close();
+}
+
+namespace {
+    std::vector<std::string> journalProbeRuns;
+}
+
+TEST_CASE( "Journal probe: completed", "[.][journal-probe]" ) {
+    journalProbeRuns.push_back( "completed" );
+}
+TEST_CASE( "Journal probe: crashed", "[.][journal-probe]" ) {
+    journalProbeRuns.push_back( "crashed" );
+}
+TEST_CASE( "Journal probe: not run", "[.][journal-probe]" ) {
+    journalProbeRuns.push_back( "not run" );
+}
+
+TEST_CASE( "Resuming skips past the test case that crashed the run", "[journal]" ) {
+
+    using namespace Catch;
+    TemporaryDirectory directory;
+    std::string const filename = directory.file( "journal" );
+    // As left by a run that died in the second test case
+    writeFile( filename,
+               "# Catch run journal\n"
+               "Journal probe: completed\tattempted\n"
+               "Journal probe: completed\ttestCases=1,0,0\tassertions=0,0,0\n"
+               "Journal probe: crashed\tattempted\n" );
+
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][journal-probe]" );
+    configData.journalFilename = filename;
+    configData.resumeJournal = true;
+
+    journalProbeRuns.clear();
+    std::string output;
+    CHECK( runSession( configData, output ) == 1 );
+    REQUIRE( journalProbeRuns.size() == 1 );
+    CHECK( journalProbeRuns[0] == "not run" );
+    CHECK_THAT( output, Contains( "crashed the run being resumed" ) );
+
+    // That run got to the end, so the next one starts afresh
+    journalProbeRuns.clear();
+    CHECK( runSession( configData, output ) == 0 );
+    CHECK( journalProbeRuns.size() == 3 );
+}
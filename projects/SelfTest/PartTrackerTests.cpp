@@ -326,3 +326,31 @@ TEST_CASE( "Tracker", "" ) {
         //   two sections within a generator
     }
 }
+
+TEST_CASE( "Tracker with a selected path", "" ) {
+
+    TrackerContext ctx;
+    ctx.startRun();
+    ctx.startCycle();
+
+    SectionTracker& testCase = SectionTracker::acquire( ctx, "Testcase" );
+    testCase.selectPath( std::vector<std::string>( 1, "S2" ) );
+
+    ITracker& s1 = SectionTracker::acquire( ctx, "S1@file.cpp:10" );
+    REQUIRE( s1.isOpen() == false );
+    REQUIRE( s1.isComplete() );
+
+    ITracker& s2 = SectionTracker::acquire( ctx, "S2@file.cpp:20" );
+    REQUIRE( s2.isOpen() );
+
+    ITracker& s2a = SectionTracker::acquire( ctx, "S2a@file.cpp:21" );
+    REQUIRE( s2a.isOpen() );
+    s2a.close();
+    s2.close();
+
+    ITracker& s3 = SectionTracker::acquire( ctx, "S3@file.cpp:30" );
+    REQUIRE( s3.isOpen() == false );
+
+    testCase.close();
+    REQUIRE( testCase.isSuccessfullyCompleted() );
+}
@@ -0,0 +1,156 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch.hpp"
+#include "internal/catch_repeat_statistics.hpp"
+#include "internal/catch_config.hpp"
+#include "SelfTestHelpers.h"
+
+#include <set>
+#include <algorithm>
+#include <sstream>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+namespace {
+    std::vector<int> repeatProbeDraws;
+    bool repeatProbeFailed = false;
+}
+
+TEST_CASE( "Repeat probe", "[.][repeat]" ) {
+    int draw = std::rand();
+    repeatProbeDraws.push_back( draw );
+    repeatProbeFailed = draw % 3 == 0;
+    CHECK( draw % 3 != 0 );
+}
+
+TEST_CASE( "Tests can be repeated with fresh seeds", "[repeat]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.testsOrTags.push_back( "Repeat probe" );
+    configData.repeat = 30;
+    repeatProbeDraws.clear();
+
+    SECTION( "--repeat", "" ) {
+        std::string output;
+        int failures = runSession( configData, output );
+        REQUIRE( repeatProbeDraws.size() == 30 );
+        CHECK( std::set<int>( repeatProbeDraws.begin(), repeatProbeDraws.end() ).size() > 1 );
+        CHECK_THAT( output, Contains( "Repeated test cases:" ) );
+        std::size_t passes = static_cast<std::size_t>( std::count_if( repeatProbeDraws.begin(), repeatProbeDraws.end(), []( int draw ) { return draw % 3 != 0; } ) );
+        std::ostringstream oss;
+        oss << "passed " << passes << " of 30";
+        CHECK_THAT( output, Contains( oss.str() ) );
+        CHECK( failures == static_cast<int>( 30 - passes ) );
+        if( failures > 0 )
+            CHECK_THAT( output, Contains( "failed with seeds:" ) );
+
+        // A failing seed reproduces the failure
+        std::vector<int> draws = repeatProbeDraws;
+        std::size_t firstFailure = static_cast<std::size_t>( std::find_if( draws.begin(), draws.end(), []( int draw ) { return draw % 3 == 0; } ) - draws.begin() );
+        if( firstFailure < draws.size() ) {
+            ConfigData rerunData;
+            rerunData.testsOrTags.push_back( "Repeat probe" );
+            rerunData.rngSeed = RepeatStatistics::repetitionSeed( configData.rngSeed, firstFailure );
+            repeatProbeDraws.clear();
+            CHECK( runSession( rerunData, output ) == 1 );
+            CHECK( repeatProbeDraws == std::vector<int>( 1, draws[firstFailure] ) );
+        }
+    }
+    SECTION( "--until-fail", "" ) {
+        configData.untilFail = true;
+        std::string output;
+        runSession( configData, output );
+        REQUIRE( !repeatProbeDraws.empty() );
+        CHECK( repeatProbeDraws.size() <= 30 );
+        CHECK( ( repeatProbeFailed || repeatProbeDraws.size() == 30 ) );
+    }
+}
+
+// Each attempt runs in a process of its own, forked from the runner, so
+// what one attempt leaves behind for the next goes through a file, in a
+// directory the test case running the probes sets up
+namespace {
+    std::string retryProbeRunsFile, retryProbeDrawFile, retryProbeCrashedFile;
+
+    int readRetryProbeFile( std::string const& filename, int defaultValue ) {
+        int value = defaultValue;
+        std::ifstream f( filename.c_str() );
+        f >> value;
+        return value;
+    }
+    void writeRetryProbeFile( std::string const& filename, int value ) {
+        std::ofstream f( filename.c_str() );
+        f << value;
+    }
+}
+
+TEST_CASE( "Retry probe: fails the first time", "[.][retry]" ) {
+    int runs = readRetryProbeFile( retryProbeRunsFile, 0 ) + 1;
+    writeRetryProbeFile( retryProbeRunsFile, runs );
+    CHECK( runs > 1 );
+}
+TEST_CASE( "Retry probe: fails with the first seed", "[.][retry]" ) {
+    int firstDraw = readRetryProbeFile( retryProbeDrawFile, -1 );
+    int draw = std::rand();
+    if( firstDraw < 0 ) {
+        firstDraw = draw;
+        writeRetryProbeFile( retryProbeDrawFile, draw );
+    }
+    CHECK( draw != firstDraw );
+}
+TEST_CASE( "Retry probe: always fails", "[.][retry]" ) {
+    CHECK( false );
+}
+
+TEST_CASE( "Failed tests can be retried in fresh processes", "[retry]" ) {
+
+    using namespace Catch;
+    TemporaryDirectory directory;
+    retryProbeRunsFile = directory.file( "runs" );
+    retryProbeDrawFile = directory.file( "draw" );
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][retry]" );
+    configData.retryFailed = 3;
+    configData.reporterNames.push_back( "xml" );
+
+    std::string output;
+    CHECK( runSession( configData, output ) == 1 );
+    CHECK_THAT( output, Contains( "retryOutcome=\"flaky\" retries=\"1\"" ) );
+    CHECK_THAT( output, Contains( "retryOutcome=\"passed on retry\" retries=\"2\"" ) );
+    CHECK_THAT( output, Contains( "retryOutcome=\"deterministic failure\" retries=\"3\"" ) );
+}
+
+TEST_CASE( "Retry probe: crashes the first time", "[.][retry-crash]" ) {
+    if( readRetryProbeFile( retryProbeCrashedFile, 0 ) == 0 ) {
+        writeRetryProbeFile( retryProbeCrashedFile, 1 );
+        std::_Exit( 3 );
+    }
+    CHECK( true );
+}
+
+TEST_CASE( "A test that brings its process down is retried, and the run goes on", "[retry][journal]" ) {
+
+    using namespace Catch;
+    TemporaryDirectory directory;
+    retryProbeCrashedFile = directory.file( "crashed" );
+    std::string const journalFilename = directory.file( "journal" );
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][retry-crash]" );
+    configData.retryFailed = 1;
+    configData.journalFilename = journalFilename;
+    configData.reporterNames.push_back( "xml" );
+
+    std::string output;
+    CHECK( runSession( configData, output ) == 0 );
+    CHECK_THAT( output, Contains( "retryOutcome=\"flaky\" retries=\"1\"" ) );
+
+    // Recorded as passed, and the run as finished
+    std::ifstream f( journalFilename.c_str() );
+    std::string journal( ( std::istreambuf_iterator<char>( f ) ), std::istreambuf_iterator<char>() );
+    CHECK_THAT( journal, Contains( "Retry probe: crashes the first time\ttestCases=1,0,0" ) );
+    CHECK_THAT( journal, Contains( "# End of run" ) );
+}
@@ -0,0 +1,65 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch.hpp"
+#include "internal/catch_test_result_cache.hpp"
+#include "SelfTestHelpers.h"
+
+#include <cstdio>
+
+TEST_CASE( "Test result cache skips unchanged passes", "[cache]" ) {
+
+    using namespace Catch;
+    std::string const indexFilename = "CatchSelfTest.cache";
+    writeFile( "CatchSelfTest.source", "source" );
+    writeFile( "CatchSelfTest.data", "data" );
+    TestCase withData = makeTestCase( CATCH_NULL, "", "with data", "[data:CatchSelfTest.data]", SourceLineInfo( "CatchSelfTest.source", 1 ) );
+    TestCase withoutData = makeTestCase( CATCH_NULL, "", "without data", "", SourceLineInfo( "CatchSelfTest.source", 2 ) );
+    TestCase failing = makeTestCase( CATCH_NULL, "", "failing", "", SourceLineInfo( "CatchSelfTest.source", 3 ) );
+
+    Totals passed;
+    passed.testCases.passed = 1;
+    passed.assertions.passed = 4;
+    Totals failed;
+    failed.testCases.failed = 1;
+    failed.assertions.failed = 1;
+    {
+        TestResultCache cache;
+        cache.open( indexFilename, "" );
+        CHECK( !cache.cachedPass( withData ) );
+        cache.recordResult( withData, passed );
+        cache.recordResult( withoutData, passed );
+        cache.recordResult( failing, failed );
+        REQUIRE( cache.save( indexFilename ) );
+    }
+
+    SECTION( "Passes are cached", "" ) {
+        TestResultCache cache;
+        cache.open( indexFilename, "" );
+        Option<Totals> cached = cache.cachedPass( withData );
+        REQUIRE( cached.some() );
+        CHECK( cached->testCases.passed == 1 );
+        CHECK( cached->assertions.passed == 4 );
+        CHECK( cache.cachedPass( withoutData ).some() );
+        CHECK( cache.cachedPass( failing ).none() );
+    }
+    SECTION( "A changed data file invalidates the tests declaring it", "" ) {
+        writeFile( "CatchSelfTest.data", "changed data" );
+        TestResultCache cache;
+        cache.open( indexFilename, "" );
+        CHECK( cache.cachedPass( withData ).none() );
+        CHECK( cache.cachedPass( withoutData ).some() );
+    }
+    SECTION( "A changed source file invalidates all its tests", "" ) {
+        writeFile( "CatchSelfTest.source", "changed source" );
+        TestResultCache cache;
+        cache.open( indexFilename, "" );
+        CHECK( cache.cachedPass( withData ).none() );
+        CHECK( cache.cachedPass( withoutData ).none() );
+    }
+
+    std::remove( indexFilename.c_str() );
+    std::remove( "CatchSelfTest.source" );
+    std::remove( "CatchSelfTest.data" );
+}
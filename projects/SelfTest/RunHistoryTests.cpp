@@ -0,0 +1,192 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch.hpp"
+#include "internal/catch_run_history.hpp"
+#include "internal/catch_config.hpp"
+#include "SelfTestHelpers.h"
+
+#include <sstream>
+#include <cstdio>
+
+TEST_CASE( "Run history estimates test durations", "[history]" ) {
+
+    using namespace Catch;
+    RunHistory history;
+    for( int i = 1; i <= RunHistory::DurationsKept + 2; ++i )
+        history.recordDuration( "slow", i );
+    history.recordDuration( "fast", 1.0 );
+
+    SECTION( "Only the most recent durations are kept", "" ) {
+        REQUIRE( history.expectedDuration( "slow" ).some() );
+        CHECK( *history.expectedDuration( "slow" ) == Approx( 7.5 ) );
+        CHECK( !history.expectedDuration( "unknown" ) );
+    }
+    SECTION( "A test never run before is assumed to be average", "" ) {
+        std::vector<std::string> names;
+        names.push_back( "slow" );
+        names.push_back( "fast" );
+        names.push_back( "unknown" );
+        std::vector<double> estimates = history.estimateDurations( names );
+        CHECK( estimates[0] == Approx( 7.5 ) );
+        CHECK( estimates[1] == Approx( 1.0 ) );
+        CHECK( estimates[2] == Approx( 4.25 ) );
+    }
+    SECTION( "Failures are read back with their section", "" ) {
+        std::vector<std::string> path;
+        path.push_back( "a/b" );
+        path.push_back( "tab\there" );
+        history.recordResult( "slow", true, path );
+        history.recordResult( "fast", true, path );
+        history.recordResult( "fast", false, path );
+        CHECK( !history.failedLastRun( "slow" ) );
+
+        std::stringstream file;
+        history.write( file );
+        RunHistory readBack;
+        readBack.read( file );
+        CHECK( readBack.failedLastRun( "slow" ) );
+        CHECK( !readBack.failedLastRun( "fast" ) );
+        CHECK( !readBack.failedLastRun( "unknown" ) );
+        CHECK( readBack.failedSectionPath( "slow" ) == path );
+        CHECK( readBack.failedSectionPath( "fast" ).empty() );
+    }
+    SECTION( "Recent failures weigh more", "" ) {
+        std::vector<std::string> path;
+        for( int i = 0; i < RunHistory::ResultsKept + 5; ++i )
+            history.recordResult( "slow", i % 2 == 0, path );
+        history.recordResult( "fast", true, path );
+        history.recordResult( "fast", false, path );
+        history.recordResult( "fast", false, path );
+
+        std::stringstream file;
+        history.write( file );
+        RunHistory readBack;
+        readBack.read( file );
+        CHECK( readBack.recordedFailures( "slow" ) == RunHistory::ResultsKept / 2 );
+        CHECK( readBack.recordedFailures( "fast" ) == 1 );
+        CHECK( readBack.recordedFailures( "unknown" ) == 0 );
+        REQUIRE( readBack.failureWeight( "fast" ).some() );
+        CHECK( *readBack.failureWeight( "fast" ) == Approx( 0.25 ) );
+        CHECK( *readBack.failureWeight( "slow" ) > 1 );
+        CHECK( !readBack.failureWeight( "unknown" ) );
+    }
+    SECTION( "A test never measured is assumed to take average memory", "" ) {
+        history.recordPeakMemory( "slow", 3000 );
+        history.recordPeakMemory( "fast", 1000 );
+
+        std::stringstream file;
+        history.write( file );
+        RunHistory readBack;
+        readBack.read( file );
+        std::vector<std::string> names;
+        names.push_back( "slow" );
+        names.push_back( "fast" );
+        names.push_back( "unknown" );
+        std::vector<std::size_t> estimates = readBack.estimatePeakMemory( names );
+        CHECK( estimates[0] == 3000 );
+        CHECK( estimates[1] == 1000 );
+        CHECK( estimates[2] == 2000 );
+    }
+}
+
+namespace {
+    std::vector<std::string> budgetProbeRuns;
+}
+
+TEST_CASE( "Budget probe: slow", "[.][budget]" ) {
+    budgetProbeRuns.push_back( "slow" );
+}
+TEST_CASE( "Budget probe: quick", "[.][budget]" ) {
+    budgetProbeRuns.push_back( "quick" );
+}
+TEST_CASE( "Budget probe: failed last run", "[.][budget]" ) {
+    budgetProbeRuns.push_back( "failed last run" );
+}
+
+TEST_CASE( "Tests are chosen to fit a time budget", "[budget]" ) {
+
+    using namespace Catch;
+    std::string const filename = "CatchSelfTest.history";
+    writeFile( filename,
+               "Budget probe: slow\tdurations=100\tresults=pf\n"
+               "Budget probe: quick\tdurations=1\tresults=pp\n"
+               "Budget probe: failed last run\tdurations=4\tfailed=\tresults=pf\n" );
+
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][budget]" );
+    configData.historyFilename = filename;
+    configData.timeBudget = 10;
+    budgetProbeRuns.clear();
+
+    std::string output;
+    CHECK( runSession( configData, output ) == 0 );
+    REQUIRE( budgetProbeRuns.size() == 2 );
+    CHECK( budgetProbeRuns[0] == "failed last run" );
+    CHECK( budgetProbeRuns[1] == "quick" );
+    CHECK_THAT( output, Contains( "ran 2 of 3 test cases, deferred:\n  Budget probe: slow" ) );
+    CHECK_THAT( output, Contains( "Covered 1 of the 2 failures in the run history (50.00%)" ) );
+
+    std::remove( filename.c_str() );
+}
+
+namespace {
+    std::vector<std::string> shardProbeRuns;
+}
+
+TEST_CASE( "Shard probe: slow", "[.][shard]" ) {
+    shardProbeRuns.push_back( "slow" );
+}
+TEST_CASE( "Shard probe: quick 1", "[.][shard]" ) {
+    shardProbeRuns.push_back( "quick 1" );
+}
+TEST_CASE( "Shard probe: quick 2", "[.][shard]" ) {
+    shardProbeRuns.push_back( "quick 2" );
+}
+
+TEST_CASE( "Shards are only balanced by the history when asked to", "[history][shard]" ) {
+
+    using namespace Catch;
+    std::string const filename = "CatchSelfTest.shards.history";
+    writeFile( filename,
+               "Shard probe: slow\tdurations=100\n"
+               "Shard probe: quick 1\tdurations=1\n"
+               "Shard probe: quick 2\tdurations=1\n" );
+
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][shard]" );
+    configData.shardCount = 2;
+    std::string output;
+
+    SECTION( "by the hash of the names, whatever the history", "" ) {
+        for( int shard = 0; shard < 2; ++shard ) {
+            configData.shardIndex = shard;
+            configData.historyFilename.clear();
+            shardProbeRuns.clear();
+            CHECK( runSession( configData, output ) == 0 );
+            std::vector<std::string> withoutHistory = shardProbeRuns;
+
+            configData.historyFilename = filename;
+            shardProbeRuns.clear();
+            CHECK( runSession( configData, output ) == 0 );
+            CHECK( shardProbeRuns == withoutHistory );
+        }
+    }
+    SECTION( "by the durations, with --shard-balance", "" ) {
+        configData.historyFilename = filename;
+        configData.balanceShards = true;
+
+        shardProbeRuns.clear();
+        CHECK( runSession( configData, output ) == 0 );
+        REQUIRE( shardProbeRuns.size() == 1 );
+        CHECK( shardProbeRuns[0] == "slow" );
+
+        configData.shardIndex = 1;
+        shardProbeRuns.clear();
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK( shardProbeRuns.size() == 2 );
+    }
+
+    std::remove( filename.c_str() );
+}
@@ -0,0 +1,103 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch.hpp"
+#include "internal/catch_config.hpp"
+#include "SelfTestHelpers.h"
+
+namespace {
+    std::vector<std::string> sectionProbeEntered;
+}
+
+TEST_CASE( "Section path probe", "[.][sections]" ) {
+    sectionProbeEntered.push_back( "prefix" );
+    SECTION( "a", "" ) {
+        sectionProbeEntered.push_back( "a" );
+        SECTION( "a1", "" ) { sectionProbeEntered.push_back( "a1" ); }
+        SECTION( "a2", "" ) { sectionProbeEntered.push_back( "a2" ); }
+    }
+    SECTION( "b", "" ) {
+        sectionProbeEntered.push_back( "b" );
+        SECTION( "b1", "" ) { sectionProbeEntered.push_back( "b1" ); }
+        SECTION( "b2", "" ) { sectionProbeEntered.push_back( "b2" ); }
+    }
+}
+
+TEST_CASE( "Only the sections along the selected path are run", "[sections]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.testsOrTags.push_back( "Section path probe" );
+    sectionProbeEntered.clear();
+    std::string output;
+
+    SECTION( "-c b -c b2", "" ) {
+        configData.sectionsToRun.push_back( "b" );
+        configData.sectionsToRun.push_back( "b2" );
+        configData.reporterNames.push_back( "xml" );
+        CHECK( runSession( configData, output ) == 0 );
+        std::string entered[] = { "prefix", "b", "b2" };
+        CHECK( sectionProbeEntered == std::vector<std::string>( entered, entered+3 ) );
+        CHECK_THAT( output, Contains( "<SelectedSection name=\"b\"/>" ) );
+        CHECK_THAT( output, Contains( "<SelectedSection name=\"b2\"/>" ) );
+    }
+    SECTION( "-c a", "" ) {
+        configData.sectionsToRun.push_back( "a" );
+        CHECK( runSession( configData, output ) == 0 );
+        std::string entered[] = { "prefix", "a", "a1", "prefix", "a", "a2" };
+        CHECK( sectionProbeEntered == std::vector<std::string>( entered, entered+6 ) );
+        CHECK_THAT( output, Contains( "path were run: a" ) );
+    }
+    SECTION( "-c missing", "" ) {
+        configData.sectionsToRun.push_back( "missing" );
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK( sectionProbeEntered == std::vector<std::string>( 1, "prefix" ) );
+    }
+}
+
+namespace {
+    int checkpointProbePrefixRuns = 0;
+}
+
+TEST_CASE( "Checkpoint probe", "[.][checkpoint]" ) {
+    ++checkpointProbePrefixRuns; // Only counted in the process that runs the prefix
+    std::vector<int> setUp( 3, 42 );
+    SECTION( "a", "" ) {
+        setUp.push_back( 1 );
+        SECTION( "a1", "" ) { CHECK( setUp.size() == 4 ); }
+        SECTION( "a2", "" ) { CHECK( setUp.size() == 4 ); }
+    }
+    SECTION( "b", "" ) {
+        CHECK( setUp.size() == 4 );
+    }
+    SECTION( "c", "" ) {
+        CHECK( setUp.size() == 3 );
+    }
+    CHECK( setUp[0] == 42 );
+}
+
+TEST_CASE( "Passes through a checkpointed test case are forked from its first section", "[checkpointing]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.testsOrTags.push_back( "Checkpoint probe" );
+    configData.reporterNames.push_back( "xml" );
+    checkpointProbePrefixRuns = 0;
+
+    SECTION( "one pass at a time", "" ) {
+    }
+    SECTION( "--checkpoint-workers 3", "" ) {
+        configData.checkpointWorkers = 3;
+    }
+
+    std::string output;
+    CHECK( runSession( configData, output ) == 1 );
+    CHECK( checkpointProbePrefixRuns == 1 );
+    CHECK_THAT( output, Contains( "<OverallResults successes=\"7\" failures=\"1\"" ) );
+    std::size_t a1 = output.find( "name=\"a1\"" ), a2 = output.find( "name=\"a2\"" ), b = output.find( "name=\"b\"" ), c = output.find( "name=\"c\"" );
+    CHECK( a1 < a2 );
+    CHECK( a2 < b );
+    CHECK( b < c );
+    CHECK( c != std::string::npos );
+}
@@ -0,0 +1,44 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef TWOBLUECUBES_CATCH_SELF_TEST_HELPERS_H_INCLUDED
+#define TWOBLUECUBES_CATCH_SELF_TEST_HELPERS_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+namespace Catch {
+    struct ConfigData;
+}
+
+// Runs a session of its own, from within the test case being run, and
+// returns what the session returns. Whatever it writes to Catch::cout() is
+// appended to output. Defined in TestMain.cpp, along with the implementation
+int runSession( Catch::ConfigData const& configData, std::string& output );
+
+// Runs a session of its own from a command line, as main() would
+int runSession( int argc, char const* const* argv );
+
+void writeFile( std::string const& filename, std::string const& content );
+
+// A directory of its own under the system's temporary directory, for the
+// files a test case shares with the sessions and processes it starts. It
+// goes, along with the files named through it, however the test case ends
+class TemporaryDirectory {
+public:
+    TemporaryDirectory();
+    ~TemporaryDirectory();
+
+    // The path of a file in the directory, removed along with it
+    std::string file( std::string const& name );
+
+private:
+    TemporaryDirectory( TemporaryDirectory const& );
+    void operator=( TemporaryDirectory const& );
+
+    std::string m_path;
+    std::vector<std::string> m_files;
+};
+
+#endif // TWOBLUECUBES_CATCH_SELF_TEST_HELPERS_H_INCLUDED
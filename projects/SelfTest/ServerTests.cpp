@@ -0,0 +1,157 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch.hpp"
+#include "internal/catch_test_server.hpp"
+#include "SelfTestHelpers.h"
+
+#ifndef CATCH_PLATFORM_WINDOWS
+
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+
+namespace {
+    // Answers each request with its arguments on stdout, a line on stderr,
+    // and an exit code of 7
+    struct EchoingRequestRunner : Catch::ITestRequestRunner {
+        virtual int runRequest( std::vector<std::string> const& args ) CATCH_OVERRIDE {
+            for( std::vector<std::string>::const_iterator it = args.begin(), itEnd = args.end(); it != itEnd; ++it )
+                std::printf( "[%s]", it->c_str() );
+            std::printf( "\n" );
+            std::fprintf( stderr, "on stderr\n" );
+            return 7;
+        }
+    };
+
+    std::string readFile( std::string const& filename ) {
+        std::ifstream f( filename.c_str() );
+        return std::string( ( std::istreambuf_iterator<char>( f ) ), std::istreambuf_iterator<char>() );
+    }
+
+    // The processes the server has forked that have not been waited for, zombies included
+    std::string childrenOf( pid_t pid ) {
+        std::ostringstream oss;
+        oss << pid;
+        std::string const pidText = oss.str();
+        return readFile( "/proc/" + pidText + "/task/" + pidText + "/children" );
+    }
+
+    // Runs a session from a command line, as main() would, with what it
+    // writes to stdout and stderr - relayed from the server - going to files
+    int runSessionToFiles( int argc, char const* const* argv, std::string const& outFilename, std::string const& errFilename ) {
+        std::fflush( CATCH_NULL );
+        int savedOut = dup( 1 ), savedErr = dup( 2 );
+        int outFd = open( outFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+        int errFd = open( errFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+        dup2( outFd, 1 );
+        dup2( errFd, 2 );
+        int exitCode = runSession( argc, argv );
+        dup2( savedOut, 1 );
+        dup2( savedErr, 2 );
+        close( savedOut ); close( savedErr );
+        close( outFd ); close( errFd );
+        return exitCode;
+    }
+
+    void stopServer( pid_t server ) {
+        kill( server, SIGTERM );
+        int status = 0;
+        waitpid( server, &status, 0 );
+    }
+}
+
+TEST_CASE( "Tests are run on a test server, which relays their output", "[server]" ) {
+
+    using namespace Catch;
+    TemporaryDirectory directory;
+    std::string const socketPath = directory.file( "socket" );
+    // Listening before the fork, so the client cannot get there first
+    TestServer testServer( socketPath );
+    std::fflush( CATCH_NULL );
+    pid_t server = fork();
+    REQUIRE( server >= 0 );
+    if( server == 0 ) {
+        int devNull = open( "/dev/null", O_WRONLY );
+        dup2( devNull, 1 ); // Not the "Serving tests on" line
+        EchoingRequestRunner runner;
+        _exit( testServer.serve( runner ) );
+    }
+
+    std::string const outFilename = directory.file( "out" ), errFilename = directory.file( "err" );
+    char const* argv[] = { "SelfTest", "Some test", "--connect", socketPath.c_str(), "-s" };
+    CHECK( runSessionToFiles( sizeof(argv)/sizeof(argv[0]), argv, outFilename, errFilename ) == 7 );
+    CHECK( readFile( outFilename ) == "[Some test][-s]\n" );
+    CHECK( readFile( errFilename ) == "on stderr\n" );
+
+#ifdef __linux__
+    // The connection handler is gone once it has answered, not left as a zombie
+    std::string children = childrenOf( server );
+    for( int attempt = 0; attempt < 200 && !children.empty(); ++attempt ) {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        children = childrenOf( server );
+    }
+    CHECK( children.empty() );
+#endif
+
+    SECTION( "A second server does not take over the socket of one still serving", "" ) {
+        REQUIRE_THROWS_WITH( (void)TestServer( socketPath ), Contains( "already listening" ) );
+        CHECK( runSessionToFiles( sizeof(argv)/sizeof(argv[0]), argv, outFilename, errFilename ) == 7 );
+    }
+
+    stopServer( server );
+}
+
+TEST_CASE( "Server probe: passing", "[.][server-probe]" ) {
+    CHECK( 1 + 1 == 2 );
+}
+TEST_CASE( "Server probe: failing", "[.][server-probe]" ) {
+    CHECK( 1 + 1 == 3 );
+}
+
+TEST_CASE( "A session run with --serve runs the tests each request asks for", "[server]" ) {
+
+    using namespace Catch;
+    TemporaryDirectory directory;
+    std::string const socketPath = directory.file( "socket" );
+    std::fflush( CATCH_NULL );
+    pid_t server = fork();
+    REQUIRE( server >= 0 );
+    if( server == 0 ) {
+        int devNull = open( "/dev/null", O_WRONLY );
+        dup2( devNull, 1 );
+        char const* argv[] = { "SelfTest", "--serve", socketPath.c_str() };
+        _exit( runSession( sizeof(argv)/sizeof(argv[0]), argv ) );
+    }
+
+    // Until the server has got as far as listening
+    bool listening = false;
+    sockaddr_un address = makeSocketAddress( socketPath );
+    for( int attempt = 0; attempt < 500 && !listening; ++attempt ) {
+        int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+        listening = connect( fd, reinterpret_cast<sockaddr*>( &address ), sizeof( address ) ) == 0;
+        close( fd );
+        if( !listening )
+            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    }
+    REQUIRE( listening );
+
+    std::string const outFilename = directory.file( "out" ), errFilename = directory.file( "err" );
+    char const* argv[] = { "SelfTest", "[.][server-probe]", "--connect", socketPath.c_str() };
+    for( int request = 0; request < 2; ++request ) {
+        CHECK( runSessionToFiles( sizeof(argv)/sizeof(argv[0]), argv, outFilename, errFilename ) == 1 );
+        std::string output = readFile( outFilename );
+        CHECK_THAT( output, Contains( "Server probe: failing" ) );
+        CHECK_THAT( output, Contains( "1 + 1 == 3" ) );
+        CHECK_THAT( output, Contains( "test cases: 2 | 1 passed | 1 failed" ) );
+    }
+
+    stopServer( server );
+}
+
+#endif // not Windows
@@ -0,0 +1,58 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch.hpp"
+#include "internal/catch_config.hpp"
+#include "SelfTestHelpers.h"
+
+namespace {
+    int sessionProbeRuns = 0;
+}
+
+TEST_CASE( "Session probe", "[.][session]" ) {
+    ++sessionProbeRuns;
+    SECTION( "one", "" ) {
+        CHECK( sessionProbeRuns > 0 );
+    }
+    SECTION( "two", "" ) {
+        CHECK( sessionProbeRuns > 0 );
+    }
+}
+
+TEST_CASE( "A session can be run many times", "[session]" ) {
+
+    using namespace Catch;
+    Ptr<IConfig const> config = getCurrentContext().getConfig();
+    IResultCapture* resultCapture = getCurrentContext().getResultCapture();
+    IRunner* runner = getCurrentContext().getRunner();
+
+    ConfigData configData;
+    configData.testsOrTags.push_back( "Session probe" );
+
+    // The first runs may fill caches that are kept for the next ones
+    std::string output;
+    for( int i = 0; i < 10; ++i ) {
+        output.clear();
+        runSession( configData, output );
+    }
+    sessionProbeRuns = 0;
+
+    long sharedObjectsBefore = liveSharedObjects();
+    int failedRuns = 0;
+    for( int i = 0; i < 1000; ++i ) {
+        std::string runOutput;
+        if( runSession( configData, runOutput ) != 0 )
+            ++failedRuns;
+    }
+
+    CHECK( failedRuns == 0 );
+    CHECK( sessionProbeRuns == 2000 );
+    CHECK( liveSharedObjects() == sharedObjectsBefore ); // Configs, reporters and the like all released
+    CHECK_THAT( output, Matchers::Contains( "All tests passed (2 assertions in 1 test case)" ) );
+
+    // The session running this test has its context back
+    CHECK( getCurrentContext().getConfig().get() == config.get() );
+    CHECK( getCurrentContext().getResultCapture() == resultCapture );
+    CHECK( getCurrentContext().getRunner() == runner );
+}
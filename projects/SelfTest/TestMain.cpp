@@ -9,6 +9,19 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 #include "../include/reporters/catch_reporter_teamcity.hpp"
+#include "SelfTestHelpers.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdio>
+
+#ifdef CATCH_PLATFORM_WINDOWS
+#include <direct.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 // Some example tag aliases
 CATCH_REGISTER_TAG_ALIAS( "[@nhf]", "[failing]~[.]" )
@@ -154,6 +167,368 @@ TEST_CASE( "Process can be configured on command line", "[config][command-line]"
         }
     }
 
+    SECTION( "test timeout", "" ) {
+        SECTION( "--test-timeout must be greater than zero", "" ) {
+            const char* argv[] = { "test", "--test-timeout", "0" };
+            REQUIRE_THAT( parseIntoConfigAndReturnError( argv, config ), Contains( "greater than zero" ) );
+        }
+    }
+
+    SECTION( "workers", "" ) {
+        SECTION( "--workers 4", "" ) {
+            const char* argv[] = { "test", "--workers", "4" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.workers == 4 );
+        }
+        SECTION( "--workers must be greater than zero", "" ) {
+            const char* argv[] = { "test", "--workers", "0" };
+            REQUIRE_THAT( parseIntoConfigAndReturnError( argv, config ), Contains( "greater than zero" ) );
+        }
+    }
+
+    SECTION( "threads", "" ) {
+        SECTION( "--threads 4", "" ) {
+            const char* argv[] = { "test", "--threads", "4" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.threads == 4 );
+        }
+        SECTION( "--threads must be greater than zero", "" ) {
+            const char* argv[] = { "test", "--threads", "0" };
+            REQUIRE_THAT( parseIntoConfigAndReturnError( argv, config ), Contains( "greater than zero" ) );
+        }
+        SECTION( "--threads cannot be used with --workers", "" ) {
+            const char* argv[] = { "test", "--threads", "4", "--workers", "2" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE_THROWS_WITH( (void)Catch::Config( config ), Contains( "--workers" ) );
+        }
+    }
+
+    SECTION( "benchmark", "" ) {
+        SECTION( "--benchmark-samples 20 --benchmark-resamples 500", "" ) {
+            const char* argv[] = { "test", "--benchmark-samples", "20", "--benchmark-resamples", "500" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.benchmarkSamples == 20 );
+            REQUIRE( config.benchmarkResamples == 500 );
+        }
+        SECTION( "--benchmark-confidence-interval 0.99 --benchmark-warmup-time 0", "" ) {
+            const char* argv[] = { "test", "--benchmark-confidence-interval", "0.99", "--benchmark-warmup-time", "0" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.benchmarkConfidenceInterval == Approx( 0.99 ) );
+            REQUIRE( config.benchmarkWarmupTime == 0 );
+        }
+        SECTION( "--benchmark-samples must be greater than zero", "" ) {
+            const char* argv[] = { "test", "--benchmark-samples", "0" };
+            REQUIRE_THAT( parseIntoConfigAndReturnError( argv, config ), Contains( "greater than zero" ) );
+        }
+        SECTION( "--benchmark-confidence-interval must be between 0 and 1", "" ) {
+            const char* argv[] = { "test", "--benchmark-confidence-interval", "95" };
+            REQUIRE_THAT( parseIntoConfigAndReturnError( argv, config ), Contains( "between 0 and 1" ) );
+        }
+        SECTION( "--benchmark-baseline new.txt --benchmark-compare old.txt --benchmark-threshold 5", "" ) {
+            const char* argv[] = { "test", "--benchmark-baseline", "new.txt", "--benchmark-compare", "old.txt", "--benchmark-threshold", "5" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.benchmarkBaselineFilename == "new.txt" );
+            REQUIRE( config.benchmarkCompareFilename == "old.txt" );
+            REQUIRE( config.benchmarkThreshold == Approx( 5 ) );
+        }
+        SECTION( "--benchmark-compare needs a baseline that can be read", "" ) {
+            const char* argv[] = { "test", "--benchmark-compare", "CatchSelfTest.missing" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE_THROWS_WITH( (void)Catch::Config( config ), Contains( "Unable to read the benchmark baseline" ) );
+        }
+    }
+
+    SECTION( "isolate", "" ) {
+        SECTION( "--isolate runs one test per process", "" ) {
+            const char* argv[] = { "test", "--isolate" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.isolateBatch == 1 );
+        }
+        SECTION( "--isolate-batch 10", "" ) {
+            const char* argv[] = { "test", "--isolate-batch", "10", "--isolate" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.isolateBatch == 10 );
+        }
+        SECTION( "--isolate-batch must be greater than zero", "" ) {
+            const char* argv[] = { "test", "--isolate-batch", "0" };
+            REQUIRE_THAT( parseIntoConfigAndReturnError( argv, config ), Contains( "greater than zero" ) );
+        }
+    }
+
+    SECTION( "test server", "" ) {
+        SECTION( "--serve /tmp/catch.sock", "" ) {
+            const char* argv[] = { "test", "--serve", "/tmp/catch.sock" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.serveSocket == "/tmp/catch.sock" );
+            REQUIRE( config.connectSocket.empty() );
+        }
+        SECTION( "--connect /tmp/catch.sock", "" ) {
+            const char* argv[] = { "test", "--connect", "/tmp/catch.sock", "[fast]" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.connectSocket == "/tmp/catch.sock" );
+            REQUIRE( config.serveSocket.empty() );
+            REQUIRE( config.testsOrTags.size() == 1 );
+        }
+    }
+
+    SECTION( "order", "" ) {
+        SECTION( "--order duration", "" ) {
+            const char* argv[] = { "test", "--order", "duration" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.runOrder == Catch::RunTests::InDurationOrder );
+        }
+        SECTION( "--order duration needs a history", "" ) {
+            const char* argv[] = { "test", "--order", "duration" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE_THROWS_WITH( (void)Catch::Config( config ), Contains( "--order duration" ) && Contains( "--history" ) );
+        }
+        SECTION( "--order failures-first", "" ) {
+            const char* argv[] = { "test", "--order", "failures-first" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.runOrder == Catch::RunTests::InFailuresFirstOrder );
+        }
+    }
+
+    SECTION( "rerun failed", "" ) {
+        SECTION( "--rerun-failed", "" ) {
+            const char* argv[] = { "test", "--rerun-failed", "--history", "history.txt" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.rerunFailed );
+        }
+        SECTION( "--rerun-failed needs a history", "" ) {
+            const char* argv[] = { "test", "--rerun-failed" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE_THROWS_WITH( (void)Catch::Config( config ), Contains( "--history" ) );
+        }
+    }
+
+    SECTION( "pinning", "" ) {
+        SECTION( "--pin", "" ) {
+            const char* argv[] = { "test", "--pin" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.pin );
+            REQUIRE( config.cpus.empty() );
+        }
+        SECTION( "--cpus 0-2,5", "" ) {
+            const char* argv[] = { "test", "--cpus", "0-2,5" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.pin );
+            int expected[] = { 0, 1, 2, 5 };
+            REQUIRE( config.cpus == std::vector<int>( expected, expected + 4 ) );
+        }
+        SECTION( "--cpus needs a list", "" ) {
+            const char* argv[] = { "test", "--cpus", "2-1" };
+            REQUIRE_THAT( parseIntoConfigAndReturnError( argv, config ), Contains( "Unrecognised CPU list" ) );
+        }
+    }
+
+    SECTION( "memory budget", "" ) {
+        SECTION( "--memory-budget 512", "" ) {
+            const char* argv[] = { "test", "--memory-budget", "512", "--workers", "4", "--history", "history.txt" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.memoryBudget == 512 );
+        }
+        SECTION( "--memory-budget must be greater than zero", "" ) {
+            const char* argv[] = { "test", "--memory-budget", "0" };
+            REQUIRE_THAT( parseIntoConfigAndReturnError( argv, config ), Contains( "greater than zero" ) );
+        }
+        SECTION( "--memory-budget needs workers", "" ) {
+            const char* argv[] = { "test", "--memory-budget", "512", "--history", "history.txt" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE_THROWS_WITH( (void)Catch::Config( config ), Contains( "--workers" ) );
+        }
+    }
+
+    SECTION( "time budget", "" ) {
+        SECTION( "--time-budget 2.5", "" ) {
+            const char* argv[] = { "test", "--time-budget", "2.5", "--history", "history.txt" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.timeBudget == Approx( 2.5 ) );
+        }
+        SECTION( "--time-budget must be greater than zero", "" ) {
+            const char* argv[] = { "test", "--time-budget", "0" };
+            REQUIRE_THAT( parseIntoConfigAndReturnError( argv, config ), Contains( "greater than zero" ) );
+        }
+        SECTION( "--time-budget needs a history", "" ) {
+            const char* argv[] = { "test", "--time-budget", "300" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE_THROWS_WITH( (void)Catch::Config( config ), Contains( "--history" ) );
+        }
+    }
+
+    SECTION( "journal", "" ) {
+        SECTION( "--journal run.journal", "" ) {
+            const char* argv[] = { "test", "--journal", "run.journal" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.journalFilename == "run.journal" );
+            REQUIRE( config.resumeJournal == false );
+        }
+        SECTION( "--resume run.journal", "" ) {
+            const char* argv[] = { "test", "--resume", "run.journal" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.journalFilename == "run.journal" );
+            REQUIRE( config.resumeJournal == true );
+        }
+    }
+
+    SECTION( "result cache", "" ) {
+        SECTION( "--cache results.cache", "" ) {
+            const char* argv[] = { "test", "--cache", "results.cache" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.cacheFilename == "results.cache" );
+            REQUIRE( config.noCache == false );
+        }
+        SECTION( "--no-cache", "" ) {
+            const char* argv[] = { "test", "--cache", "results.cache", "--no-cache" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.noCache == true );
+        }
+    }
+
+    SECTION( "repeat", "" ) {
+        SECTION( "--repeat 100 --until-fail", "" ) {
+            const char* argv[] = { "test", "--repeat", "100", "--until-fail" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.repeat == 100 );
+            REQUIRE( config.untilFail == true );
+        }
+        SECTION( "--repeat must be greater than zero", "" ) {
+            const char* argv[] = { "test", "--repeat", "0" };
+            REQUIRE_THAT( parseIntoConfigAndReturnError( argv, config ), Contains( "greater than zero" ) );
+        }
+        SECTION( "--until-fail needs a limit with workers", "" ) {
+            const char* argv[] = { "test", "--until-fail", "--workers", "4" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE_THROWS_WITH( (void)Catch::Config( config ), Contains( "--repeat" ) );
+        }
+    }
+
+    SECTION( "retry", "" ) {
+        SECTION( "--retry-failed 2", "" ) {
+            const char* argv[] = { "test", "--retry-failed", "2" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.retryFailed == 2 );
+        }
+        SECTION( "--retry-failed must be greater than zero", "" ) {
+            const char* argv[] = { "test", "--retry-failed", "0" };
+            REQUIRE_THAT( parseIntoConfigAndReturnError( argv, config ), Contains( "greater than zero" ) );
+        }
+    }
+
+    SECTION( "checkpoint", "" ) {
+        SECTION( "--checkpoint-workers 4", "" ) {
+            const char* argv[] = { "test", "--checkpoint-workers", "4" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.checkpointWorkers == 4 );
+        }
+        SECTION( "--checkpoint-workers must be greater than zero", "" ) {
+            const char* argv[] = { "test", "--checkpoint-workers", "0" };
+            REQUIRE_THAT( parseIntoConfigAndReturnError( argv, config ), Contains( "greater than zero" ) );
+        }
+    }
+
+    SECTION( "sections", "" ) {
+        SECTION( "-c outer -c inner", "" ) {
+            const char* argv[] = { "test", "-c", "outer", "--section", "inner" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.sectionsToRun.size() == 2 );
+            REQUIRE( config.sectionsToRun[0] == "outer" );
+            REQUIRE( config.sectionsToRun[1] == "inner" );
+        }
+    }
+
+    SECTION( "impact", "" ) {
+        SECTION( "--impact-map tests.impact --record-impact", "" ) {
+            const char* argv[] = { "test", "--impact-map", "tests.impact", "--record-impact" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.impactMapFilename == "tests.impact" );
+            REQUIRE( config.recordImpact == true );
+        }
+        SECTION( "--impacted-by changed.txt", "" ) {
+            const char* argv[] = { "test", "--impacted-by", "changed.txt" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.impactedByFilename == "changed.txt" );
+            REQUIRE_THROWS_WITH( (void)Catch::Config( config ), Contains( "--impact-map" ) );
+        }
+        SECTION( "--record-impact cannot be used with workers", "" ) {
+            const char* argv[] = { "test", "--impact-map", "tests.impact", "--record-impact", "--workers", "2" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE_THROWS_WITH( (void)Catch::Config( config ), Contains( "workers" ) );
+        }
+    }
+
+    SECTION( "shards", "" ) {
+        SECTION( "--shard-count 3 --shard-index 2", "" ) {
+            const char* argv[] = { "test", "--shard-count", "3", "--shard-index", "2" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.shardCount == 3 );
+            REQUIRE( config.shardIndex == 2 );
+        }
+        SECTION( "--shard-index must be less than the shard count", "" ) {
+            const char* argv[] = { "test", "--shard-count", "3", "--shard-index", "3" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE_THROWS_WITH( (void)Catch::Config( config ), Contains( "--shard-index" ) );
+        }
+        SECTION( "--shard-balance needs a history", "" ) {
+            const char* argv[] = { "test", "--shard-count", "3", "--shard-balance" };
+            CHECK_NOTHROW( parseIntoConfig( argv, config ) );
+
+            REQUIRE( config.balanceShards == true );
+            REQUIRE_THROWS_WITH( (void)Catch::Config( config ), Contains( "--history" ) );
+        }
+        SECTION( "Each test is in exactly one shard", "" ) {
+            const char* names[] = { "test1", "test2", "Some other test", "" };
+            for( std::size_t i = 0; i < sizeof(names)/sizeof(names[0]); ++i ) {
+                int shardsMatched = 0;
+                for( int shard = 0; shard < 3; ++shard ) {
+                    Catch::ConfigData data;
+                    data.shardCount = 3;
+                    data.shardIndex = shard;
+                    Catch::Config cfg( data );
+                    if( Catch::isInShard( fakeTestCase( names[i] ), cfg ) )
+                        ++shardsMatched;
+                }
+                CHECK( shardsMatched == 1 );
+            }
+        }
+    }
+
     SECTION( "nothrow", "" ) {
         SECTION( "-e", "" ) {
             const char* argv[] = { "test", "-e" };
@@ -234,6 +609,91 @@ TEST_CASE( "Process can be configured on command line", "[config][command-line]"
     }
 }
 
+int runSession( Catch::ConfigData const& configData, std::string& output ) {
+    Catch::Session session;
+    session.useConfigData( configData );
+    Catch::StreamRedirect redirect( Catch::cout(), output );
+    return session.run();
+}
+
+int runSession( int argc, char const* const* argv ) {
+    return Catch::Session().run( argc, argv );
+}
+
+void writeFile( std::string const& filename, std::string const& content ) {
+    std::ofstream f( filename.c_str() );
+    f << content;
+}
+
+TemporaryDirectory::TemporaryDirectory() {
+#ifdef CATCH_PLATFORM_WINDOWS
+    char const* tempDir = std::getenv( "TEMP" );
+    std::string path = std::string( tempDir ? tempDir : "." ) + "\\CatchSelfTest.XXXXXX";
+    if( _mktemp_s( &path[0], path.size() + 1 ) != 0 || _mkdir( path.c_str() ) != 0 )
+        throw std::runtime_error( "Unable to create a temporary directory" );
+#else
+    char const* tempDir = std::getenv( "TMPDIR" );
+    std::string path = std::string( tempDir && *tempDir ? tempDir : "/tmp" ) + "/CatchSelfTest.XXXXXX";
+    if( !mkdtemp( &path[0] ) )
+        throw std::runtime_error( "Unable to create a temporary directory" );
+#endif
+    m_path = path;
+}
+
+TemporaryDirectory::~TemporaryDirectory() {
+    for( std::vector<std::string>::const_iterator it = m_files.begin(), itEnd = m_files.end(); it != itEnd; ++it )
+        std::remove( it->c_str() );
+#ifdef CATCH_PLATFORM_WINDOWS
+    _rmdir( m_path.c_str() );
+#else
+    rmdir( m_path.c_str() );
+#endif
+}
+
+std::string TemporaryDirectory::file( std::string const& name ) {
+    m_files.push_back( m_path + "/" + name );
+    return m_files.back();
+}
+
+#ifdef CATCH_INTERNAL_COVERAGE_HOOKS
+// Here, as the hooks are only defined along with the implementation
+TEST_CASE( "Only the coverage guards touched are reset", "[impact]" ) {
+
+    using namespace Catch;
+    static uint32_t guards[3];
+    __sanitizer_cov_trace_pc_guard_init( guards, guards + 3 );
+    REQUIRE( guards[0] != 0 );
+    uint32_t const firstId = guards[0];
+
+    Detail::coverageGuards.start();
+    __sanitizer_cov_trace_pc_guard( &guards[2] );
+    __sanitizer_cov_trace_pc_guard( &guards[0] );
+    __sanitizer_cov_trace_pc_guard( &guards[2] );
+    CHECK( guards[0] == 0 );
+    CHECK( guards[1] == firstId + 1 );
+    REQUIRE( Detail::coverageGuards.stop() == 2 );
+
+    CHECK( Detail::coverageGuards.touchedIds[0] == firstId + 2 );
+    CHECK( Detail::coverageGuards.touchedIds[1] == firstId );
+    CHECK( guards[0] == firstId );
+    CHECK( guards[2] == firstId + 2 );
+
+    // A thread still in the hook as recording stops - seeing it as on -
+    // gives its guard back rather than leaving it zeroed
+    Detail::coverageGuards.recording = true;
+    __sanitizer_cov_trace_pc_guard( &guards[1] );
+    Detail::coverageGuards.recording = false;
+    CHECK( guards[1] == firstId + 1 );
+
+    Detail::coverageGuards.start();
+    __sanitizer_cov_trace_pc_guard( &guards[1] );
+    CHECK( guards[1] == 0 );
+    REQUIRE( Detail::coverageGuards.stop() == 1 );
+    CHECK( Detail::coverageGuards.touchedIds[0] == firstId + 1 );
+    CHECK( guards[1] == firstId + 1 );
+}
+#endif
+
 
 TEST_CASE( "Long strings can be wrapped", "[wrap]" ) {
 
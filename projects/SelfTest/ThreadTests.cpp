@@ -0,0 +1,171 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch.hpp"
+#include "internal/catch_config.hpp"
+#include "SelfTestHelpers.h"
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+    std::atomic<int> parallelProbesRunning( 0 );
+    std::atomic<int> parallelProbesPeak( 0 );
+
+    // Counts the probes running at the same time, on any thread
+    struct ParallelProbeRun {
+        ParallelProbeRun() {
+            int running = ++parallelProbesRunning;
+            int peak = parallelProbesPeak;
+            while( running > peak && !parallelProbesPeak.compare_exchange_weak( peak, running ) ) {}
+            std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+        }
+        ~ParallelProbeRun() {
+            --parallelProbesRunning;
+        }
+    };
+}
+
+TEST_CASE( "Parallel probe: 1", "[.][threads][parallel]" ) {
+    ParallelProbeRun run;
+    SECTION( "first", "" ) {
+        INFO( "on whichever thread" );
+        CHECK( Catch::getResultCapture().getCurrentTestName() == "Parallel probe: 1" );
+    }
+    SECTION( "second", "" ) {
+        CHECK( Catch::random() != 0 );
+    }
+}
+TEST_CASE( "Parallel probe: serial", "[.][threads]" ) {
+    CHECK( parallelProbesRunning == 0 );
+}
+TEST_CASE( "Parallel probe: 2", "[.][threads][parallel]" ) {
+    ParallelProbeRun run;
+    CHECK( Catch::getResultCapture().getCurrentTestName() == "Parallel probe: 2" );
+}
+TEST_CASE( "Parallel probe: 3", "[.][threads][parallel]" ) {
+    ParallelProbeRun run;
+    WARN( "reported in its place" );
+}
+
+TEST_CASE( "Tests tagged [parallel] run on threads, reported as a serial run would", "[threads]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][threads]" );
+    configData.showSuccessfulTests = true;
+
+    std::string serialOutput;
+    parallelProbesPeak = 0;
+    CHECK( runSession( configData, serialOutput ) == 0 );
+    CHECK( parallelProbesPeak == 1 );
+
+    configData.threads = 2;
+    std::string threadedOutput;
+    parallelProbesPeak = 0;
+    CHECK( runSession( configData, threadedOutput ) == 0 );
+    CHECK( parallelProbesPeak == 2 );
+    CHECK( threadedOutput == serialOutput );
+}
+
+TEST_CASE( "Budget thread probe: slower than its history", "[.][thread-budget]" ) {
+    std::this_thread::sleep_for( std::chrono::milliseconds( 300 ) );
+}
+TEST_CASE( "Budget thread probe: serial", "[.][thread-budget]" ) {
+    CHECK( false );
+}
+TEST_CASE( "Budget thread probe: parallel", "[.][thread-budget][parallel]" ) {
+    CHECK( true );
+}
+
+TEST_CASE( "A serial test deferred by the time budget does not hold up the [parallel] ones", "[threads][budget]" ) {
+
+    using namespace Catch;
+    std::string const filename = "CatchSelfTest.threads.history";
+    writeFile( filename,
+               "Budget thread probe: slower than its history\tdurations=0.01\tresults=p\n"
+               "Budget thread probe: serial\tdurations=0.05\tresults=p\n"
+               "Budget thread probe: parallel\tdurations=0.09\tresults=p\n" );
+
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][thread-budget]" );
+    configData.historyFilename = filename;
+    configData.timeBudget = 0.3;
+    configData.threads = 2;
+
+    std::string output;
+    CHECK( runSession( configData, output ) == 0 );
+    CHECK_THAT( output, Contains( "ran 2 of 3 test cases, deferred:\n  Budget thread probe: serial" ) );
+
+    std::remove( filename.c_str() );
+}
+
+TEST_CASE( "Thread probe", "[.][thread-assertions]" ) {
+    std::thread thread( []{
+        CHECK( Catch::getResultCapture().getCurrentTestName() == "Thread probe" );
+        CHECK( 1 + 1 == 3 );
+    } );
+    thread.join();
+}
+
+TEST_CASE( "Assertions made on a thread a test case started count in that test case", "[threads]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][thread-assertions]" );
+
+    SECTION( "run in this process", "" ) {
+    }
+    SECTION( "run in a worker", "" ) {
+        configData.workers = 1;
+    }
+
+    std::string output;
+    CHECK( runSession( configData, output ) == 1 );
+    CHECK_THAT( output, Contains( "1 + 1 == 3" ) );
+    CHECK_THAT( output, Contains( "assertions: 2 | 1 passed | 1 failed" ) );
+}
+
+namespace {
+    // As the application's Debugs() counts an error that a test case expects
+    void logExpectedError() {
+        using Catch::ExpectsDebugsError;
+        if( ExpectsDebugsError::capturingMask & ( 1 << (int)DebugSeverity::error ) )
+            ExpectsDebugsError::counters[(int)DebugSeverity::error]++;
+    }
+}
+
+TEST_CASE( "Expected errors probe", "[.][expected-errors][parallel]" ) {
+    Catch::ExpectsDebugsError expected( DebugSeverity::error, 2, 2 );
+    logExpectedError();
+    logExpectedError();
+}
+
+TEST_CASE( "Errors and throws expected by a test case are seen on the threads it starts", "[threads]" ) {
+
+    using namespace Catch;
+    {
+        ExpectsDebugsError expected( DebugSeverity::error, 1, 1 );
+        std::thread thread( logExpectedError );
+        thread.join();
+        CHECK( ExpectsDebugsError::counters[(int)DebugSeverity::error] == 1 );
+
+        SECTION( "but not on the threads running [parallel] test cases", "" ) {
+            ConfigData configData;
+            configData.testsOrTags.push_back( "[.][expected-errors]" );
+            configData.threads = 2;
+            std::string output;
+            CHECK( runSession( configData, output ) == 0 );
+            CHECK( ExpectsDebugsError::counters[(int)DebugSeverity::error] == 1 );
+        }
+    }
+
+    ExpectingThrows expecting;
+    int seen = 0;
+    std::thread thread( [&seen]{ seen = ExpectingThrows::counter; } );
+    thread.join();
+    CHECK( seen == 1 );
+}
@@ -0,0 +1,107 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch.hpp"
+#include "internal/catch_config.hpp"
+#include "internal/catch_test_watchdog.hpp"
+#include "SelfTestHelpers.h"
+
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <cstdio>
+
+#ifndef CATCH_PLATFORM_WINDOWS
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#endif
+
+namespace {
+    // Hangs, while another thread keeps on reporting, until the watchdog
+    // ends the process
+    void hang() {
+        std::thread( []{
+            for(;;) {
+                CHECK( true );
+                std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+            }
+        } ).detach();
+        std::this_thread::sleep_for( std::chrono::seconds( 30 ) );
+    }
+}
+
+TEST_CASE( "Timeout probe: tagged", "[.][timeout-tagged][timeout:200]" ) {
+    SECTION( "hanging", "" ) {
+        hang();
+    }
+}
+TEST_CASE( "Timeout probe: configured", "[.][timeout-configured]" ) {
+    hang();
+}
+
+// The watchdog ends the process it runs in, so these are run in a worker,
+// which reports the timeout as the test case's failure
+TEST_CASE( "A test case run in a worker that overruns its timeout is failed", "[timeout]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.workers = 1;
+    std::string output;
+
+    SECTION( "timeout from a tag", "" ) {
+        configData.testsOrTags.push_back( "[.][timeout-tagged]" );
+        configData.testTimeout = 60000;
+        CHECK( runSession( configData, output ) == 1 );
+        CHECK_THAT( output, Contains( "did not complete within its 200 ms timeout" ) );
+    }
+    SECTION( "timeout from the config", "" ) {
+        configData.testsOrTags.push_back( "[.][timeout-configured]" );
+        configData.testTimeout = 300;
+        CHECK( runSession( configData, output ) == 1 );
+        CHECK_THAT( output, Contains( "did not complete within its 300 ms timeout" ) );
+    }
+    CHECK_THAT( output, Contains( "test cases: 1 | 1 failed" ) );
+    CHECK_THAT( output, !Contains( "signal" ) );
+}
+
+#ifndef CATCH_PLATFORM_WINDOWS
+
+// Run in a child process of its own, the one the watchdog ends
+TEST_CASE( "A test case run in this process that overruns its timeout ends the run with exit code 124", "[timeout]" ) {
+
+    using namespace Catch;
+    std::string const filename = "CatchSelfTest.timeout.out";
+    std::cout.flush();
+    std::fflush( CATCH_NULL );
+    pid_t child = fork();
+    REQUIRE( child >= 0 );
+    if( child == 0 ) {
+        int outFd = open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+        dup2( outFd, 1 );
+        dup2( outFd, 2 );
+        char const* argv[] = { "SelfTest", "[.][timeout-configured]", "--test-timeout", "300" };
+        runSession( sizeof(argv)/sizeof(argv[0]), argv );
+        _exit( 0 ); // Only if the watchdog did not end the run
+    }
+
+    int status = 0;
+    REQUIRE( waitpid( child, &status, 0 ) == child );
+    std::ifstream file( filename.c_str() );
+    std::string output( ( std::istreambuf_iterator<char>( file ) ), std::istreambuf_iterator<char>() );
+    std::remove( filename.c_str() );
+
+    REQUIRE( WIFEXITED( status ) );
+    CHECK( WEXITSTATUS( status ) == TestWatchdog::TimeoutExitCode );
+    CHECK_THAT( output, Contains( "did not complete within its 300 ms timeout" ) );
+#ifdef CATCH_INTERNAL_THREAD_BACKTRACES
+    CHECK_THAT( output, Contains( "Backtraces of all threads:" ) );
+    CHECK_THAT( output, Contains( ", main):" ) );
+    CHECK_THAT( output, Contains( "#0 " ) );
+#endif
+}
+
+#endif // not Windows
@@ -0,0 +1,288 @@
+/*
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "catch.hpp"
+#include "internal/catch_config.hpp"
+#include "internal/catch_cpu_pinning.hpp"
+#include "internal/catch_run_history.hpp"
+#include "SelfTestHelpers.h"
+
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <signal.h>
+
+namespace {
+    int workerProbeRuns = 0; // In this process
+}
+
+TEST_CASE( "Worker probe: sections", "[.][workers]" ) {
+    ++workerProbeRuns;
+    SECTION( "first", "" ) {
+        INFO( "in whichever process" );
+        CHECK( workerProbeRuns > 0 );
+    }
+    SECTION( "second", "" ) {
+        WARN( "reported in its place" );
+    }
+}
+// The sections it leaves end outermost first
+TEST_CASE( "Worker probe: nested REQUIRE", "[.][workers]" ) {
+    ++workerProbeRuns;
+    SECTION( "outer", "" ) {
+        SECTION( "inner", "" ) {
+            REQUIRE( 1 + 1 == 3 );
+        }
+    }
+}
+TEST_CASE( "Worker probe: killed", "[.][workers-killed]" ) {
+    raise( SIGKILL );
+}
+TEST_CASE( "Worker probe: failing", "[.][workers]" ) {
+    ++workerProbeRuns;
+    CHECK( 1 + 1 == 3 );
+}
+
+TEST_CASE( "Test cases can be run in worker processes", "[workers]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][workers]" );
+    configData.showSuccessfulTests = true;
+
+    SECTION( "reported as a serial run would", "" ) {
+        std::string serialOutput;
+        workerProbeRuns = 0;
+        CHECK( runSession( configData, serialOutput ) == 2 );
+        CHECK( workerProbeRuns == 5 );
+
+        configData.workers = 2;
+        std::string workersOutput;
+        workerProbeRuns = 0;
+        CHECK( runSession( configData, workersOutput ) == 2 );
+        CHECK( workerProbeRuns == 0 ); // None of them was run in this process
+        CHECK( workersOutput == serialOutput );
+    }
+    SECTION( "failing only the test case of a worker that dies", "" ) {
+        configData.testsOrTags[0] = "[.][workers],[.][workers-killed]";
+        configData.workers = 1;
+        std::string output;
+        CHECK( runSession( configData, output ) == 3 );
+        CHECK_THAT( output, Contains( "was terminated by signal 9" ) );
+        CHECK_THAT( output, Contains( "test cases: 4 | 1 passed | 3 failed" ) );
+    }
+}
+
+TEST_CASE( "Isolation probe: exits", "[.][isolation]" ) {
+    std::_Exit( 3 );
+}
+TEST_CASE( "Isolation probe: passes", "[.][isolation]" ) {
+    CHECK( true );
+}
+
+TEST_CASE( "An isolated test case that ends its process is failed, and the run goes on", "[isolation]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][isolation]" );
+
+    SECTION( "one test case per process", "" ) {
+        configData.isolateBatch = 1;
+    }
+    SECTION( "in batches, the rest of the batch in a new process", "" ) {
+        configData.isolateBatch = 10;
+    }
+
+    std::string output;
+    CHECK( runSession( configData, output ) == 1 );
+    CHECK_THAT( output, Contains( "exited with code 3 before the test case ended" ) );
+    CHECK_THAT( output, Contains( "test cases: 2 | 1 passed | 1 failed" ) );
+}
+
+namespace {
+    typedef std::pair<long long, long long> Interval; // Steady clock microseconds, the same in every process
+
+    // Where the probes record when they ran, from whichever worker process
+    std::string probeIntervalsFile;
+
+    long long microsecondsNow() {
+        return std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+
+    // Records when a probe started and ended, in one line appended as it ends. It
+    // lasts long enough for others to start meanwhile, were they allowed to
+    struct ProbeInterval {
+        explicit ProbeInterval( std::string const& _name ) : name( _name ), start( microsecondsNow() ) {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+        }
+        ~ProbeInterval() {
+            std::ostringstream oss;
+            oss << name << '\t' << start << '\t' << microsecondsNow() << '\n';
+            if( std::FILE* f = std::fopen( probeIntervalsFile.c_str(), "a" ) ) {
+                std::fputs( oss.str().c_str(), f );
+                std::fclose( f );
+            }
+        }
+        std::string name;
+        long long start;
+    };
+
+    std::map<std::string, Interval> readProbeIntervals() {
+        std::map<std::string, Interval> intervals;
+        std::ifstream f( probeIntervalsFile.c_str() );
+        std::string name;
+        Interval interval;
+        while( std::getline( f, name, '\t' ) && f >> interval.first >> interval.second && f.ignore() )
+            intervals[name] = interval;
+        return intervals;
+    }
+
+    bool overlap( Interval const& a, Interval const& b ) {
+        return a.first < b.second && b.first < a.second;
+    }
+}
+
+TEST_CASE( "Resource probe: db 1", "[.][resources][resource:db]" ) {
+    ProbeInterval interval( "db 1" );
+}
+TEST_CASE( "Resource probe: db 2", "[.][resources][resource:DB]" ) {
+    ProbeInterval interval( "db 2" );
+}
+TEST_CASE( "Resource probe: free", "[.][resources]" ) {
+    ProbeInterval interval( "free" );
+}
+TEST_CASE( "Resource probe: exclusive", "[.][resources][exclusive]" ) {
+    ProbeInterval interval( "exclusive" );
+}
+
+TEST_CASE( "Workers honour resource locks", "[resources]" ) {
+
+    using namespace Catch;
+    TemporaryDirectory directory;
+    probeIntervalsFile = directory.file( "intervals" );
+    ConfigData configData;
+    configData.testsOrTags.push_back( "[.][resources]" );
+    configData.workers = 3;
+
+    std::string output;
+    CHECK( runSession( configData, output ) == 0 );
+    CHECK_THAT( output, Contains( "Resource locks:\n  [exclusive]: 1 test case, 1 waited" ) );
+    CHECK_THAT( output, Contains( "  db: 2 test cases, 1 waited" ) );
+
+    std::map<std::string, Interval> intervals = readProbeIntervals();
+    REQUIRE( intervals.size() == 4 );
+    CHECK( !overlap( intervals["db 1"], intervals["db 2"] ) );
+    CHECK( !overlap( intervals["exclusive"], intervals["db 1"] ) );
+    CHECK( !overlap( intervals["exclusive"], intervals["db 2"] ) );
+    CHECK( !overlap( intervals["exclusive"], intervals["free"] ) );
+}
+
+TEST_CASE( "Pinning probe", "[.][pinning]" ) {
+    CHECK( Catch::CpuPinning::current().cpu == 0 );
+}
+
+TEST_CASE( "Test processes can be pinned to CPUs", "[pinning]" ) {
+
+    using namespace Catch;
+    ConfigData configData;
+    configData.testsOrTags.push_back( "Pinning probe" );
+    configData.pin = true;
+    configData.cpus.push_back( 0 );
+    configData.reporterNames.push_back( "xml" );
+#ifdef __linux__
+    cpu_set_t before;
+    REQUIRE( sched_getaffinity( 0, sizeof( before ), &before ) == 0 );
+#endif
+
+    SECTION( "In process", "" ) {
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "cpu=\"0\"" ) );
+    }
+    SECTION( "In workers", "" ) {
+        configData.workers = 2;
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "cpu=\"0\"" ) );
+    }
+#ifdef __linux__
+    cpu_set_t after;
+    REQUIRE( sched_getaffinity( 0, sizeof( after ), &after ) == 0 );
+    CHECK( CPU_EQUAL( &before, &after ) );
+#endif
+}
+
+namespace {
+    // Enough to stand out from what the worker process takes anyway
+    void takeMemory() {
+        std::vector<char> block( std::size_t( 64 ) << 20, 1 );
+        CHECK( block.back() == 1 );
+    }
+}
+
+TEST_CASE( "Memory probe: big 1", "[.][memory]" ) {
+    ProbeInterval interval( "big 1" );
+    takeMemory();
+}
+TEST_CASE( "Memory probe: big 2", "[.][memory]" ) {
+    ProbeInterval interval( "big 2" );
+    takeMemory();
+}
+TEST_CASE( "Memory probe: small", "[.][memory]" ) {
+    ProbeInterval interval( "small" );
+}
+TEST_CASE( "Memory probe: runaway", "[.][memory-runaway]" ) {
+    std::vector<char> huge( std::size_t( 2 ) << 30 ); // More than the budget, but not more than the system would allow
+    CHECK( huge.empty() );
+}
+
+TEST_CASE( "Workers keep to a memory budget", "[memory]" ) {
+
+    using namespace Catch;
+    TemporaryDirectory directory;
+    std::string const filename = directory.file( "history" );
+    probeIntervalsFile = directory.file( "intervals" );
+    ConfigData configData;
+    configData.historyFilename = filename;
+    configData.memoryBudget = 1000;
+    configData.workers = 3;
+
+    SECTION( "Test cases only run alongside each other while they fit", "" ) {
+        writeFile( filename,
+                   "Memory probe: big 1\tpeakMemory=614400\n"
+                   "Memory probe: big 2\tpeakMemory=614400\n"
+                   "Memory probe: small\tpeakMemory=307200\n" );
+        configData.testsOrTags.push_back( "[.][memory]" );
+
+        std::string output;
+        CHECK( runSession( configData, output ) == 0 );
+        CHECK_THAT( output, Contains( "[memory]: 3 test cases, 1 waited" ) );
+        std::map<std::string, Interval> intervals = readProbeIntervals();
+        REQUIRE( intervals.size() == 3 );
+        CHECK( !overlap( intervals["big 1"], intervals["big 2"] ) );
+
+        // Measured again as they ran, well under what was expected
+        RunHistory history;
+        history.load( filename );
+        std::vector<std::string> names;
+        names.push_back( "Memory probe: big 1" );
+        names.push_back( "Memory probe: small" );
+        std::vector<std::size_t> peaks = history.estimatePeakMemory( names );
+        CHECK( peaks[0] < 614400 );
+        CHECK( peaks[1] < 307200 );
+        CHECK( peaks[0] > peaks[1] );
+    }
+    SECTION( "A test case taking more memory than the budget fails", "" ) {
+        writeFile( filename, "" );
+        configData.testsOrTags.push_back( "[.][memory-runaway]" );
+
+        std::string output;
+        CHECK( runSession( configData, output ) == 1 );
+        CHECK_THAT( output, Contains( "bad_alloc" ) );
+    }
+}